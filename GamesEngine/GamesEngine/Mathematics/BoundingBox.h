@@ -0,0 +1,65 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cfloat>
+
+/**
+ * Axis aligned bounding box, an empty box has min > max
+ */
+struct BoundingBox {
+	glm::vec3 min = glm::vec3(FLT_MAX);
+	glm::vec3 max = glm::vec3(-FLT_MAX);
+
+	BoundingBox() {}
+	BoundingBox(const glm::vec3& minPoint, const glm::vec3& maxPoint) : min(minPoint), max(maxPoint) {}
+
+	/**
+	 * Check if at least one point has been added to the box
+	 * @return bool							false if the box is empty
+	 */
+	inline bool IsValid() const {
+		return this->min.x <= this->max.x && this->min.y <= this->max.y && this->min.z <= this->max.z;
+	}
+
+	/**
+	 * Grow the box so that it contains a specific point
+	 * @param point							Point that needs to be inside the box
+	 */
+	inline void AddPoint(const glm::vec3& point) {
+		this->min = glm::min(this->min, point);
+		this->max = glm::max(this->max, point);
+	}
+
+	/**
+	 * Grow the box so that it contains another box
+	 * @param other							Box that needs to be inside the box
+	 */
+	inline void AddBox(const BoundingBox& other) {
+		if (!other.IsValid())
+			return;
+
+		this->min = glm::min(this->min, other.min);
+		this->max = glm::max(this->max, other.max);
+	}
+
+	/**
+	 * Calculate the box that contains this box after a transformation
+	 * ( the extents are projected on the absolute value of the matrix axes )
+	 * @param matrix						Model matrix applied to the box
+	 * @return BoundingBox					Transformed axis aligned box
+	 */
+	inline BoundingBox Transformed(const glm::mat4& matrix) const {
+		if (!this->IsValid())
+			return BoundingBox();
+
+		glm::vec3 center = (this->min + this->max) * 0.5f;
+		glm::vec3 extents = (this->max - this->min) * 0.5f;
+
+		glm::vec3 newCenter = glm::vec3(matrix * glm::vec4(center, 1.0f));
+		glm::vec3 newExtents =
+			glm::abs(glm::vec3(matrix[0])) * extents.x +
+			glm::abs(glm::vec3(matrix[1])) * extents.y +
+			glm::abs(glm::vec3(matrix[2])) * extents.z;
+
+		return BoundingBox(newCenter - newExtents, newCenter + newExtents);
+	}
+};
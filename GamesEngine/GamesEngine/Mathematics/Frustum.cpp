@@ -0,0 +1,101 @@
+#include "Frustum.h"
+
+Frustum::Frustum()
+{
+	for (unsigned int i = 0; i < NUMBER_PLANES_PADDED; i++) {
+		this->m_planeX[i] = 0.0f;
+		this->m_planeY[i] = 0.0f;
+		this->m_planeZ[i] = 0.0f;
+		this->m_planeW[i] = 1.0f;
+	}
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection) : Frustum()
+{
+	this->ExtractPlanes(viewProjection);
+}
+
+void Frustum::ExtractPlanes(const glm::mat4& viewProjection)
+{
+	// glm is column major so the rows have to be gathered from the columns
+	glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+	glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+	glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+	glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+	glm::vec4 planes[NUMBER_PLANES] = {
+		row3 + row0,		// Left
+		row3 - row0,		// Right
+		row3 + row1,		// Bottom
+		row3 - row1,		// Top
+		row3 + row2,		// Near
+		row3 - row2			// Far
+	};
+
+	for (unsigned int i = 0; i < NUMBER_PLANES; i++) {
+		float length = glm::length(glm::vec3(planes[i]));
+		if (length > 0.0f) {
+			planes[i] /= length;
+		}
+
+		this->m_planeX[i] = planes[i].x;
+		this->m_planeY[i] = planes[i].y;
+		this->m_planeZ[i] = planes[i].z;
+		this->m_planeW[i] = planes[i].w;
+	}
+}
+
+bool Frustum::IsBoxVisible(const BoundingBox& box) const
+{
+	if (!box.IsValid()) {
+		return false;
+	}
+
+#ifdef FRUSTUM_USE_SSE
+	const __m128 minX = _mm_set1_ps(box.min.x);
+	const __m128 minY = _mm_set1_ps(box.min.y);
+	const __m128 minZ = _mm_set1_ps(box.min.z);
+	const __m128 maxX = _mm_set1_ps(box.max.x);
+	const __m128 maxY = _mm_set1_ps(box.max.y);
+	const __m128 maxZ = _mm_set1_ps(box.max.z);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (unsigned int i = 0; i < NUMBER_PLANES_PADDED; i += 4) {
+		__m128 planeX = _mm_load_ps(&this->m_planeX[i]);
+		__m128 planeY = _mm_load_ps(&this->m_planeY[i]);
+		__m128 planeZ = _mm_load_ps(&this->m_planeZ[i]);
+		__m128 planeW = _mm_load_ps(&this->m_planeW[i]);
+
+		// Pick the corner of the box that is furthest along each plane normal
+		__m128 positiveX = _mm_cmpgt_ps(planeX, zero);
+		__m128 positiveY = _mm_cmpgt_ps(planeY, zero);
+		__m128 positiveZ = _mm_cmpgt_ps(planeZ, zero);
+		__m128 cornerX = _mm_or_ps(_mm_and_ps(positiveX, maxX), _mm_andnot_ps(positiveX, minX));
+		__m128 cornerY = _mm_or_ps(_mm_and_ps(positiveY, maxY), _mm_andnot_ps(positiveY, minY));
+		__m128 cornerZ = _mm_or_ps(_mm_and_ps(positiveZ, maxZ), _mm_andnot_ps(positiveZ, minZ));
+
+		__m128 distance = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(planeX, cornerX), _mm_mul_ps(planeY, cornerY)),
+			_mm_add_ps(_mm_mul_ps(planeZ, cornerZ), planeW));
+
+		// Even the furthest corner is behind one of the planes
+		if (_mm_movemask_ps(_mm_cmplt_ps(distance, zero)) != 0) {
+			return false;
+		}
+	}
+#else
+	for (unsigned int i = 0; i < NUMBER_PLANES; i++) {
+		glm::vec3 corner(
+			this->m_planeX[i] > 0.0f ? box.max.x : box.min.x,
+			this->m_planeY[i] > 0.0f ? box.max.y : box.min.y,
+			this->m_planeZ[i] > 0.0f ? box.max.z : box.min.z);
+
+		float distance = this->m_planeX[i] * corner.x + this->m_planeY[i] * corner.y + this->m_planeZ[i] * corner.z + this->m_planeW[i];
+		if (distance < 0.0f) {
+			return false;
+		}
+	}
+#endif
+
+	return true;
+}
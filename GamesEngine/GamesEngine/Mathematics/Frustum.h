@@ -0,0 +1,61 @@
+#pragma once
+#include "BoundingBox.h"
+#include <glm/glm.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_USE_SSE
+#include <emmintrin.h>
+#endif
+
+class Frustum {
+public:
+	enum {
+		LEFT_PLANE,
+		RIGHT_PLANE,
+		BOTTOM_PLANE,
+		TOP_PLANE,
+		NEAR_PLANE,
+		FAR_PLANE,
+
+		NUMBER_PLANES,
+		// Planes are tested four at a time so the last group is padded
+		NUMBER_PLANES_PADDED = 8
+	};
+
+private:
+	/**
+	 * Planes stored as structure of arrays ( all x, all y, all z, all w ) so
+	 * four planes can be tested against a box with a single set of instructions
+	 * The padding planes are ( 0, 0, 0, 1 ) which never reject anything
+	 */
+	alignas(16) float m_planeX[NUMBER_PLANES_PADDED];
+	alignas(16) float m_planeY[NUMBER_PLANES_PADDED];
+	alignas(16) float m_planeZ[NUMBER_PLANES_PADDED];
+	alignas(16) float m_planeW[NUMBER_PLANES_PADDED];
+
+public:
+	Frustum();
+	Frustum(const glm::mat4& viewProjection);
+	~Frustum() {}
+
+	/**
+	 * Extract the six planes from the view projection matrix ( Gribb & Hartmann )
+	 * @param viewProjection				Projection * View matrix of the camera
+	 */
+	void ExtractPlanes(const glm::mat4& viewProjection);
+
+	/**
+	 * Check if an axis aligned box is at least partially inside the frustum
+	 * @param box							World space box
+	 * @return bool							false when the box is fully outside one of the planes
+	 */
+	bool IsBoxVisible(const BoundingBox& box) const;
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline glm::vec4 GetPlane(const unsigned int& plane) const {
+		return glm::vec4(this->m_planeX[plane], this->m_planeY[plane], this->m_planeZ[plane], this->m_planeW[plane]);
+	}
+};
@@ -0,0 +1,284 @@
+#include "MeshSimplifier.h"
+#include "BoundingBox.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+MeshSimplifier::Quadric MeshSimplifier::Quadric::FromPlane(const glm::vec3& normal, const float& distance, const float& weight)
+{
+	Quadric quadric;
+	double a = normal.x, b = normal.y, c = normal.z, d = distance, w = weight;
+
+	quadric.a2 = w * a * a; quadric.ab = w * a * b; quadric.ac = w * a * c; quadric.ad = w * a * d;
+	quadric.b2 = w * b * b; quadric.bc = w * b * c; quadric.bd = w * b * d;
+	quadric.c2 = w * c * c; quadric.cd = w * c * d;
+	quadric.d2 = w * d * d;
+	return quadric;
+}
+
+void MeshSimplifier::Quadric::Add(const Quadric& other)
+{
+	this->a2 += other.a2; this->ab += other.ab; this->ac += other.ac; this->ad += other.ad;
+	this->b2 += other.b2; this->bc += other.bc; this->bd += other.bd;
+	this->c2 += other.c2; this->cd += other.cd;
+	this->d2 += other.d2;
+}
+
+double MeshSimplifier::Quadric::Evaluate(const glm::vec3& point) const
+{
+	double x = point.x, y = point.y, z = point.z;
+
+	double error = this->a2 * x * x + 2.0 * this->ab * x * y + 2.0 * this->ac * x * z + 2.0 * this->ad * x
+		+ this->b2 * y * y + 2.0 * this->bc * y * z + 2.0 * this->bd * y
+		+ this->c2 * z * z + 2.0 * this->cd * z
+		+ this->d2;
+
+	// Rounding can take a point lying on every plane slightly below zero
+	return error > 0.0 ? error : 0.0;
+}
+
+std::vector<unsigned int> MeshSimplifier::Simplify(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+	const unsigned int& targetIndexCount, const float& targetError)
+{
+	std::vector<unsigned int> result = indices;
+	if (indices.size() <= targetIndexCount || vertices.empty()) {
+		return result;
+	}
+
+	// Weld the vertices that share a position, the collapses work on positions
+	struct PositionHash {
+		size_t operator()(const glm::vec3& position) const {
+			uint32_t bits[3];
+			std::memcpy(bits, &position, sizeof(bits));
+			return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+		}
+	};
+	std::unordered_map<glm::vec3, unsigned int, PositionHash> positionClasses;
+	std::vector<unsigned int> vertexClass(vertices.size());
+	std::vector<unsigned int> classVertex;
+	std::vector<glm::vec3> classPositions;
+
+	BoundingBox bounds;
+	for (unsigned int v = 0; v < vertices.size(); v++) {
+		// Adding zero turns -0 into +0 so both hash the same
+		glm::vec3 position = vertices[v].pos + glm::vec3(0.0f);
+		auto inserted = positionClasses.insert({ position, (unsigned int)classPositions.size() });
+		if (inserted.second) {
+			classVertex.push_back(v);
+			classPositions.push_back(position);
+		}
+		vertexClass[v] = inserted.first->second;
+		bounds.AddPoint(position);
+	}
+	unsigned int classCount = classPositions.size();
+
+	// Errors are squared distances, the limit follows the size of the mesh
+	float meshSize = glm::length(bounds.max - bounds.min);
+	double errorLimit = (double)targetError * meshSize * (double)targetError * meshSize;
+
+	auto edgeKey = [](unsigned int a, unsigned int b) {
+		return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+	};
+
+	// Planes of the triangles around each position, weighted by their area
+	std::vector<Quadric> quadrics(classCount);
+	std::unordered_map<uint64_t, unsigned int> edgeUses;
+	for (size_t t = 0; t + 2 < result.size(); t += 3) {
+		unsigned int c[3] = { vertexClass[result[t]], vertexClass[result[t + 1]], vertexClass[result[t + 2]] };
+		if (c[0] == c[1] || c[1] == c[2] || c[0] == c[2]) {
+			continue;
+		}
+
+		glm::vec3 normal = glm::cross(classPositions[c[1]] - classPositions[c[0]], classPositions[c[2]] - classPositions[c[0]]);
+		float doubleArea = glm::length(normal);
+		if (doubleArea > 0.0f) {
+			normal /= doubleArea;
+			Quadric plane = Quadric::FromPlane(normal, -glm::dot(normal, classPositions[c[0]]), doubleArea * 0.5f);
+			for (unsigned int k = 0; k < 3; k++) {
+				quadrics[c[k]].Add(plane);
+			}
+		}
+
+		for (unsigned int k = 0; k < 3; k++) {
+			edgeUses[edgeKey(c[k], c[(k + 1) % 3])]++;
+		}
+	}
+
+	// An edge used by a single triangle is on a border, a plane along it keeps the border in place
+	for (size_t t = 0; t + 2 < result.size(); t += 3) {
+		unsigned int c[3] = { vertexClass[result[t]], vertexClass[result[t + 1]], vertexClass[result[t + 2]] };
+		if (c[0] == c[1] || c[1] == c[2] || c[0] == c[2]) {
+			continue;
+		}
+
+		glm::vec3 faceNormal = glm::cross(classPositions[c[1]] - classPositions[c[0]], classPositions[c[2]] - classPositions[c[0]]);
+		for (unsigned int k = 0; k < 3; k++) {
+			unsigned int a = c[k], b = c[(k + 1) % 3];
+			if (edgeUses[edgeKey(a, b)] != 1) {
+				continue;
+			}
+
+			glm::vec3 edge = classPositions[b] - classPositions[a];
+			glm::vec3 borderNormal = glm::cross(edge, faceNormal);
+			float length = glm::length(borderNormal);
+			if (length == 0.0f) {
+				continue;
+			}
+			borderNormal /= length;
+
+			Quadric border = Quadric::FromPlane(borderNormal, -glm::dot(borderNormal, classPositions[a]), glm::dot(edge, edge) * MeshSimplifier::BORDER_WEIGHT);
+			quadrics[a].Add(border);
+			quadrics[b].Add(border);
+		}
+	}
+
+	std::vector<unsigned int> vertexRemap(vertices.size());
+	std::vector<unsigned char> classTouched(classCount);
+	std::vector<unsigned int> triangleOffsets(classCount + 1);
+	std::vector<unsigned int> classTriangles;
+	std::vector<uint64_t> edges;
+	std::vector<Collapse> collapses;
+
+	// Every pass collapses the cheapest edges that don't share a neighbourhood
+	while (result.size() > targetIndexCount) {
+		unsigned int triangleCount = result.size() / 3;
+
+		// Triangles around every position, packed one position after the other
+		std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+		for (unsigned int i = 0; i < result.size(); i++) {
+			triangleOffsets[vertexClass[result[i]] + 1]++;
+		}
+		for (unsigned int c = 0; c < classCount; c++) {
+			triangleOffsets[c + 1] += triangleOffsets[c];
+		}
+		classTriangles.resize(result.size());
+		std::vector<unsigned int> fillOffsets(triangleOffsets.begin(), triangleOffsets.end() - 1);
+		for (unsigned int i = 0; i < result.size(); i++) {
+			classTriangles[fillOffsets[vertexClass[result[i]]]++] = i / 3;
+		}
+
+		// Each edge once, collapsed in the direction with the lowest error
+		edges.clear();
+		for (unsigned int t = 0; t < triangleCount; t++) {
+			for (unsigned int k = 0; k < 3; k++) {
+				edges.push_back(edgeKey(vertexClass[result[t * 3 + k]], vertexClass[result[t * 3 + (k + 1) % 3]]));
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+		collapses.clear();
+		for (uint64_t key : edges) {
+			unsigned int a = (unsigned int)(key >> 32), b = (unsigned int)(key & 0xFFFFFFFF);
+			double costAB = quadrics[a].Evaluate(classPositions[b]) + quadrics[b].Evaluate(classPositions[b]);
+			double costBA = quadrics[a].Evaluate(classPositions[a]) + quadrics[b].Evaluate(classPositions[a]);
+			collapses.push_back(costAB <= costBA ? Collapse{ a, b, costAB } : Collapse{ b, a, costBA });
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+		for (unsigned int v = 0; v < vertexRemap.size(); v++) {
+			vertexRemap[v] = v;
+		}
+		std::fill(classTouched.begin(), classTouched.end(), 0);
+
+		unsigned int trianglesToRemove = (result.size() - targetIndexCount) / 3;
+		unsigned int trianglesRemoved = 0;
+		unsigned int collapsed = 0;
+
+		for (const Collapse& collapse : collapses) {
+			if (collapse.cost > errorLimit || trianglesRemoved >= trianglesToRemove) {
+				break;
+			}
+			if (classTouched[collapse.from] || classTouched[collapse.to]) {
+				continue;
+			}
+
+			const unsigned int* fromTriangles = &classTriangles[triangleOffsets[collapse.from]];
+			unsigned int fromTriangleCount = triangleOffsets[collapse.from + 1] - triangleOffsets[collapse.from];
+			if (MeshSimplifier::FlipsTriangle(fromTriangles, fromTriangleCount, result, vertexClass, classPositions, collapse.from, collapse.to)) {
+				continue;
+			}
+
+			// A corner moves onto the vertex it shares an edge with so it keeps its attributes on that side of a seam
+			for (unsigned int i = 0; i < fromTriangleCount; i++) {
+				const unsigned int* triangle = &result[fromTriangles[i] * 3];
+				for (unsigned int k = 0; k < 3; k++) {
+					for (unsigned int j = 0; j < 3; j++) {
+						if (vertexClass[triangle[k]] == collapse.from && vertexClass[triangle[j]] == collapse.to) {
+							vertexRemap[triangle[k]] = triangle[j];
+						}
+					}
+				}
+			}
+
+			// Corners without such an edge take the first vertex of the position
+			for (unsigned int i = 0; i < fromTriangleCount; i++) {
+				const unsigned int* triangle = &result[fromTriangles[i] * 3];
+				bool removedTriangle = false;
+				for (unsigned int k = 0; k < 3; k++) {
+					if (vertexClass[triangle[k]] == collapse.from && vertexRemap[triangle[k]] == triangle[k]) {
+						vertexRemap[triangle[k]] = classVertex[collapse.to];
+					}
+					removedTriangle = removedTriangle || vertexClass[triangle[k]] == collapse.to;
+					classTouched[vertexClass[triangle[k]]] = 1;
+				}
+				trianglesRemoved += removedTriangle ? 1 : 0;
+			}
+
+			quadrics[collapse.to].Add(quadrics[collapse.from]);
+			classTouched[collapse.from] = 1;
+			classTouched[collapse.to] = 1;
+			collapsed++;
+		}
+
+		if (collapsed == 0) {
+			break;
+		}
+
+		// Move the corners and drop the triangles that lost an edge
+		size_t write = 0;
+		for (size_t t = 0; t < result.size(); t += 3) {
+			unsigned int a = vertexRemap[result[t]], b = vertexRemap[result[t + 1]], c = vertexRemap[result[t + 2]];
+			if (vertexClass[a] == vertexClass[b] || vertexClass[b] == vertexClass[c] || vertexClass[a] == vertexClass[c]) {
+				continue;
+			}
+			result[write++] = a;
+			result[write++] = b;
+			result[write++] = c;
+		}
+		result.resize(write);
+	}
+
+	return result;
+}
+
+bool MeshSimplifier::FlipsTriangle(const unsigned int* triangles, const unsigned int& triangleCount, const std::vector<unsigned int>& result,
+	const std::vector<unsigned int>& vertexClass, const std::vector<glm::vec3>& classPositions, const unsigned int& from, const unsigned int& to)
+{
+	for (unsigned int i = 0; i < triangleCount; i++) {
+		const unsigned int* triangle = &result[triangles[i] * 3];
+		unsigned int c[3] = { vertexClass[triangle[0]], vertexClass[triangle[1]], vertexClass[triangle[2]] };
+
+		// The triangles along the collapsed edge disappear
+		if (c[0] == to || c[1] == to || c[2] == to) {
+			continue;
+		}
+
+		glm::vec3 before[3], after[3];
+		for (unsigned int k = 0; k < 3; k++) {
+			before[k] = classPositions[c[k]];
+			after[k] = c[k] == from ? classPositions[to] : before[k];
+		}
+
+		glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+		glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+		// Reject a normal that turns by more than ~75 degrees, it also catches slivers
+		if (glm::dot(normalBefore, normalAfter) <= 0.25f * glm::length(normalBefore) * glm::length(normalAfter)) {
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "Vertex.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+ * Quadric error edge collapse ( Garland & Heckbert ) producing a reduced index list that
+ * reads the same vertices as the original, so every level of detail of a mesh can live
+ * in the same vertex range of the geometry buffer
+ * Vertices split on a texture or normal seam share a position and are collapsed together,
+ * open borders get an extra quadric so the outline of the mesh doesn't shrink
+ */
+class MeshSimplifier {
+private:
+	/**
+	 * Symmetric 4x4 matrix of the summed squared distances to a set of planes
+	 */
+	struct Quadric {
+		double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+		double b2 = 0.0, bc = 0.0, bd = 0.0;
+		double c2 = 0.0, cd = 0.0;
+		double d2 = 0.0;
+
+		/**
+		 * Quadric of a single plane ax + by + cz + d = 0
+		 * @param normal						Unit normal of the plane ( a, b, c )
+		 * @param distance						d term of the plane
+		 * @param weight						Scale of the error ( area of the triangle )
+		 */
+		static Quadric FromPlane(const glm::vec3& normal, const float& distance, const float& weight);
+
+		void Add(const Quadric& other);
+
+		/**
+		 * Squared distance of a point to the planes of the quadric
+		 * @param point							Point that is checked
+		 * @return double						Weighted error of the point
+		 */
+		double Evaluate(const glm::vec3& point) const;
+	};
+
+	/**
+	 * Candidate collapse of the vertices of one position onto a neighbouring position
+	 */
+	struct Collapse {
+		unsigned int from;
+		unsigned int to;
+		double cost;
+	};
+
+	// Weight of the planes that keep the open borders in place
+	static constexpr float BORDER_WEIGHT = 10.0f;
+
+public:
+	/**
+	 * Reduce a triangle list until it reaches the target size or any further collapse
+	 * would move the surface by more than the target error
+	 * @param vertices							Vertices the indices point into
+	 * @param indices							Triangle list that is reduced
+	 * @param targetIndexCount					Number of indices the result should get down to
+	 * @param targetError						Largest error allowed, relative to the size of the mesh
+	 * @return vector<unsigned int>				Reduced triangle list using the same vertices
+	 */
+	static std::vector<unsigned int> Simplify(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+		const unsigned int& targetIndexCount, const float& targetError);
+
+private:
+	/**
+	 * Check if moving a position onto another would turn one of its triangles over
+	 * @param triangles							Triangles around the position that moves
+	 * @param triangleCount						Number of triangles around the position
+	 * @param result							Current triangle list
+	 * @param vertexClass						Position of every vertex
+	 * @param classPositions					Location of every position
+	 * @param from								Position that moves
+	 * @param to								Position it moves onto
+	 * @return bool								true if the collapse has to be rejected
+	 */
+	static bool FlipsTriangle(const unsigned int* triangles, const unsigned int& triangleCount, const std::vector<unsigned int>& result,
+		const std::vector<unsigned int>& vertexClass, const std::vector<glm::vec3>& classPositions, const unsigned int& from, const unsigned int& to);
+};
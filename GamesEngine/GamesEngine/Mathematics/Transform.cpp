@@ -3,6 +3,7 @@
 Transform::Transform()
 {
 	this->m_pos = glm::vec3();
+	this->m_orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
 	this->m_rot = glm::vec3();
 	this->m_scale = glm::vec3(1.0, 1.0, 1.0);
 }
@@ -10,32 +11,98 @@ Transform::Transform()
 Transform::Transform(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
 {
 	this->m_pos = position;
+	this->m_orientation = glm::quat(rotation);
 	this->m_rot = rotation;
 	this->m_scale = scale;
 }
 
-Transform::~Transform() {}
+Transform::Transform(const glm::vec3& position, const glm::quat& orientation, const glm::vec3& scale)
+{
+	this->m_pos = position;
+	this->m_orientation = orientation;
+	this->m_rot = glm::eulerAngles(orientation);
+	this->m_scale = scale;
+}
 
-glm::mat4 Transform::ModelMatrix(const bool& checkRotation) const
+Transform::Transform(const Transform& other)
 {
-	// Solve the position matrix
-	glm::mat4 posMatrix = glm::translate(this->m_pos);
+	// The copy is a free standing transform, the slot stays with the original
+	this->m_pos = other.m_pos;
+	this->m_orientation = other.m_orientation;
+	this->m_rot = other.m_rot;
+	this->m_scale = other.m_scale;
+}
 
-	// Solve the rotation matrix
-	glm::mat4 rotXMatrix = glm::rotate(this->m_rot.x, glm::vec3(1, 0, 0));
-	glm::mat4 rotYMatrix = glm::rotate(this->m_rot.y, glm::vec3(0, 1, 0));
-	glm::mat4 rotZMatrix = glm::rotate(this->m_rot.z, glm::vec3(0, 0, 1));
-	glm::mat4 rotMatrix = rotZMatrix * rotYMatrix * rotXMatrix;
+Transform::~Transform()
+{
+	this->DetachFromPool();
+}
 
-	// Solve the scale matrix 
-	glm::mat4 scaleMatrix = glm::scale(this->m_scale);
+Transform& Transform::operator=(const Transform& other)
+{
+	if (this != &other) {
+		this->m_pos = other.m_pos;
+		this->m_orientation = other.m_orientation;
+		this->m_rot = other.m_rot;
+		this->m_scale = other.m_scale;
 
-	if (checkRotation)
-	{
-		return rotMatrix * posMatrix * scaleMatrix;
+		if (this->GetIsPooled()) {
+			TransformPool::s_transformPool->SetPosition(this->m_poolHandle.index, this->m_pos);
+			TransformPool::s_transformPool->SetOrientation(this->m_poolHandle.index, this->m_orientation);
+			TransformPool::s_transformPool->SetScale(this->m_poolHandle.index, this->m_scale);
+		}
+		this->MarkChanged();
+	}
+	return *this;
+}
+
+void Transform::AttachToPool()
+{
+	if (this->GetIsPooled()) {
+		return;
+	}
+	this->m_poolHandle = TransformPool::s_transformPool->Allocate(this->m_pos, this->m_orientation, this->m_scale);
+}
+
+void Transform::DetachFromPool()
+{
+	if (!this->GetIsPooled()) {
+		return;
 	}
-	else
+	TransformPool::s_transformPool->Free(this->m_poolHandle);
+	this->m_matricesDirty = true;
+}
+
+glm::mat4 Transform::ModelMatrix(const bool& checkRotation) const
+{
+	if (!checkRotation)
 	{
-		return posMatrix * rotMatrix * scaleMatrix;
+		return this->GetModelMatrix();
 	}
-}
\ No newline at end of file
+
+	// Rotation around the origin, the translation is rotated as well
+	return glm::mat4_cast(this->m_orientation) * glm::translate(this->m_pos) * glm::scale(this->m_scale);
+}
+
+void Transform::UpdateMatrices() const
+{
+	// Same rotation as rotZ * rotY * rotX of the euler angles
+	glm::mat3 rotMatrix = glm::mat3_cast(this->m_orientation);
+
+	this->m_modelMatrix = glm::mat4(
+		glm::vec4(rotMatrix[0] * this->m_scale.x, 0.0f),
+		glm::vec4(rotMatrix[1] * this->m_scale.y, 0.0f),
+		glm::vec4(rotMatrix[2] * this->m_scale.z, 0.0f),
+		glm::vec4(this->m_pos, 1.0f)
+	);
+
+	// ( R * S )^-T = R * S^-1 as the rotation is orthonormal
+	glm::vec3 inverseScale = glm::vec3(
+		this->m_scale.x != 0.0f ? 1.0f / this->m_scale.x : 0.0f,
+		this->m_scale.y != 0.0f ? 1.0f / this->m_scale.y : 0.0f,
+		this->m_scale.z != 0.0f ? 1.0f / this->m_scale.z : 0.0f
+	);
+	this->m_normalMatrix = glm::mat3(rotMatrix[0] * inverseScale.x, rotMatrix[1] * inverseScale.y, rotMatrix[2] * inverseScale.z);
+
+	this->m_matricesDirty = false;
+}
@@ -2,20 +2,57 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
 #include <glm/gtc/constants.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "TransformPool.h"
 #include <reactphysics3d/reactphysics3d.h>
 
 class Transform
 {
 private:
 	glm::vec3 m_pos;
-	glm::vec3 m_rot;
+	glm::quat m_orientation;
 	glm::vec3 m_scale;
 
+	// Euler angles ( radians ) shown and edited by the level builder and the editor camera,
+	// kept next to the orientation so editing doesn't go through a quaternion round trip
+	glm::vec3 m_rot;
+
+	// Incremented on every change so cached data can tell if it's out of date
+	unsigned int m_version = 0;
+
+	// Matrices rebuilt on the first request after a change ( own axis rotation ), there is no
+	// parenting between transforms so the local matrix is also the world matrix
+	mutable glm::mat4 m_modelMatrix;
+	mutable glm::mat3 m_normalMatrix;
+	mutable bool m_matricesDirty = true;
+
+	// Slot of the transform pool the values are written through to, the matrices of an
+	// attached transform come from the pool instead of the members above
+	TransformHandle m_poolHandle;
+
 public:
 	Transform();
 	Transform(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+	Transform(const glm::vec3& position, const glm::quat& orientation, const glm::vec3& scale);
+	Transform(const Transform& other);
 	~Transform();
 
+	/**
+	 * Copy the values of another transform, the pool slot of this transform is kept
+	 */
+	Transform& operator=(const Transform& other);
+
+	/**
+	 * Place the transform in a slot of the transform pool so its matrices are rebuilt by
+	 * the batch update ( game objects ), does nothing if it's already attached
+	 */
+	void AttachToPool();
+
+	/**
+	 * Release the pool slot, the matrices are cached on the transform again
+	 */
+	void DetachFromPool();
+
 	/**
 	 * Get model view matrix of the rotation
 	 * @param checkRotation			rotation axis ( false => own axis, true => origin )
@@ -23,43 +60,33 @@ public:
 	 */
 	glm::mat4 ModelMatrix(const bool& checkRotation) const;
 
+private:
+	/**
+	 * Rebuild the cached model and normal matrices from the position, orientation and scale
+	 * The normal matrix is the rotation divided by the scale so no inverse is needed
+	 */
+	void UpdateMatrices() const;
+
+	inline void MarkChanged() {
+		this->m_version++;
+		this->m_matricesDirty = true;
+	}
+
+public:
+
 	/**
 	 * Permits the conversion between different game engine systems
 	 * @param reactTransform			transform entity of physics system
 	 * @return transform				transform entity of graphics system
 	 */
 	static Transform ConvertPhysicsTransformToGraphics(const rp3d::Transform& reactTransform) {
-		rp3d::Vector3 reactPos = reactTransform.getPosition();
-		rp3d::Quaternion reactRot = reactTransform.getOrientation();
-
-		glm::vec3 eulerRot;
-
-		double offsetValue = reactRot.x * reactRot.y + reactRot.z * reactRot.w;
-		if (offsetValue > 0.499f) { // Singularity at north pole
-			eulerRot = glm::vec3(
-				0,
-				2 * atan2(reactRot.x, reactRot.w),
-				glm::half_pi<float>()
-			);
-		}
-		else if (offsetValue < -0.499f) { // Singularity at south pole
-			eulerRot = -glm::vec3(
-				0,
-				2 * atan2(reactRot.x, reactRot.w),
-				glm::half_pi<float>()
-			);
-		}
-		else {
-			eulerRot = glm::vec3(
-				atan2(2 * reactRot.x * reactRot.w - 2 * reactRot.y * reactRot.z, 1 - 2 * reactRot.x * reactRot.x - 2 * reactRot.z * reactRot.z),
-				atan2(2 * reactRot.y * reactRot.w - 2 * reactRot.x * reactRot.z, 1 - 2 * reactRot.y * reactRot.y - 2 * reactRot.z * reactRot.z),
-				asin(2 * offsetValue)
-			);
-		}
+		const rp3d::Vector3& reactPos = reactTransform.getPosition();
+		const rp3d::Quaternion& reactRot = reactTransform.getOrientation();
 
+		// Both systems store the orientation as a quaternion so it's passed straight through
 		return Transform(
 			glm::vec3(reactPos.x, reactPos.y, reactPos.z),
-			eulerRot,
+			glm::quat(reactRot.w, reactRot.x, reactRot.y, reactRot.z),
 			glm::vec3(1.0f, 1.0f, 1.0f)
 		);
 	}
@@ -70,12 +97,12 @@ public:
 	 * @return reactTransform			transform entity of physics system
 	 */
 	static rp3d::Transform ConvertGraphicsTransformToPhysics(const Transform& transform) {
-		glm::vec3 pos = transform.GetPos();
-		glm::vec3 rot = transform.GetRot();
+		const glm::vec3& pos = transform.GetPos();
+		const glm::quat& rot = transform.GetOrientation();
 		
 		return rp3d::Transform(
 			rp3d::Vector3(pos.x, pos.y, pos.z),
-			rp3d::Quaternion(rp3d::Quaternion::fromEulerAngles(glm::degrees(rot.x), glm::degrees(rot.y), glm::degrees(rot.z)))
+			rp3d::Quaternion(rot.x, rot.y, rot.z, rot.w)
 		);
 	}
 
@@ -85,11 +112,81 @@ public:
 public:
 	inline const glm::vec3& GetPos() const { return this->m_pos; }
 	inline const glm::vec3& GetRot() const { return this->m_rot; }
+	inline const glm::quat& GetOrientation() const { return this->m_orientation; }
 	inline const glm::vec3& GetScale() const { return this->m_scale; }
+	inline const unsigned int& GetVersion() const { return this->m_version; }
+	inline const TransformHandle& GetPoolHandle() const { return this->m_poolHandle; }
+	inline bool GetIsPooled() const { return this->m_poolHandle.index != TransformPool::INVALID_INDEX; }
+
+	/**
+	 * Model matrix rotating around the own axis, cached until the transform changes
+	 */
+	inline const glm::mat4& GetModelMatrix() const {
+		if (this->GetIsPooled()) {
+			return TransformPool::s_transformPool->GetModelMatrix(this->m_poolHandle.index);
+		}
+		if (this->m_matricesDirty) {
+			this->UpdateMatrices();
+		}
+		return this->m_modelMatrix;
+	}
+
+	/**
+	 * Inverse transpose of the upper 3x3 of the model matrix, cached until the transform changes
+	 */
+	inline const glm::mat3& GetNormalMatrix() const {
+		if (this->GetIsPooled()) {
+			return TransformPool::s_transformPool->GetNormalMatrix(this->m_poolHandle.index);
+		}
+		if (this->m_matricesDirty) {
+			this->UpdateMatrices();
+		}
+		return this->m_normalMatrix;
+	}
 
-	inline void SetPos(const glm::vec3& newPos) { this->m_pos = newPos; }
-	inline void SetRot(const glm::vec3& newRot) { this->m_rot = newRot; }
-	inline void SetScale(const glm::vec3& newScale) { this->m_scale = newScale; }
+	// Setting the same value again keeps the cached matrices and everything built from the version
+	inline void SetPos(const glm::vec3& newPos) { 
+		if (this->m_pos == newPos) {
+			return;
+		}
+		this->m_pos = newPos; 
+		if (this->GetIsPooled()) {
+			TransformPool::s_transformPool->SetPosition(this->m_poolHandle.index, newPos);
+		}
+		this->MarkChanged();
+	}
+	inline void SetRot(const glm::vec3& newRot) { 
+		if (this->m_rot == newRot) {
+			return;
+		}
+		this->m_rot = newRot; 
+		this->m_orientation = glm::quat(newRot);
+		if (this->GetIsPooled()) {
+			TransformPool::s_transformPool->SetOrientation(this->m_poolHandle.index, this->m_orientation);
+		}
+		this->MarkChanged();
+	}
+	inline void SetOrientation(const glm::quat& newOrientation) {
+		if (this->m_orientation == newOrientation) {
+			return;
+		}
+		this->m_orientation = newOrientation;
+		this->m_rot = glm::eulerAngles(newOrientation);
+		if (this->GetIsPooled()) {
+			TransformPool::s_transformPool->SetOrientation(this->m_poolHandle.index, newOrientation);
+		}
+		this->MarkChanged();
+	}
+	inline void SetScale(const glm::vec3& newScale) { 
+		if (this->m_scale == newScale) {
+			return;
+		}
+		this->m_scale = newScale; 
+		if (this->GetIsPooled()) {
+			TransformPool::s_transformPool->SetScale(this->m_poolHandle.index, newScale);
+		}
+		this->MarkChanged();
+	}
 
 	inline glm::vec3 GetForwardDirection() const {
 		return glm::normalize(glm::vec3(
@@ -0,0 +1,259 @@
+#include "TransformPool.h"
+#include <cstdint>
+#include <cstring>
+
+#if TRANSFORM_POOL_SSE
+#include <xmmintrin.h>
+#endif
+
+TransformPool* TransformPool::s_transformPool = new TransformPool();
+
+TransformHandle TransformPool::Allocate(const glm::vec3& position, const glm::quat& orientation, const glm::vec3& scale)
+{
+	if (this->m_freeSlots.empty()) {
+		this->Grow();
+	}
+
+	unsigned int index = this->m_freeSlots.back();
+	this->m_freeSlots.pop_back();
+
+	this->m_posX[index] = position.x;
+	this->m_posY[index] = position.y;
+	this->m_posZ[index] = position.z;
+	this->m_rotX[index] = orientation.x;
+	this->m_rotY[index] = orientation.y;
+	this->m_rotZ[index] = orientation.z;
+	this->m_rotW[index] = orientation.w;
+	this->m_scaleX[index] = scale.x;
+	this->m_scaleY[index] = scale.y;
+	this->m_scaleZ[index] = scale.z;
+	this->MarkDirty(index);
+
+	TransformHandle handle;
+	handle.index = index;
+	handle.generation = this->m_generations[index];
+	return handle;
+}
+
+void TransformPool::Free(TransformHandle& handle)
+{
+	if (!this->IsValid(handle)) {
+		return;
+	}
+
+	unsigned int index = handle.index;
+
+	// Released slots go back to identity so the blocks they are part of stay valid
+	this->m_posX[index] = this->m_posY[index] = this->m_posZ[index] = 0.0f;
+	this->m_rotX[index] = this->m_rotY[index] = this->m_rotZ[index] = 0.0f;
+	this->m_rotW[index] = 1.0f;
+	this->m_scaleX[index] = this->m_scaleY[index] = this->m_scaleZ[index] = 1.0f;
+
+	if (this->m_dirty[index] != 0) {
+		this->m_dirty[index] = 0;
+		this->m_dirtyCount--;
+	}
+	this->m_modelMatrices[index] = glm::mat4(1.0f);
+	this->m_normalMatrices[index] = glm::mat3(1.0f);
+
+	this->m_generations[index]++;
+	this->m_freeSlots.push_back(index);
+
+	handle = TransformHandle();
+}
+
+void TransformPool::SetPosition(const unsigned int& index, const glm::vec3& position)
+{
+	this->m_posX[index] = position.x;
+	this->m_posY[index] = position.y;
+	this->m_posZ[index] = position.z;
+	this->MarkDirty(index);
+}
+
+void TransformPool::SetOrientation(const unsigned int& index, const glm::quat& orientation)
+{
+	this->m_rotX[index] = orientation.x;
+	this->m_rotY[index] = orientation.y;
+	this->m_rotZ[index] = orientation.z;
+	this->m_rotW[index] = orientation.w;
+	this->MarkDirty(index);
+}
+
+void TransformPool::SetScale(const unsigned int& index, const glm::vec3& scale)
+{
+	this->m_scaleX[index] = scale.x;
+	this->m_scaleY[index] = scale.y;
+	this->m_scaleZ[index] = scale.z;
+	this->MarkDirty(index);
+}
+
+void TransformPool::UpdateDirtyMatrices()
+{
+	this->m_updatedMatrices = 0;
+	if (this->m_dirtyCount == 0) {
+		return;
+	}
+
+	unsigned int slotCount = this->m_generations.size();
+	for (unsigned int first = 0; first < slotCount && this->m_dirtyCount > 0; first += TransformPool::LANE_WIDTH) {
+#if TRANSFORM_POOL_SSE
+		// The four dirty flags of the block are read as one word
+		uint32_t blockDirty;
+		std::memcpy(&blockDirty, &this->m_dirty[first], sizeof(uint32_t));
+		if (blockDirty != 0) {
+			this->ComputeMatricesBlock(first);
+		}
+#else
+		for (unsigned int i = first; i < first + TransformPool::LANE_WIDTH; i++) {
+			if (this->m_dirty[i] != 0) {
+				this->ComputeMatrices(i);
+			}
+		}
+#endif
+	}
+}
+
+const glm::mat4& TransformPool::GetModelMatrix(const unsigned int& index)
+{
+	if (this->m_dirty[index] != 0) {
+		this->ComputeMatrices(index);
+	}
+	return this->m_modelMatrices[index];
+}
+
+const glm::mat3& TransformPool::GetNormalMatrix(const unsigned int& index)
+{
+	if (this->m_dirty[index] != 0) {
+		this->ComputeMatrices(index);
+	}
+	return this->m_normalMatrices[index];
+}
+
+void TransformPool::Grow()
+{
+	unsigned int first = this->m_generations.size();
+	unsigned int newSize = first + TransformPool::LANE_WIDTH;
+
+	this->m_posX.resize(newSize, 0.0f);
+	this->m_posY.resize(newSize, 0.0f);
+	this->m_posZ.resize(newSize, 0.0f);
+	this->m_rotX.resize(newSize, 0.0f);
+	this->m_rotY.resize(newSize, 0.0f);
+	this->m_rotZ.resize(newSize, 0.0f);
+	this->m_rotW.resize(newSize, 1.0f);
+	this->m_scaleX.resize(newSize, 1.0f);
+	this->m_scaleY.resize(newSize, 1.0f);
+	this->m_scaleZ.resize(newSize, 1.0f);
+
+	this->m_dirty.resize(newSize, 0);
+	this->m_generations.resize(newSize, 0);
+	this->m_modelMatrices.resize(newSize, glm::mat4(1.0f));
+	this->m_normalMatrices.resize(newSize, glm::mat3(1.0f));
+
+	// Reversed so the lowest slot is handed out first
+	for (unsigned int i = newSize; i > first; i--) {
+		this->m_freeSlots.push_back(i - 1);
+	}
+}
+
+void TransformPool::ComputeMatrices(const unsigned int& index)
+{
+	float x = this->m_rotX[index], y = this->m_rotY[index], z = this->m_rotZ[index], w = this->m_rotW[index];
+
+	// Rotation of a unit quaternion, same as glm::mat3_cast
+	glm::vec3 axisX = glm::vec3(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y));
+	glm::vec3 axisY = glm::vec3(2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x));
+	glm::vec3 axisZ = glm::vec3(2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y));
+
+	glm::vec3 scale = glm::vec3(this->m_scaleX[index], this->m_scaleY[index], this->m_scaleZ[index]);
+	glm::vec3 inverseScale = glm::vec3(
+		scale.x != 0.0f ? 1.0f / scale.x : 0.0f,
+		scale.y != 0.0f ? 1.0f / scale.y : 0.0f,
+		scale.z != 0.0f ? 1.0f / scale.z : 0.0f
+	);
+
+	this->m_modelMatrices[index] = glm::mat4(
+		glm::vec4(axisX * scale.x, 0.0f),
+		glm::vec4(axisY * scale.y, 0.0f),
+		glm::vec4(axisZ * scale.z, 0.0f),
+		glm::vec4(this->m_posX[index], this->m_posY[index], this->m_posZ[index], 1.0f)
+	);
+	this->m_normalMatrices[index] = glm::mat3(axisX * inverseScale.x, axisY * inverseScale.y, axisZ * inverseScale.z);
+
+	this->m_dirty[index] = 0;
+	this->m_dirtyCount--;
+	this->m_updatedMatrices++;
+}
+
+void TransformPool::ComputeMatricesBlock(const unsigned int& first)
+{
+#if TRANSFORM_POOL_SSE
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 zero = _mm_setzero_ps();
+
+	// One lane per slot, every component comes from a contiguous load
+	__m128 x = _mm_loadu_ps(&this->m_rotX[first]);
+	__m128 y = _mm_loadu_ps(&this->m_rotY[first]);
+	__m128 z = _mm_loadu_ps(&this->m_rotZ[first]);
+	__m128 w = _mm_loadu_ps(&this->m_rotW[first]);
+
+	__m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+	__m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+	__m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+	// Columns of the rotation, same terms as the scalar path
+	__m128 rotation[3][3] = {
+		{ _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), _mm_mul_ps(two, _mm_add_ps(xy, wz)), _mm_mul_ps(two, _mm_sub_ps(xz, wy)) },
+		{ _mm_mul_ps(two, _mm_sub_ps(xy, wz)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), _mm_mul_ps(two, _mm_add_ps(yz, wx)) },
+		{ _mm_mul_ps(two, _mm_add_ps(xz, wy)), _mm_mul_ps(two, _mm_sub_ps(yz, wx)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))) }
+	};
+
+	__m128 scale[3] = {
+		_mm_loadu_ps(&this->m_scaleX[first]),
+		_mm_loadu_ps(&this->m_scaleY[first]),
+		_mm_loadu_ps(&this->m_scaleZ[first])
+	};
+
+	// A zero scale gives a zero column instead of an infinity
+	__m128 inverseScale[3];
+	for (unsigned int axis = 0; axis < 3; axis++) {
+		__m128 nonZero = _mm_cmpneq_ps(scale[axis], zero);
+		inverseScale[axis] = _mm_and_ps(_mm_div_ps(one, scale[axis]), nonZero);
+	}
+
+	float model[3][3][TransformPool::LANE_WIDTH];
+	float normal[3][3][TransformPool::LANE_WIDTH];
+	for (unsigned int column = 0; column < 3; column++) {
+		for (unsigned int row = 0; row < 3; row++) {
+			_mm_storeu_ps(model[column][row], _mm_mul_ps(rotation[column][row], scale[column]));
+			_mm_storeu_ps(normal[column][row], _mm_mul_ps(rotation[column][row], inverseScale[column]));
+		}
+	}
+
+	// Scatter the lanes to the matrices, clean slots get the same values they already had
+	for (unsigned int lane = 0; lane < TransformPool::LANE_WIDTH; lane++) {
+		unsigned int index = first + lane;
+
+		glm::mat4& modelMatrix = this->m_modelMatrices[index];
+		glm::mat3& normalMatrix = this->m_normalMatrices[index];
+		for (unsigned int column = 0; column < 3; column++) {
+			modelMatrix[column] = glm::vec4(model[column][0][lane], model[column][1][lane], model[column][2][lane], 0.0f);
+			normalMatrix[column] = glm::vec3(normal[column][0][lane], normal[column][1][lane], normal[column][2][lane]);
+		}
+		modelMatrix[3] = glm::vec4(this->m_posX[index], this->m_posY[index], this->m_posZ[index], 1.0f);
+
+		if (this->m_dirty[index] != 0) {
+			this->m_dirty[index] = 0;
+			this->m_dirtyCount--;
+			this->m_updatedMatrices++;
+		}
+	}
+#else
+	for (unsigned int i = first; i < first + TransformPool::LANE_WIDTH; i++) {
+		if (this->m_dirty[i] != 0) {
+			this->ComputeMatrices(i);
+		}
+	}
+#endif
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+// The SSE path is used whenever the compiler targets it ( always the case on x64 )
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRANSFORM_POOL_SSE 1
+#else
+#define TRANSFORM_POOL_SSE 0
+#endif
+
+/**
+ * Reference to a slot of the transform pool, the generation tells apart a slot
+ * that was released and handed to another transform
+ */
+struct TransformHandle {
+	unsigned int index = 0xFFFFFFFF;
+	unsigned int generation = 0;
+};
+
+/**
+ * Structure of arrays storage of the transforms of the game objects, every component lives in
+ * its own array so the dirty matrices can be rebuilt LANE_WIDTH slots at a time with SIMD
+ * The slots are walked linearly and blocks without a dirty slot are skipped, so the update
+ * only touches memory that has to change
+ */
+class TransformPool {
+public:
+	static const unsigned int INVALID_INDEX = 0xFFFFFFFF;
+
+	// Slots processed together by the batch update, the arrays are padded to a multiple of it
+	static const unsigned int LANE_WIDTH = 4;
+
+private:
+	// Position, orientation ( quaternion ) and scale of every slot
+	std::vector<float> m_posX, m_posY, m_posZ;
+	std::vector<float> m_rotX, m_rotY, m_rotZ, m_rotW;
+	std::vector<float> m_scaleX, m_scaleY, m_scaleZ;
+
+	// 1 if the matrices of the slot are out of date
+	std::vector<unsigned char> m_dirty;
+	std::vector<unsigned int> m_generations;
+
+	// Output of the update, read by the renderer through the transforms
+	std::vector<glm::mat4> m_modelMatrices;
+	std::vector<glm::mat3> m_normalMatrices;
+
+	std::vector<unsigned int> m_freeSlots;
+
+	// Number of slots that are dirty and matrices rebuilt by the last batch update
+	unsigned int m_dirtyCount = 0;
+	unsigned int m_updatedMatrices = 0;
+
+public:
+	/**
+	 * Pool shared by every game object of the engine
+	 */
+	static TransformPool* s_transformPool;
+
+	TransformPool() {}
+	~TransformPool() {}
+
+	/**
+	 * Reserve a slot and fill it with the values of a transform
+	 * @param position							Position of the transform
+	 * @param orientation						Orientation of the transform
+	 * @param scale								Scale of the transform
+	 * @return TransformHandle					Handle of the slot
+	 */
+	TransformHandle Allocate(const glm::vec3& position, const glm::quat& orientation, const glm::vec3& scale);
+
+	/**
+	 * Give back a slot, the handle is invalid afterwards
+	 * @param handle							Handle returned by Allocate
+	 */
+	void Free(TransformHandle& handle);
+
+	/**
+	 * Write a component of a slot and mark its matrices as dirty
+	 * @param index								Index of the slot
+	 */
+	void SetPosition(const unsigned int& index, const glm::vec3& position);
+	void SetOrientation(const unsigned int& index, const glm::quat& orientation);
+	void SetScale(const unsigned int& index, const glm::vec3& scale);
+
+	/**
+	 * Rebuild the matrices of every dirty slot, called once per frame before drawing
+	 */
+	void UpdateDirtyMatrices();
+
+	/**
+	 * Matrices of a slot, a slot changed since the last batch update is rebuilt on its own
+	 * @param index								Index of the slot
+	 */
+	const glm::mat4& GetModelMatrix(const unsigned int& index);
+	const glm::mat3& GetNormalMatrix(const unsigned int& index);
+
+	/**
+	 * Check that a handle still refers to the slot it was given
+	 * @param handle							Handle that is checked
+	 * @return bool								true if the slot wasn't released since
+	 */
+	inline bool IsValid(const TransformHandle& handle) const {
+		return handle.index < this->m_generations.size() && this->m_generations[handle.index] == handle.generation;
+	}
+
+private:
+	/**
+	 * Flag a slot so the next update rebuilds its matrices
+	 * @param index								Index of the slot
+	 */
+	inline void MarkDirty(const unsigned int& index) {
+		if (this->m_dirty[index] == 0) {
+			this->m_dirty[index] = 1;
+			this->m_dirtyCount++;
+		}
+	}
+
+	/**
+	 * Append LANE_WIDTH identity slots to every array
+	 */
+	void Grow();
+
+	/**
+	 * Rebuild the matrices of a single slot
+	 * @param index								Index of the slot
+	 */
+	void ComputeMatrices(const unsigned int& index);
+
+	/**
+	 * Rebuild the matrices of LANE_WIDTH consecutive slots at the same time
+	 * @param first								Index of the first slot, multiple of LANE_WIDTH
+	 */
+	void ComputeMatricesBlock(const unsigned int& first);
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline unsigned int GetSlotCount() const { return this->m_generations.size() - this->m_freeSlots.size(); }
+	inline const unsigned int& GetUpdatedMatrices() const { return this->m_updatedMatrices; }
+};
@@ -1,6 +1,28 @@
 #pragma once
 #include <glm/glm.hpp>
 
+/**
+ * Attributes that can be stored inside the interleaved vertex buffer of a mesh
+ * ( the value of each attribute is the bit it takes in a vertex layout mask )
+ */
+enum VertexAttribute {
+	VERTEX_POSITION = 1 << 0,
+	VERTEX_TEXTURE = 1 << 1,
+	VERTEX_NORMAL = 1 << 2,
+	VERTEX_COLOUR = 1 << 3,
+	VERTEX_TANGENT = 1 << 4,
+	VERTEX_BITANGENT = 1 << 5
+};
+
+/**
+ * Commonly used vertex layouts, any other combination of the attributes above is valid
+ */
+enum VertexLayout {
+	LAYOUT_POSITION = VERTEX_POSITION,
+	LAYOUT_NO_TANGENT = VERTEX_POSITION | VERTEX_TEXTURE | VERTEX_NORMAL | VERTEX_COLOUR,
+	LAYOUT_FULL = VERTEX_POSITION | VERTEX_TEXTURE | VERTEX_NORMAL | VERTEX_COLOUR | VERTEX_TANGENT | VERTEX_BITANGENT
+};
+
 class Vertex
 {
 public:
@@ -22,3 +44,5 @@ public:
 	~Vertex();
 };
 
+// The full layout is uploaded straight from the vertex array, so it must stay tightly packed
+static_assert(sizeof(Vertex) == 17 * sizeof(float), "Vertex must not contain any padding");
@@ -1,77 +1,595 @@
-#pragma warning(disable:4996)
-#include "OBJLoader.h"
-
-bool ObjLoader::loadOBJ(const char* path, std::vector<glm::vec3>& inputVertices,
-	std::vector<glm::vec2>& inputUvs, std::vector<glm::vec3>& inputNormals/*, std::vector<unsigned int>& inputIndicesVertices*/)
-{
-	std::vector< unsigned int > vertexIndices, uvIndices, normalIndices;
-	std::vector< glm::vec3 > temp_vertices;
-	std::vector< glm::vec2 > temp_uvs;
-	std::vector< glm::vec3 > temp_normals;
-
-	FILE* file = fopen(path, "r");
-	if (file == NULL) {
+#include "ObjLoader.h"
+#include "../Utils/MappedFile.h"
+#include "../Utils/AsyncLoader.h"
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <future>
+#include <thread>
+#include <atomic>
+
+namespace {
+	// Powers of ten that are exact as a double
+	const double s_powersOfTen[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	inline bool IsBlank(const char& character) {
+		return character == ' ' || character == '\t' || character == '\r';
+	}
+
+	inline const char* SkipBlanks(const char* current, const char* end) {
+		while (current < end && IsBlank(*current)) {
+			current++;
+		}
+		return current;
+	}
+}
+
+bool ObjLoader::LoadOBJ(const std::string& filePath, std::vector<ObjMesh>& meshes, std::string& materialLibrary) {
+	MappedFile file;
+	if (!file.Open(filePath)) {
 		return false;
 	}
-	else {
-		while (1) {
 
-			char string[128];
-			int res = fscanf(file, "%s", string);
-			if (res == EOF)
-				break;
+	const char* data = (const char*)file.GetData();
+	const size_t size = file.GetSize();
+
+	// Split the file in one chunk per core, every chunk ends on a line break
+	// The loader workers already keep every core busy, a file read by one of them is parsed on that worker
+	size_t threadCount = AsyncLoader::IsWorkerThread() ? 1 : std::max(1u, std::thread::hardware_concurrency());
+	size_t chunkCount = std::max<size_t>(1, std::min(threadCount, size / ObjLoader::MIN_CHUNK_SIZE));
+
+	std::vector<const char*> chunkBounds = { data };
+	for (size_t i = 1; i < chunkCount; i++) {
+		const char* split = std::max(data + size * i / chunkCount, chunkBounds.back());
+		const char* lineEnd = (const char*)std::memchr(split, '\n', data + size - split);
+		chunkBounds.push_back(lineEnd != nullptr ? lineEnd + 1 : data + size);
+	}
+	chunkBounds.push_back(data + size);
+
+	std::vector<ParsedChunk> chunks(chunkCount);
+	std::vector<std::future<void>> parseTasks;
+	for (size_t i = 1; i < chunkCount; i++) {
+		parseTasks.push_back(std::async(std::launch::async, [&chunkBounds, &chunks, i]() {
+			ObjLoader::ParseChunk(chunkBounds[i], chunkBounds[i + 1], chunks[i]);
+		}));
+	}
+	ObjLoader::ParseChunk(chunkBounds[0], chunkBounds[1], chunks[0]);
+	for (std::future<void>& task : parseTasks) {
+		task.get();
+	}
+
+	// Attributes of the whole file and the amount declared before every chunk
+	ParsedChunk attributes;
+	std::vector<AttributeCounts> offsets(chunkCount);
+	for (size_t i = 0; i < chunkCount; i++) {
+		if (!chunks[i].valid) {
+			return false;
+		}
+
+		offsets[i] = AttributeCounts{ (unsigned int)attributes.positions.size(),
+			(unsigned int)attributes.textureCoords.size(), (unsigned int)attributes.normals.size() };
+
+		attributes.positions.insert(attributes.positions.end(), chunks[i].positions.begin(), chunks[i].positions.end());
+		attributes.textureCoords.insert(attributes.textureCoords.end(), chunks[i].textureCoords.begin(), chunks[i].textureCoords.end());
+		attributes.normals.insert(attributes.normals.end(), chunks[i].normals.begin(), chunks[i].normals.end());
+
+		if (materialLibrary.empty()) {
+			materialLibrary = chunks[i].materialLibrary;
+		}
+	}
+
+	// Every object, group or material change starts a new mesh once the current one has triangles
+	std::vector<std::vector<TriangleRange>> meshRanges;
+	std::vector<std::string> meshMaterials;
+	std::string currentMaterial;
+	bool meshOpen = false;
+
+	for (unsigned int c = 0; c < chunkCount; c++) {
+		unsigned int triangleCount = chunks[c].corners.size() / 3;
+		unsigned int firstTriangle = 0;
+
+		for (unsigned int e = 0; e <= chunks[c].events.size(); e++) {
+			unsigned int lastTriangle = e < chunks[c].events.size() ? chunks[c].events[e].triangle : triangleCount;
+
+			if (lastTriangle > firstTriangle) {
+				if (!meshOpen) {
+					meshRanges.push_back(std::vector<TriangleRange>());
+					meshMaterials.push_back(currentMaterial);
+					meshOpen = true;
+				}
+				meshRanges.back().push_back(TriangleRange{ c, firstTriangle, lastTriangle });
+			}
+			firstTriangle = lastTriangle;
+
+			if (e < chunks[c].events.size()) {
+				meshOpen = false;
+				if (chunks[c].events[e].hasMaterial) {
+					currentMaterial = chunks[c].events[e].materialName;
+				}
+			}
+		}
+	}
+
+	// The meshes don't share any output so they're indexed at the same time, one thread
+	// per core takes the next mesh that wasn't built yet
+	meshes.resize(meshRanges.size());
+	std::atomic<size_t> nextMesh(0);
+	auto buildMeshes = [&chunks, &offsets, &attributes, &meshRanges, &meshes, &nextMesh]() {
+		bool built = true;
+		for (size_t i = nextMesh++; i < meshRanges.size(); i = nextMesh++) {
+			built = ObjLoader::BuildMesh(chunks, offsets, attributes, meshRanges[i], meshes[i]) && built;
+		}
+		return built;
+	};
+
+	std::vector<std::future<bool>> buildTasks;
+	for (size_t i = 1; i < std::min(threadCount, meshRanges.size()); i++) {
+		buildTasks.push_back(std::async(std::launch::async, buildMeshes));
+	}
+
+	bool built = buildMeshes();
+	for (std::future<bool>& task : buildTasks) {
+		built = task.get() && built;
+	}
+
+	for (size_t i = 0; i < meshes.size(); i++) {
+		meshes[i].materialName = meshMaterials[i];
+	}
+
+	return built && !meshes.empty();
+}
 
-			if (strcmp(string, "v") == 0) {
-				glm::vec3 vertex;
-				fscanf(file, "%f %f %f\n", &vertex.x, &vertex.y, &vertex.z);
-				temp_vertices.push_back(vertex);
+bool ObjLoader::LoadMTL(const std::string& filePath, std::map<std::string, ObjMaterial>& materials) {
+	MappedFile file;
+	if (!file.Open(filePath)) {
+		return false;
+	}
+
+	const char* current = (const char*)file.GetData();
+	const char* end = current + file.GetSize();
+	ObjMaterial* material = nullptr;
+
+	while (current < end) {
+		const char* lineEnd = (const char*)std::memchr(current, '\n', end - current);
+		if (lineEnd == nullptr) {
+			lineEnd = end;
+		}
+
+		const char* line = SkipBlanks(current, lineEnd);
+		const char* value = nullptr;
+
+		if ((value = ObjLoader::MatchKeyword(line, lineEnd, "newmtl")) != nullptr) {
+			material = &materials[ObjLoader::ParseName(value, lineEnd)];
+		}
+		else if (material != nullptr) {
+			if ((value = ObjLoader::MatchKeyword(line, lineEnd, "map_Kd")) != nullptr) {
+				material->diffuseMap = ObjLoader::ParseName(value, lineEnd);
+			}
+			else if ((value = ObjLoader::MatchKeyword(line, lineEnd, "map_Ks")) != nullptr) {
+				material->specularMap = ObjLoader::ParseName(value, lineEnd);
 			}
-			else if (strcmp(string, "vt") == 0) {
-				glm::vec2 uv;
-				fscanf(file, "%f %f\n", &uv.x, &uv.y);
-				temp_uvs.push_back(uv);
+			else if ((value = ObjLoader::MatchKeyword(line, lineEnd, "map_bump")) != nullptr
+				|| (value = ObjLoader::MatchKeyword(line, lineEnd, "bump")) != nullptr) {
+				material->bumpMap = ObjLoader::ParseName(value, lineEnd);
+			}
+		}
+
+		current = lineEnd + 1;
+	}
+
+	return true;
+}
+
+void ObjLoader::ParseChunk(const char* begin, const char* end, ParsedChunk& chunk) {
+	// Rough guess of the amount of data from the size of the chunk, most lines are 20 to 40 characters
+	size_t expectedLines = (end - begin) / 32;
+	chunk.positions.reserve(expectedLines / 2);
+	chunk.corners.reserve(expectedLines * 3 / 2);
+
+	const char* current = begin;
+	while (current < end && chunk.valid) {
+		const char* lineEnd = (const char*)std::memchr(current, '\n', end - current);
+		if (lineEnd == nullptr) {
+			lineEnd = end;
+		}
+
+		const char* line = SkipBlanks(current, lineEnd);
+		current = lineEnd + 1;
+
+		if (line + 1 >= lineEnd) {
+			continue;
+		}
+
+		switch (line[0]) {
+		case 'v':
+			if (IsBlank(line[1])) {
+				glm::vec3 position;
+				const char* next = ObjLoader::ParseFloat(line + 1, lineEnd, position.x);
+				next = next != nullptr ? ObjLoader::ParseFloat(next, lineEnd, position.y) : nullptr;
+				next = next != nullptr ? ObjLoader::ParseFloat(next, lineEnd, position.z) : nullptr;
+				chunk.valid = next != nullptr;
+				chunk.positions.push_back(position);
 			}
-			else if (strcmp(string, "vn") == 0) {
+			else if (line[1] == 't' && line + 2 < lineEnd && IsBlank(line[2])) {
+				// The second coordinate is optional
+				glm::vec2 textureCoord(0.0f, 0.0f);
+				const char* next = ObjLoader::ParseFloat(line + 2, lineEnd, textureCoord.x);
+				if (next != nullptr) {
+					ObjLoader::ParseFloat(next, lineEnd, textureCoord.y);
+				}
+				chunk.valid = next != nullptr;
+				chunk.textureCoords.push_back(textureCoord);
+			}
+			else if (line[1] == 'n' && line + 2 < lineEnd && IsBlank(line[2])) {
 				glm::vec3 normal;
-				fscanf(file, "%f %f %f\n", &normal.x, &normal.y, &normal.z);
-				temp_normals.push_back(normal);
-			}
-			else if (strcmp(string, "f") == 0) {
-				std::string vertex1, vertex2, vertex3;
-				unsigned int vertexIndex[3], uvIndex[3], normalIndex[3];
-				int matches = fscanf(file, "%d/%d/%d %d/%d/%d %d/%d/%d\n", &vertexIndex[0], &uvIndex[0], &normalIndex[0], &vertexIndex[1],
-					&uvIndex[1], &normalIndex[1], &vertexIndex[2], &uvIndex[2], &normalIndex[2]);
-				if (matches == 9) {
-					vertexIndices.push_back(vertexIndex[0]);
-					vertexIndices.push_back(vertexIndex[1]);
-					vertexIndices.push_back(vertexIndex[2]);
-					uvIndices.push_back(uvIndex[0]);
-					uvIndices.push_back(uvIndex[1]);
-					uvIndices.push_back(uvIndex[2]);
-					normalIndices.push_back(normalIndex[0]);
-					normalIndices.push_back(normalIndex[1]);
-					normalIndices.push_back(normalIndex[2]);
+				const char* next = ObjLoader::ParseFloat(line + 2, lineEnd, normal.x);
+				next = next != nullptr ? ObjLoader::ParseFloat(next, lineEnd, normal.y) : nullptr;
+				next = next != nullptr ? ObjLoader::ParseFloat(next, lineEnd, normal.z) : nullptr;
+				chunk.valid = next != nullptr;
+				chunk.normals.push_back(normal);
+			}
+			break;
+
+		case 'f':
+			if (IsBlank(line[1])) {
+				FaceCorner firstCorner;
+				FaceCorner previousCorner;
+				unsigned int cornerCount = 0;
+
+				const char* next = SkipBlanks(line + 1, lineEnd);
+				while (next < lineEnd) {
+					FaceCorner corner = { 0, 0, 0, 0 };
+					int* references[3] = { &corner.position, &corner.texture, &corner.normal };
+					const unsigned int relativeBits[3] = { ObjLoader::RELATIVE_POSITION, ObjLoader::RELATIVE_TEXTURE, ObjLoader::RELATIVE_NORMAL };
+					const size_t declared[3] = { chunk.positions.size(), chunk.textureCoords.size(), chunk.normals.size() };
+
+					// position [ / [ texture ] [ / normal ] ]
+					for (unsigned int r = 0; r < 3 && next != nullptr; r++) {
+						if (r > 0) {
+							if (next >= lineEnd || *next != '/') {
+								break;
+							}
+							next++;
+							if (next < lineEnd && *next == '/') {
+								continue;
+							}
+						}
+
+						next = ObjLoader::ParseInt(next, lineEnd, *references[r]);
+						if (next != nullptr && *references[r] < 0) {
+							*references[r] += (int)declared[r];
+							corner.relativeMask |= relativeBits[r];
+						}
+					}
+
+					if (next == nullptr || (corner.position == 0 && !(corner.relativeMask & ObjLoader::RELATIVE_POSITION))) {
+						chunk.valid = false;
+						break;
+					}
+
+					// Polygons are split into a fan around their first corner
+					if (cornerCount == 0) {
+						firstCorner = corner;
+					}
+					else if (cornerCount >= 2) {
+						chunk.corners.push_back(firstCorner);
+						chunk.corners.push_back(previousCorner);
+						chunk.corners.push_back(corner);
+					}
+					previousCorner = corner;
+					cornerCount++;
+
+					next = SkipBlanks(next, lineEnd);
 				}
 			}
+			break;
+
+		case 'o':
+		case 'g':
+			if (IsBlank(line[1])) {
+				chunk.events.push_back(GroupEvent{ (unsigned int)(chunk.corners.size() / 3), false, "" });
+			}
+			break;
+
+		case 'u': {
+			const char* value = ObjLoader::MatchKeyword(line, lineEnd, "usemtl");
+			if (value != nullptr) {
+				chunk.events.push_back(GroupEvent{ (unsigned int)(chunk.corners.size() / 3), true, ObjLoader::ParseName(value, lineEnd) });
+			}
+			break;
 		}
 
-		for (unsigned int i = 0; i < vertexIndices.size(); i++) {
-			unsigned int vertexIndex = vertexIndices[i];
-			glm::vec3 vertex = temp_vertices[vertexIndex - 1];
-			inputVertices.push_back(vertex);
+		case 'm': {
+			const char* value = ObjLoader::MatchKeyword(line, lineEnd, "mtllib");
+			if (value != nullptr && chunk.materialLibrary.empty()) {
+				chunk.materialLibrary = ObjLoader::ParseName(value, lineEnd);
+			}
+			break;
 		}
 
-		for (unsigned int i = 0; i < uvIndices.size(); i++) {
-			unsigned int uvIndex = uvIndices[i];
-			glm::vec2 uv = temp_uvs[uvIndex - 1];
-			inputUvs.push_back(uv);
+		default:
+			break;
 		}
+	}
+}
+
+bool ObjLoader::BuildMesh(const std::vector<ParsedChunk>& chunks, const std::vector<AttributeCounts>& offsets,
+	const ParsedChunk& attributes, const std::vector<TriangleRange>& ranges, ObjMesh& mesh) {
+	struct HashSlot {
+		unsigned int position;
+		unsigned int texture;
+		unsigned int normal;
+		unsigned int vertex;
+	};
+
+	size_t cornerCount = 0;
+	for (const TriangleRange& range : ranges) {
+		cornerCount += (range.lastTriangle - range.firstTriangle) * 3;
+	}
+
+	// Open addressing table kept at most half full, keyed by the resolved triple of the corner
+	// ( sized for the usual ratio of a few corners per vertex and grown when it fills up )
+	auto hashSlot = [](const unsigned int& position, const unsigned int& texture, const unsigned int& normal) {
+		return (size_t)position * 73856093u ^ (size_t)texture * 19349663u ^ (size_t)normal * 83492791u;
+	};
 
-		for (unsigned int i = 0; i < normalIndices.size(); i++) {
-			unsigned int normalIndex = normalIndices[i];
-			glm::vec3 normal = temp_normals[normalIndex - 1];
-			inputNormals.push_back(normal);
+	size_t tableSize = 16;
+	while (tableSize < cornerCount / 2) {
+		tableSize <<= 1;
+	}
+	std::vector<HashSlot> table(tableSize, HashSlot{ 0, 0, 0, ObjLoader::MISSING_INDEX });
+	size_t tableMask = tableSize - 1;
+
+	mesh.vertices.reserve(cornerCount / 2);
+	mesh.indices.reserve(cornerCount);
+
+	bool hasTextureCoords = true;
+	bool hasNormals = true;
+
+	for (const TriangleRange& range : ranges) {
+		const ParsedChunk& chunk = chunks[range.chunk];
+		const AttributeCounts& offset = offsets[range.chunk];
+
+		for (size_t c = range.firstTriangle * 3; c < range.lastTriangle * 3; c++) {
+			const FaceCorner& corner = chunk.corners[c];
+			unsigned int position = ObjLoader::ResolveIndex(corner.position, (corner.relativeMask & ObjLoader::RELATIVE_POSITION) != 0, offset.positions);
+			unsigned int texture = ObjLoader::ResolveIndex(corner.texture, (corner.relativeMask & ObjLoader::RELATIVE_TEXTURE) != 0, offset.textureCoords);
+			unsigned int normal = ObjLoader::ResolveIndex(corner.normal, (corner.relativeMask & ObjLoader::RELATIVE_NORMAL) != 0, offset.normals);
+
+			if (position >= attributes.positions.size()
+				|| (texture != ObjLoader::MISSING_INDEX && texture >= attributes.textureCoords.size())
+				|| (normal != ObjLoader::MISSING_INDEX && normal >= attributes.normals.size())) {
+				return false;
+			}
+
+			if ((mesh.vertices.size() + 1) * 2 > table.size()) {
+				std::vector<HashSlot> oldTable(table.size() * 2, HashSlot{ 0, 0, 0, ObjLoader::MISSING_INDEX });
+				oldTable.swap(table);
+				tableMask = table.size() - 1;
+
+				for (const HashSlot& oldSlot : oldTable) {
+					if (oldSlot.vertex != ObjLoader::MISSING_INDEX) {
+						size_t slot = hashSlot(oldSlot.position, oldSlot.texture, oldSlot.normal) & tableMask;
+						while (table[slot].vertex != ObjLoader::MISSING_INDEX) {
+							slot = (slot + 1) & tableMask;
+						}
+						table[slot] = oldSlot;
+					}
+				}
+			}
+
+			size_t slot = hashSlot(position, texture, normal) & tableMask;
+			while (table[slot].vertex != ObjLoader::MISSING_INDEX
+				&& (table[slot].position != position || table[slot].texture != texture || table[slot].normal != normal)) {
+				slot = (slot + 1) & tableMask;
+			}
+
+			if (table[slot].vertex == ObjLoader::MISSING_INDEX) {
+				table[slot] = HashSlot{ position, texture, normal, (unsigned int)mesh.vertices.size() };
+
+				Vertex vertex;
+				vertex.pos = attributes.positions[position];
+				vertex.colour = glm::vec3(1.0f, 1.0f, 1.0f);
+				vertex.tangent = glm::vec3(0.0f, 0.0f, 0.0f);
+				vertex.biTangent = glm::vec3(0.0f, 0.0f, 0.0f);
+
+				if (texture != ObjLoader::MISSING_INDEX) {
+					const glm::vec2& textureCoord = attributes.textureCoords[texture];
+					vertex.textureCoord = glm::vec2(textureCoord.x, 1.0f - textureCoord.y);
+				}
+				else {
+					vertex.textureCoord = glm::vec2(0.0f, 0.0f);
+					hasTextureCoords = false;
+				}
+
+				if (normal != ObjLoader::MISSING_INDEX) {
+					vertex.normals = attributes.normals[normal];
+				}
+				else {
+					vertex.normals = glm::vec3(0.0f, 0.0f, 0.0f);
+					hasNormals = false;
+				}
+
+				mesh.vertices.push_back(vertex);
+			}
+
+			mesh.indices.push_back(table[slot].vertex);
+		}
+	}
+
+	// Same as the importer, the tangent space needs both the normals and the texture coordinates
+	if (hasTextureCoords && hasNormals) {
+		ObjLoader::CalculateTangents(mesh);
+		mesh.vertexLayout = VertexLayout::LAYOUT_FULL;
+	}
+	else {
+		mesh.vertexLayout = VertexLayout::LAYOUT_NO_TANGENT;
+	}
+
+	return true;
+}
+
+void ObjLoader::CalculateTangents(ObjMesh& mesh) {
+	for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+		Vertex& v0 = mesh.vertices[mesh.indices[i]];
+		Vertex& v1 = mesh.vertices[mesh.indices[i + 1]];
+		Vertex& v2 = mesh.vertices[mesh.indices[i + 2]];
+
+		glm::vec3 edge1 = v1.pos - v0.pos;
+		glm::vec3 edge2 = v2.pos - v0.pos;
+		glm::vec2 deltaUV1 = v1.textureCoord - v0.textureCoord;
+		glm::vec2 deltaUV2 = v2.textureCoord - v0.textureCoord;
+
+		float determinant = deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y;
+		if (std::abs(determinant) < 1e-12f) {
+			continue;
 		}
+		float inverse = 1.0f / determinant;
+
+		glm::vec3 tangent = (edge1 * deltaUV2.y - edge2 * deltaUV1.y) * inverse;
+		glm::vec3 biTangent = (edge2 * deltaUV1.x - edge1 * deltaUV2.x) * inverse;
+
+		v0.tangent += tangent;
+		v1.tangent += tangent;
+		v2.tangent += tangent;
+		v0.biTangent += biTangent;
+		v1.biTangent += biTangent;
+		v2.biTangent += biTangent;
 	}
-	return false;
+
+	// Orthogonalise against the normal and keep the handedness of the texture mapping
+	for (Vertex& vertex : mesh.vertices) {
+		glm::vec3 normal = vertex.normals;
+		glm::vec3 tangent = vertex.tangent - normal * glm::dot(normal, vertex.tangent);
+
+		if (glm::dot(tangent, tangent) < 1e-12f) {
+			tangent = glm::cross(normal, std::abs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f));
+		}
+		if (glm::dot(tangent, tangent) < 1e-12f) {
+			continue;
+		}
+		tangent = glm::normalize(tangent);
+
+		glm::vec3 biTangent = glm::cross(normal, tangent);
+		if (glm::dot(biTangent, vertex.biTangent) < 0.0f) {
+			biTangent = -biTangent;
+		}
+
+		vertex.tangent = tangent;
+		vertex.biTangent = biTangent;
+	}
+}
+
+const char* ObjLoader::ParseFloat(const char* current, const char* end, float& value) {
+	current = SkipBlanks(current, end);
+
+	bool negative = false;
+	if (current < end && (*current == '-' || *current == '+')) {
+		negative = *current == '-';
+		current++;
+	}
+
+	// Up to 19 significant digits fit in the mantissa, the rest only move the exponent
+	unsigned long long mantissa = 0;
+	int exponent = 0;
+	unsigned int significantDigits = 0;
+	bool hasDigits = false;
+
+	while (current < end && *current >= '0' && *current <= '9') {
+		if (significantDigits < 19) {
+			mantissa = mantissa * 10 + (*current - '0');
+			significantDigits += mantissa != 0 ? 1 : 0;
+		}
+		else {
+			exponent++;
+		}
+		hasDigits = true;
+		current++;
+	}
+
+	if (current < end && *current == '.') {
+		current++;
+		while (current < end && *current >= '0' && *current <= '9') {
+			if (significantDigits < 19) {
+				mantissa = mantissa * 10 + (*current - '0');
+				significantDigits += mantissa != 0 ? 1 : 0;
+				exponent--;
+			}
+			hasDigits = true;
+			current++;
+		}
+	}
+
+	if (!hasDigits) {
+		return nullptr;
+	}
+
+	if (current < end && (*current == 'e' || *current == 'E')) {
+		int exponentValue = 0;
+		const char* next = ObjLoader::ParseInt(current + 1, end, exponentValue);
+		if (next != nullptr) {
+			exponent += exponentValue;
+			current = next;
+		}
+	}
+
+	double result = (double)mantissa;
+	if (exponent < 0) {
+		result = exponent >= -22 ? result / s_powersOfTen[-exponent] : result * std::pow(10.0, exponent);
+	}
+	else if (exponent > 0) {
+		result = exponent <= 22 ? result * s_powersOfTen[exponent] : result * std::pow(10.0, exponent);
+	}
+
+	value = (float)(negative ? -result : result);
+	return current;
+}
+
+const char* ObjLoader::ParseInt(const char* current, const char* end, int& value) {
+	bool negative = false;
+	if (current < end && (*current == '-' || *current == '+')) {
+		negative = *current == '-';
+		current++;
+	}
+
+	if (current >= end || *current < '0' || *current > '9') {
+		return nullptr;
+	}
+
+	int result = 0;
+	while (current < end && *current >= '0' && *current <= '9') {
+		result = result * 10 + (*current - '0');
+		current++;
+	}
+
+	value = negative ? -result : result;
+	return current;
+}
+
+const char* ObjLoader::MatchKeyword(const char* current, const char* end, const char* keyword) {
+	size_t length = std::strlen(keyword);
+	if ((size_t)(end - current) <= length || !IsBlank(current[length])) {
+		return nullptr;
+	}
+
+	for (size_t i = 0; i < length; i++) {
+		if (std::tolower((unsigned char)current[i]) != std::tolower((unsigned char)keyword[i])) {
+			return nullptr;
+		}
+	}
+
+	return current + length;
+}
+
+std::string ObjLoader::ParseName(const char* current, const char* end) {
+	current = SkipBlanks(current, end);
+	while (end > current && IsBlank(end[-1])) {
+		end--;
+	}
+
+	return std::string(current, end);
 }
\ No newline at end of file
@@ -1,11 +1,192 @@
 #pragma once
+#include "../Mathematics/Vertex.h"
 #include <vector>
 #include <string>
+#include <map>
 #include <glm/glm.hpp>
 
+/**
+ * Indexed mesh read from a Wavefront OBJ file, one per object, group or material change
+ */
+struct ObjMesh {
+	std::string materialName;
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	unsigned int vertexLayout = VertexLayout::LAYOUT_FULL;
+};
+
+/**
+ * Texture maps of a material declared inside a MTL library
+ */
+struct ObjMaterial {
+	std::string diffuseMap;
+	std::string specularMap;
+	std::string bumpMap;
+};
+
+/**
+ * Reader for the OBJ files of the engine, the whole file is mapped and split into chunks that end
+ * on a line break, the chunks are parsed on worker threads and stitched back together in order
+ * Vertices that repeat the same position / texture / normal triple are merged, polygons are
+ * turned into triangle fans and the texture coordinates are flipped like aiProcess_FlipUVs
+ */
 class ObjLoader
 {
+private:
+	/**
+	 * Position, texture and normal reference of one corner of a face, 0 if the reference is missing
+	 * A reference is the 1 based index of the file, or when its bit is set in relativeMask the 0 based
+	 * index counted from the start of the chunk ( negative indices of the file are resolved to it,
+	 * the chunk doesn't know yet how much data was declared before it )
+	 */
+	struct FaceCorner {
+		int position;
+		int texture;
+		int normal;
+		unsigned int relativeMask;
+	};
+
+	// Bits of FaceCorner::relativeMask
+	static const unsigned int RELATIVE_POSITION = 1 << 0;
+	static const unsigned int RELATIVE_TEXTURE = 1 << 1;
+	static const unsigned int RELATIVE_NORMAL = 1 << 2;
+
+	/**
+	 * Amount of each attribute declared before a chunk
+	 */
+	struct AttributeCounts {
+		unsigned int positions;
+		unsigned int textureCoords;
+		unsigned int normals;
+	};
+
+	/**
+	 * Object, group or material change found before a specific triangle of a chunk
+	 */
+	struct GroupEvent {
+		unsigned int triangle;
+		bool hasMaterial;
+		std::string materialName;
+	};
+
+	/**
+	 * Everything read from one chunk of the file, the indices are still relative to the chunk
+	 */
+	struct ParsedChunk {
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec2> textureCoords;
+		std::vector<glm::vec3> normals;
+		std::vector<FaceCorner> corners;
+		std::vector<GroupEvent> events;
+		std::string materialLibrary;
+		bool valid = true;
+	};
+
+	/**
+	 * Triangles of one chunk that belong to a mesh
+	 */
+	struct TriangleRange {
+		unsigned int chunk;
+		unsigned int firstTriangle;
+		unsigned int lastTriangle;
+	};
+
+	// Files smaller than this are read on the calling thread only
+	static const size_t MIN_CHUNK_SIZE = 256 * 1024;
+
+	static const unsigned int MISSING_INDEX = 0xFFFFFFFF;
+
 public:
-	static bool loadOBJ(const char* path, std::vector<glm::vec3>& inputVertices,
-		std::vector<glm::vec2>& inputUvs, std::vector<glm::vec3>& inputNormalss/*, std::vector<unsigned int>& inputIndicesVertices*/);
-};
+	/**
+	 * Read the meshes of an OBJ file
+	 * @param filePath							Path of the OBJ file
+	 * @param meshes							Meshes found in the file, in the order they were declared
+	 * @param materialLibrary					Name of the MTL library referenced by the file ( if any )
+	 * @return bool								false if the file couldn't be read or references missing data
+	 */
+	static bool LoadOBJ(const std::string& filePath, std::vector<ObjMesh>& meshes, std::string& materialLibrary);
+
+	/**
+	 * Read the texture maps of every material inside a MTL library
+	 * @param filePath							Path of the MTL file
+	 * @param materials							Materials of the library by name
+	 * @return bool								false if the file couldn't be read
+	 */
+	static bool LoadMTL(const std::string& filePath, std::map<std::string, ObjMaterial>& materials);
+
+private:
+	/**
+	 * Read every line of a chunk of the file
+	 * @param begin								First character of the chunk
+	 * @param end								Character after the last line of the chunk
+	 * @param chunk								Data read from the chunk
+	 */
+	static void ParseChunk(const char* begin, const char* end, ParsedChunk& chunk);
+
+	/**
+	 * Merge the corners of a mesh into unique vertices and build its indices
+	 * @param chunks							Every chunk of the file
+	 * @param offsets							Amount of each attribute declared before every chunk
+	 * @param attributes						Attributes of the whole file in the order they were declared
+	 * @param ranges							Triangles of the mesh
+	 * @param mesh								Mesh that receives the vertices and indices
+	 * @return bool								false if a face references data that doesn't exist
+	 */
+	static bool BuildMesh(const std::vector<ParsedChunk>& chunks, const std::vector<AttributeCounts>& offsets,
+		const ParsedChunk& attributes, const std::vector<TriangleRange>& ranges, ObjMesh& mesh);
+
+	/**
+	 * Turn a reference of a face corner into a 0 based index of the whole file
+	 * @param reference							Reference stored in the corner
+	 * @param relative							Whether the reference is counted from the start of the chunk
+	 * @param offset							Amount of the attribute declared before the chunk
+	 * @return unsigned int						Index of the attribute, MISSING_INDEX if there is no reference
+	 */
+	static unsigned int ResolveIndex(const int& reference, const bool& relative, const unsigned int& offset) {
+		if (relative) {
+			return (unsigned int)((long long)offset + reference);
+		}
+		return reference > 0 ? (unsigned int)(reference - 1) : ObjLoader::MISSING_INDEX;
+	}
+
+	/**
+	 * Check if a line starts with a keyword followed by a blank
+	 * @param current							First character of the line
+	 * @param end								End of the line
+	 * @param keyword							Keyword that is checked, compared without case
+	 * @return const char*						Character after the keyword, nullptr if it doesn't match
+	 */
+	static const char* MatchKeyword(const char* current, const char* end, const char* keyword);
+
+	/**
+	 * Calculate the tangent and bitangent of every vertex from the texture coordinates of its triangles
+	 * @param mesh								Mesh with its normals and texture coordinates set
+	 */
+	static void CalculateTangents(ObjMesh& mesh);
+
+	/**
+	 * Read a decimal number in the format written by the exporters ( sign, digits, fraction, exponent )
+	 * @param current							First character, leading blanks are skipped
+	 * @param end								Character after the last one that can be read
+	 * @param value								Number that was read
+	 * @return const char*						Character after the number, nullptr if there was no number
+	 */
+	static const char* ParseFloat(const char* current, const char* end, float& value);
+
+	/**
+	 * Read a signed integer
+	 * @param current							First character
+	 * @param end								Character after the last one that can be read
+	 * @param value								Number that was read
+	 * @return const char*						Character after the number, nullptr if there was no number
+	 */
+	static const char* ParseInt(const char* current, const char* end, int& value);
+
+	/**
+	 * Read the rest of a line without the blanks around it ( names can contain spaces )
+	 * @param current							First character after the keyword
+	 * @param end								End of the line
+	 * @return string							Trimmed text
+	 */
+	static std::string ParseName(const char* current, const char* end);
+};
\ No newline at end of file
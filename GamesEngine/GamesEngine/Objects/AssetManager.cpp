@@ -1,5 +1,12 @@
 #include "AssetManager.h"
+#include "../Shaders/ShaderLibrary.h"
+#include "../Utils/GLStateCache.h"
+#include "../Utils/AsyncLoader.h"
+#include "../ModelLoader/ObjLoader.h"
 #include <iostream>
+#include <future>
+#include <algorithm>
+#include <cmath>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <imgLoader/stb_image.h>
@@ -13,51 +20,299 @@ std::vector<Mesh*> AssetManager::LoadMesh(
 	const GLenum& movementState, 
 	const glm::vec3& importedColour
 ) {
-	this->generateTextures = importTexture;
-	this->generateAnimation = importAnimation;
+	// Every placement of a file that is already loaded shares its geometry
+	std::string modelKey = filePath + "#" + std::to_string(importTexture) + std::to_string(importAnimation);
+	auto loadedModel = this->m_models.find(modelKey);
+	if (loadedModel != this->m_models.end()) {
+		return this->InstantiateModel(loadedModel->second, movementState, importedColour);
+	}
 
-	std::vector<MeshData> meshDataOutput;
+	std::vector<MeshCache::CookedMesh> cookedMeshes = AssetManager::ImportModel("Resources/3DModels/" + filePath, importTexture, importAnimation);
+	if (cookedMeshes.empty()) {
+		return std::vector<Mesh*> {};
+	}
 
-	std::string build3DModelPath = "Resources/3DModels/" + filePath;
-	Assimp::Importer meshImporter;
-	const aiScene* scene = meshImporter.ReadFile(build3DModelPath, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+	return this->InstantiateModel(this->StoreModel(modelKey, filePath, cookedMeshes), movementState, importedColour);
+}
 
-	if (!scene || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
-	{
-		std::cout << "ERROR: Mesh could not be loaded using Assimp. Error name: " << meshImporter.GetErrorString() << std::endl;
-		return std::vector<Mesh*> {};
+unsigned int AssetManager::LoadMeshAsync(
+	const std::string& filePath,
+	const bool& importTexture,
+	const bool& importAnimation,
+	const GLenum& movementState,
+	const glm::vec3& importedColour,
+	const std::function<void(const std::vector<Mesh*>&)>& onLoaded
+) {
+	std::string modelKey = filePath + "#" + std::to_string(importTexture) + std::to_string(importAnimation);
+	auto loadedModel = this->m_models.find(modelKey);
+	if (loadedModel != this->m_models.end()) {
+		onLoaded(this->InstantiateModel(loadedModel->second, movementState, importedColour));
+		return 0;
 	}
 
-	if (importTexture) {
-		// TODO: BUILD THE TEXTURE LOADER
+	// Only the first placement of a file starts its import, the others wait for the same one
+	bool isLoading = this->m_pendingModels.find(modelKey) != this->m_pendingModels.end();
+
+	unsigned int requestId = ++this->m_requestCount;
+	this->m_pendingModels[modelKey].push_back(PendingPlacement{ requestId, movementState, importedColour, onLoaded });
+
+	if (!isLoading) {
+		AsyncLoader::s_asyncLoader->Enqueue<std::vector<MeshCache::CookedMesh>>(
+			std::bind(&AssetManager::ImportModel, "Resources/3DModels/" + filePath, importTexture, importAnimation),
+			[this, modelKey, filePath](std::vector<MeshCache::CookedMesh>& cookedMeshes) {
+				this->CompleteModel(modelKey, filePath, cookedMeshes);
+			});
 	}
-	if (importAnimation)
-	{
-		// TODO: BUILD THE ANIMATION LOADER
+
+	return requestId;
+}
+
+void AssetManager::CancelMeshLoad(const unsigned int& requestId) {
+	// The import itself keeps running, the model is stored for the next placements
+	for (auto& pendingModel : this->m_pendingModels) {
+		std::vector<PendingPlacement>& placements = pendingModel.second;
+		for (auto it = placements.begin(); it != placements.end(); ++it) {
+			if (it->requestId == requestId) {
+				placements.erase(it);
+				return;
+			}
+		}
+	}
+}
+
+std::vector<MeshCache::CookedMesh> AssetManager::ImportModel(
+	const std::string& buildPath,
+	const bool& importTexture,
+	const bool& importAnimation
+) {
+	std::vector<MeshCache::CookedMesh> cookedMeshes;
+
+	// Files that were imported before are read back from their cache without going through ::assimp::
+	MeshCache meshCache;
+	if (meshCache.Open(buildPath, importTexture)) {
+		for (const MeshCache::CachedMesh& cachedMesh : meshCache.GetMeshes()) {
+			cookedMeshes.push_back(MeshCache::CookedMesh{ std::make_shared<Mesh::Geometry>(cachedMesh.geometry), cachedMesh.textures });
+		}
+		return cookedMeshes;
 	}
 
-	this->ProcessMeshScene(scene, meshDataOutput);
+	std::vector<MeshData> meshDataOutput;
 
-	std::vector<Mesh*> finalMeshOutput;
+	// OBJ files go through the engine's own reader, anything else ( or an OBJ it can't read ) through ::assimp::
+	if (!AssetManager::ProcessObjFile(buildPath, importTexture, meshDataOutput)) {
+		meshDataOutput.clear();
 
-	for (MeshData mD : meshDataOutput) {
-		Shader* newShader = new Shader(ShaderType::PHONG);
+		Assimp::Importer meshImporter;
+		const aiScene* scene = meshImporter.ReadFile(buildPath, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
 
-		std::vector<Texture*> meshTextureSet = mD.textureData;
+		if (!scene || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+		{
+			std::cout << "ERROR: Mesh could not be loaded using Assimp. Error name: " << meshImporter.GetErrorString() << std::endl;
+			return cookedMeshes;
+		}
 
-		Material* newMaterial = new Material(meshTextureSet, newShader);
+		if (importAnimation)
+		{
+			// TODO: BUILD THE ANIMATION LOADER
+		}
 
+		AssetManager::ProcessMeshScene(scene, importTexture, meshDataOutput);
+	}
+
+	for (MeshData& mD : meshDataOutput) {
+		// The colour is applied per instance so every placement of the file keeps the same vertices
 		for (unsigned int i = 0; i < mD.verticesData.size(); i++) {
-			mD.verticesData[i].colour = importedColour;
+			mD.verticesData[i].colour = glm::vec3(1.0f, 1.0f, 1.0f);
 		}
 
-		finalMeshOutput.push_back(new Mesh(newMaterial, mD.verticesData, mD.indicesData, movementState));
+		std::shared_ptr<Mesh::Geometry> geometry = std::make_shared<Mesh::Geometry>();
+		geometry->vertices = std::move(mD.verticesData);
+		geometry->indices = std::move(mD.indicesData);
+		geometry->vertexLayout = mD.vertexLayout;
+
+		// Heavy models get simplified copies of their indices for when they're far away
+		Mesh::CookGeometry(*geometry, true);
+
+		cookedMeshes.push_back(MeshCache::CookedMesh{ geometry, mD.textureData });
+	}
+
+	// The next load of the file maps these meshes instead of importing it again
+	MeshCache::Write(buildPath, importTexture, cookedMeshes);
+
+	return cookedMeshes;
+}
+
+Mesh* AssetManager::CreatePlaceholderMesh(const GLenum& movementState, const glm::vec3& importedColour) {
+	if (this->m_placeholderGeometry == nullptr) {
+		std::shared_ptr<Mesh::Geometry> geometry = std::make_shared<Mesh::Geometry>();
+
+		// Unit cube around the origin, every face has its own corners so the normals stay flat
+		const glm::vec3 faceNormals[6] = {
+			glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f),
+			glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f),
+			glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f)
+		};
+		for (const glm::vec3& normal : faceNormals) {
+			glm::vec3 up = std::abs(normal.y) > 0.5f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+			glm::vec3 right = glm::cross(up, normal);
+
+			unsigned int firstVertex = geometry->vertices.size();
+			const glm::vec2 corners[4] = { glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 1.0f) };
+			for (const glm::vec2& corner : corners) {
+				glm::vec3 position = 0.5f * normal + (corner.x - 0.5f) * right + (corner.y - 0.5f) * up;
+				geometry->vertices.push_back(Vertex(position, corner, normal, glm::vec3(1.0f, 1.0f, 1.0f)));
+			}
+
+			const unsigned int faceIndices[6] = { 0, 1, 2, 0, 2, 3 };
+			for (const unsigned int& index : faceIndices) {
+				geometry->indices.push_back(firstVertex + index);
+			}
+		}
+		geometry->vertexLayout = VertexLayout::LAYOUT_NO_TANGENT;
+
+		Mesh::CookGeometry(*geometry, false);
+		Mesh::UploadGeometry(*geometry);
+		geometry->geometryId = this->GetGeometryId("#placeholder");
+
+		this->m_placeholderGeometry = geometry;
+	}
+
+	std::vector<Texture*> placeholderTextures = { this->CheckTextureLoaded("Default.jpg", TextureType::DIFFUSE, 1, 1) };
+	Material* newMaterial = new Material(placeholderTextures, ShaderLibrary::s_shaderLibrary->GetShader(ShaderType::PHONG));
+
+	Mesh* newMesh = new Mesh(newMaterial, this->m_placeholderGeometry, movementState);
+	newMesh->SetColour(importedColour);
+	return newMesh;
+}
+
+std::vector<Mesh*> AssetManager::InstantiateModel(
+	const ModelResource& model,
+	const GLenum& movementState,
+	const glm::vec3& importedColour
+) {
+	std::vector<Mesh*> finalMeshOutput;
+
+	for (unsigned int m = 0; m < model.geometries.size(); m++) {
+		std::shared_ptr<Shader> newShader = ShaderLibrary::s_shaderLibrary->GetShader(ShaderType::PHONG);
+
+		Material* newMaterial = new Material(model.textures[m], newShader);
+
+		Mesh* newMesh = new Mesh(newMaterial, model.geometries[m], movementState);
+		newMesh->SetColour(importedColour);
+
+		finalMeshOutput.push_back(newMesh);
 	}
 
 	return finalMeshOutput;
 }
 
-void AssetManager::ProcessMeshScene(const aiScene* scene, std::vector<MeshData>& meshDataInput) {
+const AssetManager::ModelResource& AssetManager::StoreModel(
+	const std::string& modelKey,
+	const std::string& filePath,
+	const std::vector<MeshCache::CookedMesh>& cookedMeshes
+) {
+	// A synchronous load can store the file while its import is still running on a worker
+	auto loadedModel = this->m_models.find(modelKey);
+	if (loadedModel != this->m_models.end()) {
+		return loadedModel->second;
+	}
+
+	ModelResource model;
+
+	for (unsigned int m = 0; m < cookedMeshes.size(); m++) {
+		const MeshCache::CookedMesh& cookedMesh = cookedMeshes[m];
+
+		Mesh::UploadGeometry(*cookedMesh.geometry);
+		cookedMesh.geometry->geometryId = this->GetGeometryId(filePath + "#" + std::to_string(m));
+
+		// The model keeps its textures loaded for as long as it's loaded itself
+		std::vector<Texture*> meshTextureSet;
+		for (const MeshCache::TextureReference& textureReference : cookedMesh.textures) {
+			Texture* texture = this->CheckTextureLoaded(textureReference.fileName, textureReference.textureType, 1000, 1000);
+			this->AcquireTexture(texture);
+			meshTextureSet.push_back(texture);
+		}
+
+		model.geometries.push_back(cookedMesh.geometry);
+		model.textures.push_back(meshTextureSet);
+	}
+
+	return this->m_models.insert({ modelKey, model }).first->second;
+}
+
+void AssetManager::CompleteModel(
+	const std::string& modelKey,
+	const std::string& filePath,
+	const std::vector<MeshCache::CookedMesh>& cookedMeshes
+) {
+	// Taken out first, a placement can request the same file again from its callback
+	std::vector<PendingPlacement> placements;
+	auto pendingModel = this->m_pendingModels.find(modelKey);
+	if (pendingModel != this->m_pendingModels.end()) {
+		placements = pendingModel->second;
+		this->m_pendingModels.erase(pendingModel);
+	}
+
+	if (cookedMeshes.empty()) {
+		for (const PendingPlacement& placement : placements) {
+			placement.onLoaded(std::vector<Mesh*> {});
+		}
+		return;
+	}
+
+	const ModelResource& model = this->StoreModel(modelKey, filePath, cookedMeshes);
+	for (const PendingPlacement& placement : placements) {
+		placement.onLoaded(this->InstantiateModel(model, placement.movementState, placement.colour));
+	}
+}
+
+bool AssetManager::ProcessObjFile(const std::string& filePath, const bool& importTexture, std::vector<MeshData>& meshDataInput) {
+	std::string extension = filePath.size() > 4 ? filePath.substr(filePath.size() - 4) : "";
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	if (extension != ".obj") {
+		return false;
+	}
+
+	std::vector<ObjMesh> objMeshes;
+	std::string materialLibrary;
+	if (!ObjLoader::LoadOBJ(filePath, objMeshes, materialLibrary)) {
+		return false;
+	}
+
+	// The library is next to the file that references it
+	std::map<std::string, ObjMaterial> materials;
+	if (importTexture && !materialLibrary.empty()) {
+		ObjLoader::LoadMTL(filePath.substr(0, filePath.find_last_of("/\\") + 1) + materialLibrary, materials);
+	}
+
+	for (ObjMesh& objMesh : objMeshes) {
+		MeshData meshData;
+		meshData.verticesData = std::move(objMesh.vertices);
+		meshData.indicesData = std::move(objMesh.indices);
+		meshData.vertexLayout = objMesh.vertexLayout;
+
+		// Same maps and order as MeshMaterialLoader, the diffuse map falls back to the default one
+		if (importTexture) {
+			auto material = materials.find(objMesh.materialName);
+			const ObjMaterial objMaterial = material != materials.end() ? material->second : ObjMaterial();
+
+			meshData.textureData.push_back(MeshCache::TextureReference{
+				objMaterial.diffuseMap.empty() ? "Default.jpg" : objMaterial.diffuseMap, TextureType::DIFFUSE });
+			if (!objMaterial.specularMap.empty()) {
+				meshData.textureData.push_back(MeshCache::TextureReference{ objMaterial.specularMap, TextureType::SPECULAR });
+			}
+			if (!objMaterial.bumpMap.empty()) {
+				meshData.textureData.push_back(MeshCache::TextureReference{ objMaterial.bumpMap, TextureType::BUMP });
+			}
+		}
+
+		meshDataInput.push_back(std::move(meshData));
+	}
+
+	return true;
+}
+
+void AssetManager::ProcessMeshScene(const aiScene* scene, const bool& importTexture, std::vector<MeshData>& meshDataInput) {
 	aiNode* sceneNode = scene->mRootNode;
 
 	// After we've processed all of the meshes (if any) we then recursively process each of the children nodes
@@ -70,17 +325,17 @@ void AssetManager::ProcessMeshScene(const aiScene* scene, std::vector<MeshData>&
 			// The node object only contains indices to index the actual objects in the scene. 
 			// The scene contains all the data, node is just to keep stuff organized (like relations between nodes).
 			aiMesh* mesh = scene->mMeshes[meshSceneNodeChildren->mMeshes[i]];
-			MeshData tempMesh = this->ProcessMeshData(scene, mesh);
+			MeshData tempMesh = AssetManager::ProcessMeshData(scene, mesh, importTexture);
 			meshDataInput.push_back(tempMesh);
 		}
 	}
 }
 
-MeshData AssetManager::ProcessMeshData(const aiScene* scene, aiMesh* meshDataScene) {
+MeshData AssetManager::ProcessMeshData(const aiScene* scene, aiMesh* meshDataScene, const bool& importTexture) {
 	std::vector<Vertex> vertices;
 	std::vector<unsigned int> indices;
 
-	std::vector<Texture*> textures;
+	std::vector<MeshCache::TextureReference> textures;
 	//vector<Texture> textures;
 	//vector<VertexBoneData> bones_id_weights_for_each_vertex;
 
@@ -162,19 +417,19 @@ MeshData AssetManager::ProcessMeshData(const aiScene* scene, aiMesh* meshDataSce
 	}
 
 	// Material
-	if (this->generateTextures) {
+	if (importTexture) {
 		aiMaterial* material = scene->mMaterials[meshDataScene->mMaterialIndex];
 
 		// Diffuse Map
-		std::vector<Texture*> diffuseMaps = this->MeshMaterialLoader(material, TextureType::DIFFUSE);
+		std::vector<MeshCache::TextureReference> diffuseMaps = AssetManager::MeshMaterialLoader(material, TextureType::DIFFUSE);
 		textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
 
 		// Specular Map
-		std::vector<Texture*> specularMaps = this->MeshMaterialLoader(material, TextureType::SPECULAR);
+		std::vector<MeshCache::TextureReference> specularMaps = AssetManager::MeshMaterialLoader(material, TextureType::SPECULAR);
 		textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
 
 		// Normal Map
-		std::vector<Texture*> normalMaps = this->MeshMaterialLoader(material, TextureType::BUMP);
+		std::vector<MeshCache::TextureReference> normalMaps = AssetManager::MeshMaterialLoader(material, TextureType::BUMP);
 		textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
 	}
 
@@ -183,6 +438,10 @@ MeshData AssetManager::ProcessMeshData(const aiScene* scene, aiMesh* meshDataSce
 	outputMeshData.verticesData = vertices;
 	outputMeshData.textureData = textures;
 
+	// Don't upload the tangent space if the importer couldn't generate it
+	outputMeshData.vertexLayout = (meshDataScene->mTangents != NULL && meshDataScene->mBitangents != NULL)
+		? VertexLayout::LAYOUT_FULL : VertexLayout::LAYOUT_NO_TANGENT;
+
 	return outputMeshData;
 
 #if 0
@@ -224,44 +483,81 @@ MeshData AssetManager::ProcessMeshData(const aiScene* scene, aiMesh* meshDataSce
 #endif
 }
 
-std::vector<Texture*> AssetManager::MeshMaterialLoader(aiMaterial* material, const TextureType& textureType) {
-	std::vector<Texture*> textures;
+std::vector<MeshCache::TextureReference> AssetManager::MeshMaterialLoader(aiMaterial* material, const TextureType& textureType) {
+	std::vector<MeshCache::TextureReference> textures;
 
 	for (unsigned int i = 0; i < material->GetTextureCount(TextureTypeToAssimp(textureType)); i++) {
 		aiString filePath;
 		material->GetTexture(TextureTypeToAssimp(textureType), i, &filePath);
 
-		// Check if texture was loaded before and if so, continue to next iteration: skip loading a new texture
-		std::string filename = std::string(filePath.C_Str());
-		Texture* texture = this->CheckTextureLoaded(filename, textureType, 1000, 1000);
-
-		textures.push_back(texture);
+		// The texture itself is loaded once the model is stored, a texture that was loaded before is reused
+		textures.push_back(MeshCache::TextureReference{ std::string(filePath.C_Str()), textureType });
 	}
 
 	// If no materials have been found, use the default map
 	if (textureType == TextureType::DIFFUSE && textures.size() <= 0) {
-		textures.push_back(this->CheckTextureLoaded("Default.jpg", TextureType::DIFFUSE, 1, 1));
+		textures.push_back(MeshCache::TextureReference{ "Default.jpg", TextureType::DIFFUSE });
 	}
 
 	return textures;
 }
 
-void AssetManager::LoadTexture(const std::string& fileName, GLuint& textureId, int& width, int& height) {
+void AssetManager::RequestTextureImage(const AssetHandle<Texture>& textureHandle, const std::string& fileName) {
+	struct DecodedImage {
+		std::shared_ptr<unsigned char> image;
+		int width = 0;
+		int height = 0;
+	};
+
+	// The flip flag is global to stb_image so it's set before the decode starts
 	stbi_set_flip_vertically_on_load(0);
 
 	std::string buildName = "Resources/Textures/" + fileName;
-	int bits; // BitsPerPixels
-	unsigned char* image = stbi_load(buildName.c_str(), &width, &height, &bits, 4);
+	AsyncLoader::s_asyncLoader->Enqueue<DecodedImage>(
+		[buildName]() {
+			DecodedImage decodedImage;
+			int bits; // BitsPerPixels
+			decodedImage.image = std::shared_ptr<unsigned char>(
+				stbi_load(buildName.c_str(), &decodedImage.width, &decodedImage.height, &bits, 4), stbi_image_free);
+			return decodedImage;
+		},
+		[this, textureHandle, fileName](DecodedImage& decodedImage) {
+			// The texture may have been unloaded while its image was decoded
+			Texture* texture = this->m_textures.Get(textureHandle);
+			if (texture == nullptr) {
+				return;
+			}
+
+			if (decodedImage.image == nullptr) {
+				std::cout << "ERROR: Texture " << fileName << " failed to load!" << std::endl;
+				return;
+			}
+
+			GLuint textureId = texture->GetTextureID();
+			this->ProcessTexture(decodedImage.image.get(), textureId, decodedImage.width, decodedImage.height);
+			texture->SetTextureSize(decodedImage.width, decodedImage.height);
+		});
+}
 
-	if (image == NULL) {
-		std::cout << "ERROR: Texture failed to load!" << std::endl;
+void AssetManager::LoadPlaceholderTexture(const TextureType& textureType, GLuint& textureId) {
+	unsigned char texel[4] = { 255, 255, 255, 255 };
+	switch (textureType) {
+	case TextureType::EMISSIVE:
+		texel[0] = texel[1] = texel[2] = 0;
+		break;
+	case TextureType::NORMAL:
+	case TextureType::BUMP:
+		texel[0] = texel[1] = 128;
+		break;
+	default:
+		break;
 	}
 
-	this->ProcessTexture(image, textureId, width, height);
+	this->ProcessTexture(texel, textureId, 1, 1);
 }
 
 void AssetManager::ProcessTexture(const unsigned char* loadedImageData, GLuint& textureId, int width, int height) {
-	glBindTexture(GL_TEXTURE_2D, textureId);
+	GLStateCache::s_stateCache->BindTexture(GL_TEXTURE_2D, textureId);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
@@ -270,52 +566,171 @@ void AssetManager::ProcessTexture(const unsigned char* loadedImageData, GLuint&
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0,
 		GL_RGBA, GL_UNSIGNED_BYTE, loadedImageData);
 	glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+bool AssetManager::LoadCubeMap(const std::vector<std::string>& faceFiles, GLuint& textureId, int& faceSize) {
+	struct DecodedFace {
+		unsigned char* image = nullptr;
+		int width = 0;
+		int height = 0;
+	};
+
+	// The flip flag is global to stb_image so it's set before any decode starts
+	stbi_set_flip_vertically_on_load(0);
 
-	stbi_image_free((void*)loadedImageData);
+	std::vector<std::future<DecodedFace>> decodeTasks;
+	for (const std::string& fileName : faceFiles) {
+		decodeTasks.push_back(std::async(std::launch::async, [fileName]() {
+			DecodedFace face;
+			int bits; // BitsPerPixels
+			face.image = stbi_load(("Resources/Textures/" + fileName).c_str(), &face.width, &face.height, &bits, 4);
+			return face;
+		}));
+	}
+
+	std::vector<DecodedFace> faces;
+	for (std::future<DecodedFace>& task : decodeTasks) {
+		faces.push_back(task.get());
+	}
+
+	bool loaded = faces.size() == 6;
+	for (unsigned int i = 0; i < faces.size(); i++) {
+		if (faces[i].image == NULL) {
+			std::cout << "ERROR: Cube map face " << faceFiles[i] << " failed to load!" << std::endl;
+			loaded = false;
+		}
+		else if (faces[i].width != faces[0].width || faces[i].width != faces[i].height) {
+			std::cout << "ERROR: Cube map face " << faceFiles[i] << " is not a square of the same size as the others!" << std::endl;
+			loaded = false;
+		}
+	}
+
+	faceSize = loaded ? faces[0].width : 0;
+
+	if (loaded) {
+		GLStateCache::s_stateCache->BindTexture(GL_TEXTURE_CUBE_MAP, textureId);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		for (unsigned int i = 0; i < faces.size(); i++) {
+			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, faceSize, faceSize, 0,
+				GL_RGBA, GL_UNSIGNED_BYTE, faces[i].image);
+		}
+		GLStateCache::s_stateCache->BindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	}
+
+	for (DecodedFace& face : faces) {
+		if (face.image != NULL) {
+			stbi_image_free(face.image);
+		}
+	}
+
+	return loaded;
 }
 
 Texture* AssetManager::CheckTextureLoaded(const std::string& fileName, const TextureType& textureType, int width, int height)
 {
-	for (unsigned int i = 0; i < this->m_loadedAssets.size(); i++)
-	{
-		if (this->m_loadedAssetsTypes[i] == AssetType::TEXTURE) {
-			if (std::strcmp(((Texture*)this->m_loadedAssets[i])->GetTextureName().c_str(), fileName.c_str()) == 0
-				&& textureType == ((Texture*)this->m_loadedAssets[i])->GetTextureType())
-			{
-				return ((Texture*)this->m_loadedAssets[i]);
-			}
-		}
+	unsigned int pathId = this->InternPath(fileName);
+
+	AssetHandle<Texture> textureHandle = this->m_textures.Find(pathId, textureType);
+	if (textureHandle.IsValid()) {
+		return this->m_textures.Get(textureHandle);
 	}
 
-	return new Texture(fileName, textureType, width, height);
+	Texture* newTexture = new Texture(fileName, textureType, width, height);
+	textureHandle = this->m_textures.Add(pathId, textureType, newTexture);
+	newTexture->SetAssetHandle(textureHandle);
+
+	// The texture draws its placeholder until the image is decoded
+	this->RequestTextureImage(textureHandle, fileName);
+	return newTexture;
+}
+
+void AssetManager::AcquireTexture(Texture* texture) {
+	if (texture != nullptr) {
+		this->m_textures.Acquire(texture->GetAssetHandle());
+	}
+}
+
+void AssetManager::ReleaseTexture(Texture* texture) {
+	if (texture != nullptr) {
+		this->m_textures.Release(texture->GetAssetHandle());
+	}
 }
 
 void AssetManager::LoadSound(const std::string& fileName, FMOD_MODE fModMode) {
+	if (this->CheckSoundLoaded(fileName) != nullptr) {
+		return;
+	}
+
 	FMOD::Sound* newSound = nullptr;
 
 	std::string buildFileName = "Resources/AudioSamples/" + fileName;
 
-	newSound = this->CheckSoundLoaded(buildFileName);
+	if (!SoundEngine::s_soundEngine
+		->ErrorCheck(SoundEngine::s_soundEngine->GetLowerSystem()->createSound(buildFileName.c_str(), fModMode, NULL, &newSound))) {
+		return;
+	}
 
-	if (newSound == nullptr) {
-		SoundEngine::s_soundEngine
-			->ErrorCheck(SoundEngine::s_soundEngine->GetLowerSystem()->createSound(buildFileName.c_str(), fModMode, NULL, &newSound));
+	SoundEngine::s_soundEngine->InitialiseNewSound(fileName, newSound);
 
-		SoundEngine::s_soundEngine->InitialiseNewSound(fileName, newSound);
-		this->PushLoadedAsset(AssetType::AUDIO, (unsigned int*)newSound);
-	}
+	// The sound engine holds the reference until the sound is unloaded
+	AssetHandle<FMOD::Sound> soundHandle = this->m_sounds.Add(this->InternPath(fileName), 0, newSound);
+	this->m_sounds.Acquire(soundHandle);
 }
 
 FMOD::Sound* AssetManager::CheckSoundLoaded(const std::string& fileName) {
-	SoundMap tempMap = SoundEngine::s_soundEngine->GetEngineSoundMap();
+	return this->m_sounds.Get(this->m_sounds.Find(this->InternPath(fileName)));
+}
 
-	for (unsigned int i = 0; i < tempMap.size(); i++)
-	{
-		if (tempMap.count(fileName) > 0)
-		{
-			return SoundEngine::s_soundEngine->GetFromMap<FMOD::Sound, SoundMap>(fileName, tempMap);
+bool AssetManager::UnloadSound(const std::string& fileName) {
+	AssetHandle<FMOD::Sound> soundHandle = this->m_sounds.Find(this->InternPath(fileName));
+	if (!soundHandle.IsValid()) {
+		return false;
+	}
+
+	SoundEngine::s_soundEngine->RemoveSound(fileName);
+	this->m_sounds.Release(soundHandle);
+	return this->m_sounds.Unload(soundHandle);
+}
+
+unsigned int AssetManager::UnloadUnusedAssets() {
+	unsigned int unloaded = 0;
+
+	for (auto it = this->m_models.begin(); it != this->m_models.end();) {
+		// Only the model itself holds geometry that no mesh is using anymore
+		bool isUsed = false;
+		for (const std::shared_ptr<Mesh::Geometry>& geometry : it->second.geometries) {
+			isUsed = isUsed || geometry.use_count() > 1;
 		}
+
+		if (isUsed) {
+			++it;
+			continue;
+		}
+
+		for (const std::vector<Texture*>& meshTextures : it->second.textures) {
+			for (Texture* texture : meshTextures) {
+				this->ReleaseTexture(texture);
+			}
+		}
+
+		it = this->m_models.erase(it);
+		unloaded++;
 	}
 
-	return nullptr;
+	return unloaded + this->m_textures.UnloadUnused() + this->m_sounds.UnloadUnused();
 }
+
+unsigned int AssetManager::InternPath(const std::string& filePath) {
+	auto it = this->m_pathIds.find(filePath);
+	if (it != this->m_pathIds.end()) {
+		return it->second;
+	}
+
+	unsigned int newId = this->m_pathIds.size();
+	this->m_pathIds.insert({ filePath, newId });
+	return newId;
+}
\ No newline at end of file
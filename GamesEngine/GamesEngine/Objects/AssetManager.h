@@ -1,31 +1,64 @@
 #pragma once
 #include "Mesh.h"
+#include "MeshCache.h"
+#include "AssetRegistry.h"
 #include "../Utils/SoundEngine.h"
 #include <vector>
 #include <string>
+#include <map>
+#include <unordered_map>
+#include <functional>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
-enum AssetType {
-	MESH,
-	TEXTURE,
-	AUDIO
-};
-
 struct MeshData {
 	std::vector<Vertex> verticesData;
 	std::vector<unsigned int> indicesData;
-	std::vector<Texture*> textureData;
+	std::vector<MeshCache::TextureReference> textureData;
+	unsigned int vertexLayout = VertexLayout::LAYOUT_FULL;
 };
 
 class AssetManager {
 private:
-	std::vector<AssetType> m_loadedAssetsTypes;
-	std::vector<unsigned int*> m_loadedAssets;
+	/**
+	 * Geometry and textures of every sub mesh of a file imported with a set of options, every
+	 * GameObject created from the same file shares them and only keeps its own materials
+	 */
+	struct ModelResource {
+		std::vector<std::shared_ptr<Mesh::Geometry>> geometries;
+		std::vector<std::vector<Texture*>> textures;
+	};
+
+	/**
+	 * Placement of a model that is still being imported on a worker thread
+	 */
+	struct PendingPlacement {
+		unsigned int requestId;
+		GLenum movementState;
+		glm::vec3 colour;
+		std::function<void(const std::vector<Mesh*>&)> onLoaded;
+	};
 
-	bool generateTextures = false;
-	bool generateAnimation = false;
+	// Id of every path an asset was requested with, the registries are indexed by it
+	std::unordered_map<std::string, unsigned int> m_pathIds;
+
+	// Loaded textures by path and TextureType, loaded sounds by file name
+	AssetRegistry<Texture> m_textures;
+	AssetRegistry<FMOD::Sound> m_sounds;
+
+	// Models that were loaded by file path and import options
+	std::map<std::string, ModelResource> m_models;
+
+	// Placements waiting for a model that is being imported, by the same key as the models
+	std::map<std::string, std::vector<PendingPlacement>> m_pendingModels;
+	unsigned int m_requestCount = 0;
+
+	// Id of the geometry of every imported file + sub mesh index, used for instancing
+	std::map<std::string, unsigned int> m_geometryIds;
+
+	// Cube drawn in place of the models that are still loading
+	std::shared_ptr<Mesh::Geometry> m_placeholderGeometry;
 
 public:
 	/**
@@ -65,18 +98,11 @@ public:
 		}
 	}
 
-	AssetManager() {};
+	AssetManager()
+		: m_textures([](Texture* texture) { delete texture; }),
+		m_sounds([](FMOD::Sound* sound) { sound->release(); }) {};
 	~AssetManager() {
-		for (unsigned int i = 0; i < this->m_loadedAssets.size(); i++) {
-			switch (this->m_loadedAssetsTypes[i]) {
-			case AssetType::TEXTURE:
-				delete ((Texture*)this->m_loadedAssets[i]);
-				break;
-			case AssetType::MESH:
-				delete ((Mesh*)this->m_loadedAssets[i]);
-				break;
-			}
-		}
+		// The registries unload whatever is still loaded
 	};
 
 	/**
@@ -85,7 +111,7 @@ public:
 	 * @param importTexture						Whether the texture shoudlbe imported or not
 	 * @param importAnimation					Whether the animation should be imported or not
 	 * @param movementState						Movement state of the imported mesh
-	 * @param importedColour					Mesh colour for each vertex
+	 * @param importedColour					Mesh colour ( applied per instance )
 	 * @return vector<Mesh*>					Data formated in the mesh properties of a mesh
 	 *											so that it can be passed to the mesh
 	 */
@@ -96,39 +122,146 @@ public:
 		const GLenum& movementState, 
 		const glm::vec3& importedColour = glm::vec3(1.0f, 1.0f, 1.0f));
 
+	/**
+	 * Load a mesh without blocking, the file is read ( from its cache or through ::assimp:: ) on a worker
+	 * thread and only the upload runs on the main thread during AsyncLoader::ProcessJobs
+	 * Placements of a file that is already loading wait for the same import
+	 * @param filePath							The path to the mesh that needs importing
+	 * @param importTexture						Whether the texture shoudlbe imported or not
+	 * @param importAnimation					Whether the animation should be imported or not
+	 * @param movementState						Movement state of the imported mesh
+	 * @param importedColour					Mesh colour ( applied per instance )
+	 * @param onLoaded							Receives the meshes once they're uploaded, an empty
+	 *											vector if the file couldn't be loaded
+	 * @return unsigned int						Id of the request for CancelMeshLoad, 0 if the model was
+	 *											already loaded and onLoaded was called right away
+	 */
+	unsigned int LoadMeshAsync(
+		const std::string& filePath,
+		const bool& importTexture,
+		const bool& importAnimation,
+		const GLenum& movementState,
+		const glm::vec3& importedColour,
+		const std::function<void(const std::vector<Mesh*>&)>& onLoaded);
+
+	/**
+	 * Drop a placement that is still waiting for its model, its callback is never called
+	 * @param requestId							Id returned by LoadMeshAsync
+	 */
+	void CancelMeshLoad(const unsigned int& requestId);
+
+	/**
+	 * Read a model file into meshes that aren't uploaded yet, from its cache when it's up to date or
+	 * else through the ObjLoader or ::assimp:: ( the cache is written for the next load )
+	 * Nothing of the manager or the context is touched so it can run on a worker thread
+	 * @param buildPath							Path of the file inside the resources
+	 * @param importTexture						Whether the textures of the materials are referenced
+	 * @param importAnimation					Whether the animation should be imported or not
+	 * @return vector<CookedMesh>				Meshes of the file, empty if it couldn't be read
+	 */
+	static std::vector<MeshCache::CookedMesh> ImportModel(
+		const std::string& buildPath,
+		const bool& importTexture,
+		const bool& importAnimation);
+
+	/**
+	 * Create a cube that is drawn in place of a model until it's loaded
+	 * @param movementState						Movement state of the mesh
+	 * @param importedColour					Mesh colour ( applied per instance )
+	 * @return Mesh*							Mesh sharing the geometry of every other placeholder
+	 */
+	Mesh* CreatePlaceholderMesh(const GLenum& movementState, const glm::vec3& importedColour);
+
+	/**
+	 * Create new placements of a model that was already loaded, the geometry is shared and
+	 * every mesh gets its own material with the textures of the model
+	 * @param model								Model that was loaded before
+	 * @param movementState						Movement state of the new meshes
+	 * @param importedColour					Mesh colour ( applied per instance )
+	 * @return vector<Mesh*>					One mesh per sub mesh of the model
+	 */
+	std::vector<Mesh*> InstantiateModel(
+		const ModelResource& model,
+		const GLenum& movementState,
+		const glm::vec3& importedColour);
+
+	/**
+	 * Upload the meshes of a file that was just imported and keep their geometry and textures
+	 * so the next placements of the same file share them ( main thread only )
+	 * @param modelKey							File path and import options of the model
+	 * @param filePath							The path to the mesh that was requested
+	 * @param cookedMeshes						Meshes imported from the file
+	 * @return ModelResource					Model that was stored
+	 */
+	const ModelResource& StoreModel(
+		const std::string& modelKey,
+		const std::string& filePath,
+		const std::vector<MeshCache::CookedMesh>& cookedMeshes);
+
+	/**
+	 * Store a model that was imported on a worker thread and hand its meshes to every placement
+	 * that was waiting for it
+	 * @param modelKey							File path and import options of the model
+	 * @param filePath							The path to the mesh that was requested
+	 * @param cookedMeshes						Meshes imported from the file
+	 */
+	void CompleteModel(
+		const std::string& modelKey,
+		const std::string& filePath,
+		const std::vector<MeshCache::CookedMesh>& cookedMeshes);
+
+	/**
+	 * Read an OBJ file with the engine's ObjLoader and create the necesary MeshData, the textures
+	 * are taken from the MTL library of the file
+	 * @param filePath							The path to the file that needs importing
+	 * @param importTexture						Whether the textures of the materials are referenced
+	 * @param meshDataInput						Mesh data of every mesh found in the file
+	 * @return bool								false if the file isn't an OBJ or couldn't be read,
+	 *											the file then has to go through ::assimp::
+	 */
+	static bool ProcessObjFile(const std::string& filePath, const bool& importTexture, std::vector<MeshData>& meshDataInput);
+
 	/**
 	 * With the data loaded by the mesh loader through ::assimp:: process and it create the necesary MeshData
 	 * @param scene								The scene of the loaded file
+	 * @param importTexture						Whether the textures of the materials are referenced
 	 * @param meshData							Refference to the mesh data from the mesh constructor
 	 *											in order to export the data loaded by the AM
 	 */
-	void ProcessMeshScene(const aiScene* scene, std::vector<MeshData>& meshDataInput);
+	static void ProcessMeshScene(const aiScene* scene, const bool& importTexture, std::vector<MeshData>& meshDataInput);
 
 	/**
 	 * With the data loaded by the mesh loader through ::assimp:: process and it create the necesary MeshData
 	 * @param scene								The scene of the loaded file
 	 * @param meshDataScene						Mesh data loaded by the ::assimp::loader
+	 * @param importTexture						Whether the textures of the materials are referenced
 	 * @return MeshData							Result of parsing the sceneMesh into the meshData we need
 	 */
-	MeshData ProcessMeshData(const aiScene* scene, aiMesh* meshDataScene);
+	static MeshData ProcessMeshData(const aiScene* scene, aiMesh* meshDataScene, const bool& importTexture);
 
 	/**
-	 * Load the material that was stores as refference by the ::assimp:: scene loader
+	 * Find the textures of a type that were stored as refference by the ::assimp:: scene loader
 	 * @param material							Material that was found by the scene loader
 	 * @param textureType						Type of the texture that the material should be bound to
-	 * @return vector<Texture*>					Vector of textures to be bound to the material
+	 * @return vector<TextureReference>			Textures to be bound to the material
 	 */
-	std::vector<Texture*> MeshMaterialLoader(aiMaterial* material, const TextureType& textureType);
+	static std::vector<MeshCache::TextureReference> MeshMaterialLoader(aiMaterial* material, const TextureType& textureType);
 
 	/**
-	 * Load the mesh using ::assimp:: and gets the Mesh data exporting it into the object
-	 * @param fileName							The path to the mesh that needs importing
-	 * @param textureId							The generated texture based on it's object instance and
-	 *											and instantiation
-	 * @param width								The width that the map should be converted to
-	 * @param height							The height that the map should be converted to
+	 * Decode the image of a texture on a worker thread, it's uploaded to the texture during
+	 * AsyncLoader::ProcessJobs and the texture keeps its placeholder until then
+	 * @param textureHandle						Handle of the texture inside the registry
+	 * @param fileName							The path to the image of the texture
+	 */
+	void RequestTextureImage(const AssetHandle<Texture>& textureHandle, const std::string& fileName);
+
+	/**
+	 * Fill a texture with a single texel that has no effect on the shading until its image is loaded
+	 * ( white for the colour maps, black for emission and a flat normal for the normal maps )
+	 * @param textureType						The type of the texture
+	 * @param textureId							The generated texture the texel is uploaded to
 	 */
-	void LoadTexture(const std::string& fileName, GLuint& textureId, int& width, int& height);
+	void LoadPlaceholderTexture(const TextureType& textureType, GLuint& textureId);
 
 	/**
 	 * With the data that was loaded generate the texture and then return the id
@@ -140,6 +273,16 @@ public:
 	 */
 	void ProcessTexture(const unsigned char* loadedImageData, GLuint& textureId, int width, int height);
 
+	/**
+	 * Load the six faces of a cube map, the images are decoded on worker threads at the same
+	 * time and only the upload to the texture happens on the thread that owns the context
+	 * @param faceFiles							Paths of the faces in the order +X, -X, +Y, -Y, +Z, -Z
+	 * @param textureId							Generated GL_TEXTURE_CUBE_MAP the faces are uploaded to
+	 * @param faceSize							Width and height of the faces that were loaded
+	 * @return bool								false if one of the faces couldn't be decoded
+	 */
+	bool LoadCubeMap(const std::vector<std::string>& faceFiles, GLuint& textureId, int& faceSize);
+
 	/**
 	 * Check if the texture that follows to be loaded already exists inside the resource manager
 	 * @param fileName							The path to the mesh that needs importing
@@ -160,23 +303,58 @@ public:
 
 	/**
 	 * Check if the sound that is passed at this point has been already loaded by the resource manager
-	 * @param fileName							The path to the specific sound sample that needs testing
+	 * @param fileName							The name of the sound sample that needs testing
 	 * @return FMOD::Sound*						Return pointer to the already existing sample
 	 */
 	FMOD::Sound* CheckSoundLoaded(const std::string& fileName);
 
+	/**
+	 * Remove a sound from the sound engine and unload it
+	 * @param fileName							The name the sound was loaded with
+	 * @return bool								false if the sound isn't loaded
+	 */
+	bool UnloadSound(const std::string& fileName);
+
+	/**
+	 * Add or drop a reference to a texture loaded by the resource manager,
+	 * textures that weren't loaded through it are ignored
+	 * @param texture							Texture that is referenced
+	 */
+	void AcquireTexture(Texture* texture);
+	void ReleaseTexture(Texture* texture);
+
+	/**
+	 * Unload every asset that nothing references anymore ( e.g. after a scene was cleared ),
+	 * models go first so the textures only they were holding can be unloaded with them
+	 * @return unsigned int						Number of assets that were unloaded
+	 */
+	unsigned int UnloadUnusedAssets();
+
+	/**
+	 * Get the id of a path, the same path always gets the same id
+	 * @param filePath							Path of the asset
+	 * @return unsigned int						Id of the path
+	 */
+	unsigned int InternPath(const std::string& filePath);
+
 
 	/**
 	 * Getters and setters
 	 */
 public:
-	inline std::vector<unsigned int*> GetLoadedAssets() { return this->m_loadedAssets; }
-	inline unsigned int* GetLoadedAssetsById(const int& id) { return this->m_loadedAssets[id]; }
-	inline std::vector<AssetType> GetLoadedAssetsTypes() { return this->m_loadedAssetsTypes; }
-	inline const AssetType& GetLoadedAssetsTypesById(const int& id) { return this->m_loadedAssetsTypes[id]; }
-
-	inline void PushLoadedAsset(AssetType newAssetType, unsigned int* newAsset) { 
-		this->m_loadedAssets.push_back(newAsset); 
-		this->m_loadedAssetsTypes.push_back(newAssetType);
+	inline unsigned int GetLoadedTextureCount() const { return this->m_textures.GetLoadedCount(); }
+	inline unsigned int GetLoadedSoundCount() const { return this->m_sounds.GetLoadedCount(); }
+	inline unsigned int GetLoadedModelCount() const { return this->m_models.size(); }
+	inline bool HasPendingModels() const { return !this->m_pendingModels.empty(); }
+
+	inline unsigned int GetGeometryId(const std::string& geometryName) {
+		// Id 0 is reserved for the meshes that don't share their geometry
+		auto it = this->m_geometryIds.find(geometryName);
+		if (it != this->m_geometryIds.end()) {
+			return it->second;
+		}
+		unsigned int newId = this->m_geometryIds.size() + 1;
+		this->m_geometryIds.insert({ geometryName, newId });
+		return newId;
 	}
 };
\ No newline at end of file
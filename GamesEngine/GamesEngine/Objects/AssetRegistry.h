@@ -0,0 +1,203 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <iostream>
+
+/**
+ * Reference to an asset stored in an AssetRegistry of the same type, the generation makes a handle
+ * to an asset that was unloaded stop resolving even after its slot is reused by another asset
+ */
+template<typename T>
+struct AssetHandle {
+	static const unsigned int INVALID_INDEX = 0xFFFFFFFF;
+
+	unsigned int index = INVALID_INDEX;
+	unsigned int generation = 0;
+
+	inline bool IsValid() const { return this->index != INVALID_INDEX; }
+	inline bool operator==(const AssetHandle<T>& other) const { return this->index == other.index && this->generation == other.generation; }
+	inline bool operator!=(const AssetHandle<T>& other) const { return !(*this == other); }
+};
+
+/**
+ * Storage of the loaded assets of one type, found in constant time by the interned id of their path
+ * and a sub type ( e.g. the TextureType of a texture ), every asset counts the references to it
+ * Assets aren't unloaded as soon as nothing uses them anymore, they stay cached until they're
+ * unloaded explicitly so a level that is reloaded doesn't read them from disk again
+ */
+template<typename T>
+class AssetRegistry {
+private:
+	struct Slot {
+		T* asset = nullptr;
+		unsigned int generation = 1;
+		unsigned int referenceCount = 0;
+		unsigned long long key = 0;
+	};
+
+	std::vector<Slot> m_slots;
+	std::vector<unsigned int> m_freeSlots;
+	std::unordered_map<unsigned long long, unsigned int> m_lookup;
+
+	// Releases the resources of an asset once it's unloaded
+	std::function<void(T*)> m_unloader;
+
+public:
+	AssetRegistry(const std::function<void(T*)>& unloader) : m_unloader(unloader) {}
+	~AssetRegistry() { this->UnloadAll(); }
+
+	AssetRegistry(const AssetRegistry&) = delete;
+	AssetRegistry& operator=(const AssetRegistry&) = delete;
+
+	/**
+	 * Find an asset that was already added
+	 * @param pathId							Interned id of the path of the asset
+	 * @param subType							Variant of the asset loaded from the same path
+	 * @return AssetHandle						Handle of the asset, invalid if it isn't loaded
+	 */
+	AssetHandle<T> Find(const unsigned int& pathId, const unsigned int& subType = 0) const {
+		auto it = this->m_lookup.find(AssetRegistry<T>::MakeKey(pathId, subType));
+		if (it == this->m_lookup.end()) {
+			return AssetHandle<T>();
+		}
+		return AssetHandle<T>{ it->second, this->m_slots[it->second].generation };
+	}
+
+	/**
+	 * Take ownership of a loaded asset, it starts without any reference
+	 * @param pathId							Interned id of the path of the asset
+	 * @param subType							Variant of the asset loaded from the same path
+	 * @param asset								Asset that was loaded
+	 * @return AssetHandle						Handle of the asset
+	 */
+	AssetHandle<T> Add(const unsigned int& pathId, const unsigned int& subType, T* asset) {
+		unsigned long long key = AssetRegistry<T>::MakeKey(pathId, subType);
+		if (this->m_lookup.count(key) > 0) {
+			std::cout << "ERROR: Asset " << pathId << " is already part of the registry" << std::endl;
+			return AssetHandle<T>();
+		}
+
+		unsigned int index;
+		if (!this->m_freeSlots.empty()) {
+			index = this->m_freeSlots.back();
+			this->m_freeSlots.pop_back();
+		}
+		else {
+			index = this->m_slots.size();
+			this->m_slots.push_back(Slot());
+		}
+
+		Slot& slot = this->m_slots[index];
+		slot.asset = asset;
+		slot.referenceCount = 0;
+		slot.key = key;
+		this->m_lookup.insert({ key, index });
+
+		return AssetHandle<T>{ index, slot.generation };
+	}
+
+	/**
+	 * Resolve a handle
+	 * @param handle							Handle of the asset
+	 * @return T*								Asset, nullptr if the handle is stale or invalid
+	 */
+	T* Get(const AssetHandle<T>& handle) const {
+		return this->IsAlive(handle) ? this->m_slots[handle.index].asset : nullptr;
+	}
+
+	/**
+	 * Add a reference to an asset
+	 * @param handle							Handle of the asset
+	 */
+	void Acquire(const AssetHandle<T>& handle) {
+		if (this->IsAlive(handle)) {
+			this->m_slots[handle.index].referenceCount++;
+		}
+	}
+
+	/**
+	 * Drop a reference to an asset, a stale handle is ignored
+	 * @param handle							Handle of the asset
+	 */
+	void Release(const AssetHandle<T>& handle) {
+		if (this->IsAlive(handle) && this->m_slots[handle.index].referenceCount > 0) {
+			this->m_slots[handle.index].referenceCount--;
+		}
+	}
+
+	/**
+	 * Unload an asset nothing references anymore, every handle to it becomes stale
+	 * @param handle							Handle of the asset
+	 * @return bool								false if the handle is stale or the asset is still referenced
+	 */
+	bool Unload(const AssetHandle<T>& handle) {
+		if (!this->IsAlive(handle)) {
+			return false;
+		}
+		if (this->m_slots[handle.index].referenceCount > 0) {
+			std::cout << "ERROR: Asset can't be unloaded while it's still referenced" << std::endl;
+			return false;
+		}
+
+		this->UnloadSlot(handle.index);
+		return true;
+	}
+
+	/**
+	 * Unload every asset without references
+	 * @return unsigned int						Number of assets that were unloaded
+	 */
+	unsigned int UnloadUnused() {
+		unsigned int unloaded = 0;
+		for (unsigned int i = 0; i < this->m_slots.size(); i++) {
+			if (this->m_slots[i].asset != nullptr && this->m_slots[i].referenceCount == 0) {
+				this->UnloadSlot(i);
+				unloaded++;
+			}
+		}
+		return unloaded;
+	}
+
+	/**
+	 * Unload every asset, referenced or not
+	 */
+	void UnloadAll() {
+		for (unsigned int i = 0; i < this->m_slots.size(); i++) {
+			if (this->m_slots[i].asset != nullptr) {
+				this->UnloadSlot(i);
+			}
+		}
+	}
+
+private:
+	static unsigned long long MakeKey(const unsigned int& pathId, const unsigned int& subType) {
+		return ((unsigned long long)pathId << 32) | subType;
+	}
+
+	inline bool IsAlive(const AssetHandle<T>& handle) const {
+		return handle.index < this->m_slots.size()
+			&& this->m_slots[handle.index].generation == handle.generation
+			&& this->m_slots[handle.index].asset != nullptr;
+	}
+
+	void UnloadSlot(const unsigned int& index) {
+		Slot& slot = this->m_slots[index];
+		this->m_unloader(slot.asset);
+		this->m_lookup.erase(slot.key);
+
+		slot.asset = nullptr;
+		slot.referenceCount = 0;
+		slot.generation++;
+		this->m_freeSlots.push_back(index);
+	}
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline unsigned int GetLoadedCount() const { return this->m_lookup.size(); }
+	inline unsigned int GetReferenceCount(const AssetHandle<T>& handle) const {
+		return this->IsAlive(handle) ? this->m_slots[handle.index].referenceCount : 0;
+	}
+};
\ No newline at end of file
@@ -1,7 +1,9 @@
 #include "GameObject.h"
+#include "../Utils/RenderQueue.h"
 
 GameObject::GameObject() {
 	this->m_transform = new Transform();
+	this->m_transform->AttachToPool();
 	this->m_mesh.push_back(new Mesh());
 }
 
@@ -15,12 +17,17 @@ GameObject::GameObject(
 	const ObjectType& objectType
 ) {
 	this->m_transform = transform;
+	this->m_transform->AttachToPool();
 	this->m_importedFileName = meshFilePath;
-	this->m_mesh = AssetManager::s_assetManager->LoadMesh(meshFilePath, true, false, movementState, importedColour);
+
+	// A cube stands in for the model while it's being loaded
+	this->m_mesh.push_back(AssetManager::s_assetManager->CreatePlaceholderMesh(movementState, importedColour));
 
 	this->m_objectType = objectType;
 
-	this->SetRigidBodyProperties(mass, physicsEnabled);
+	// No shape is built around the placeholder, the body is held until the model is loaded
+	this->SetRigidBodyProperties(mass, false);
+	this->m_physicsEnabledOnLoad = physicsEnabled;
 
 	// Change the type of the rigid body
 	switch (movementState) {
@@ -32,6 +39,11 @@ GameObject::GameObject(
 		break;
 	}
 	this->SetMaterialProperties();
+
+	// A model that was already loaded replaces the placeholder right away and no request is kept
+	this->m_rigidBody->setIsActive(false);
+	this->m_meshRequest = AssetManager::s_assetManager->LoadMeshAsync(meshFilePath, true, false, movementState, importedColour,
+		[this](const std::vector<Mesh*>& meshes) { this->OnMeshesLoaded(meshes); });
 }
 
 GameObject::GameObject(
@@ -42,6 +54,7 @@ GameObject::GameObject(
 	const ObjectType& objectType
 ) {
 	this->m_transform = transform;
+	this->m_transform->AttachToPool();
 	this->m_mesh = mesh;
 
 	this->m_objectType = objectType;
@@ -63,11 +76,10 @@ GameObject::GameObject(
 void GameObject::DrawMesh()
 {
 	if (this->m_active) {
-		for (Mesh* m : this->m_mesh) {
-			m->GetMeshMaterial()->BindMaterial(*this->m_transform);
-			m->DrawMesh();
-			m->GetMeshMaterial()->UnbindMaterial();
-		}
+		// Single objects go through the same instanced path as the scene
+		RenderQueue::s_immediateQueue->Clear();
+		RenderQueue::s_immediateQueue->PushGameObject(this, Camera::s_camera->GetCurrentActiveTransform()->GetPos());
+		RenderQueue::s_immediateQueue->Submit();
 	}
 }
 
@@ -86,10 +98,14 @@ void GameObject::Update() {
 
 	// Dont need to rotate as the character is currently moving 
 	// only on x-z axis with the jump ability too
-	// --- this->m_transform->SetRot(tempValues.GetRot());
+	// --- this->m_transform->SetOrientation(tempValues.GetOrientation());
 }
 
 GameObject::~GameObject() {
+	if (this->m_meshRequest != 0 && AssetManager::s_assetManager != nullptr) {
+		AssetManager::s_assetManager->CancelMeshLoad(this->m_meshRequest);
+	}
+
 	for (Mesh* m : this->m_mesh) {
 		delete m;
 	}
@@ -138,3 +154,16 @@ void GameObject::OnPlayerMoveRight() {
 void GameObject::OnPlayerMoveLeft() {
 	this->m_rigidBody->applyForceToCenterOfMass(rp3d::Vector3(this->m_playerSpeed, 0.0, 0.0));
 }
+
+void GameObject::OnMeshesLoaded(const std::vector<Mesh*>& meshes) {
+	this->m_meshRequest = 0;
+
+	for (Mesh* m : this->m_mesh) {
+		delete m;
+	}
+	this->SetMeshes(meshes);
+
+	// The body joins the world before its shape is added so the shape reaches the broad phase once
+	this->m_rigidBody->setIsActive(true);
+	this->SetPhysicsEnabled(this->m_physicsEnabledOnLoad);
+}
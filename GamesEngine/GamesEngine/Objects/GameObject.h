@@ -25,12 +25,27 @@ private:
 	// Check if the object is imported or not
 	std::string m_importedFileName = "";
 
+	// Request of the imported meshes while the placeholder is drawn, 0 once they're loaded
+	unsigned int m_meshRequest = 0;
+
+	// Whether the collision shape is built once the imported meshes are loaded, the body
+	// stays out of the physics world until then
+	bool m_physicsEnabledOnLoad = false;
+
 	// Active state of the gameObject
 	bool m_active = true;
 
+	// Drawn through the merged meshes of the scene static batch
+	bool m_staticBatched = false;
+
 	// Game object type
 	ObjectType m_objectType;
 
+	// World space bounds of all the meshes and the transform version they were built from
+	BoundingBox m_worldBounds;
+	unsigned int m_boundsVersion = 0;
+	bool m_boundsValid = false;
+
 public:
 	static CollisionCategory ConvertObjectTypeToCollision(const ObjectType& objType) {
 		switch (objType) {
@@ -98,6 +113,13 @@ public:
 	void OnPlayerMoveRight();
 	void OnPlayerMoveLeft();
 
+	/**
+	 * Replace the placeholder with the meshes of the imported file once they're loaded,
+	 * the collision shape is rebuilt around them
+	 * @param meshes							Meshes of the file, empty if it couldn't be loaded
+	 */
+	void OnMeshesLoaded(const std::vector<Mesh*>& meshes);
+
 	/**
 	 * Getters and setters
 	 */
@@ -105,18 +127,48 @@ public:
 	inline const std::vector<Mesh*>& GetMeshes() { return this->m_mesh; }
 	inline Mesh* GetMeshById(const int& meshId) { return this->m_mesh[meshId]; }
 	inline Transform* GetTransform() const { return this->m_transform; }
+	inline const TransformHandle& GetTransformHandle() const { return this->m_transform->GetPoolHandle(); }
+	inline const BoundingBox& GetWorldBounds() {
+		// Only rebuild the bounds when the transform changed since the last time
+		if (!this->m_boundsValid || this->m_boundsVersion != this->m_transform->GetVersion()) {
+			BoundingBox localBounds;
+			for (Mesh* mesh : this->m_mesh) {
+				localBounds.AddBox(mesh->GetLocalBounds());
+			}
+			this->m_worldBounds = localBounds.Transformed(this->m_transform->GetModelMatrix());
+			this->m_boundsVersion = this->m_transform->GetVersion();
+			this->m_boundsValid = true;
+		}
+		return this->m_worldBounds;
+	}
 	inline const std::string& GetFileName() const { return this->m_importedFileName; }
 	inline const bool& GetIsActive() const { return this->m_active; }
+	inline const bool& GetIsStaticBatched() const { return this->m_staticBatched; }
 	inline const bool& GetIsImported() const { return this->m_importedFileName != ""; }
+	inline bool GetIsLoading() const { return this->m_meshRequest != 0; }
 	inline rp3d::RigidBody* GetRigidBody() { return this->m_rigidBody; }
 	inline rp3d::BoxShape* GetCollisionBox() { return this->m_collisionBox; }
 	inline rp3d::SphereShape* GetCollisionSphere() { return this->m_collisionSphere; }
 	inline const ObjectType& GetObjectType() const { return this->m_objectType; }
 
-	inline void SetMeshes(const std::vector<Mesh*>& newMeshes) { this->m_mesh = newMeshes; }
-	inline void SetTransform(Transform* newTransform) { this->m_transform = newTransform; }
+	inline void SetMeshes(const std::vector<Mesh*>& newMeshes) { 
+		// Meshes set directly win over the ones that are still loading
+		if (this->m_meshRequest != 0) {
+			AssetManager::s_assetManager->CancelMeshLoad(this->m_meshRequest);
+			this->m_meshRequest = 0;
+			this->m_rigidBody->setIsActive(true);
+		}
+		this->m_mesh = newMeshes; 
+		this->m_boundsValid = false;
+	}
+	inline void SetTransform(Transform* newTransform) { 
+		this->m_transform = newTransform; 
+		this->m_transform->AttachToPool();
+		this->m_boundsValid = false;
+	}
 	inline void SetFilePath(const std::string& newFilePath) { this->m_importedFileName = newFilePath; }
 	inline void SetActiveState(const bool& newActiveState) { this->m_active = newActiveState; }
+	inline void SetStaticBatched(const bool& newStaticBatched) { this->m_staticBatched = newStaticBatched; }
 	inline void SetObjectType(const ObjectType& newType) { this->m_objectType = newType; }
 	inline void SetBodyMass(const float& newMass) { this->m_rigidBody->setMass(rp3d::decimal(newMass)); }
 
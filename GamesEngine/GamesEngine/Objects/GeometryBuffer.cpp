@@ -0,0 +1,196 @@
+#include "GeometryBuffer.h"
+#include "Mesh.h"
+#include "../Utils/GLStateCache.h"
+
+GeometryBuffer* GeometryBuffer::s_geometryBuffer = new GeometryBuffer();
+
+GeometryBuffer::~GeometryBuffer()
+{
+	for (LayoutPool& pool : this->m_pools) {
+		GLStateCache::s_stateCache->OnVertexArrayDeleted(pool.vertexArrayObject);
+		GLStateCache::s_stateCache->OnBufferDeleted(pool.vertexBuffer);
+		GLStateCache::s_stateCache->OnBufferDeleted(pool.indexBuffer);
+		glDeleteVertexArrays(1, &pool.vertexArrayObject);
+		glDeleteBuffers(1, &pool.vertexBuffer);
+		glDeleteBuffers(1, &pool.indexBuffer);
+	}
+	this->m_pools.clear();
+}
+
+GeometryBuffer::Allocation GeometryBuffer::Allocate(const unsigned int& vertexLayout, const void* vertexData, const unsigned int& vertexCount, const unsigned int* indices, const unsigned int& indexCount)
+{
+	Allocation allocation;
+	if (vertexCount == 0 || indexCount == 0) {
+		return allocation;
+	}
+
+	allocation.poolIndex = this->GetPool(vertexLayout);
+	LayoutPool& pool = this->m_pools[allocation.poolIndex];
+
+	if (!GeometryBuffer::TakeRange(pool.freeVertices, vertexCount, allocation.baseVertex)) {
+		this->GrowVertices(pool, vertexCount);
+		GeometryBuffer::TakeRange(pool.freeVertices, vertexCount, allocation.baseVertex);
+	}
+	if (!GeometryBuffer::TakeRange(pool.freeIndices, indexCount, allocation.firstIndex)) {
+		this->GrowIndices(pool, indexCount);
+		GeometryBuffer::TakeRange(pool.freeIndices, indexCount, allocation.firstIndex);
+	}
+
+	allocation.vertexCount = vertexCount;
+	allocation.indexCount = indexCount;
+
+	// The indices stay relative to the mesh, the base vertex is added when drawing
+	GLStateCache::s_stateCache->BindBuffer(GL_ARRAY_BUFFER, pool.vertexBuffer);
+	glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)allocation.baseVertex * pool.stride, (GLsizeiptr)vertexCount * pool.stride, vertexData);
+	GLStateCache::s_stateCache->BindBuffer(GL_ARRAY_BUFFER, 0);
+
+	GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, pool.indexBuffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)allocation.firstIndex * sizeof(unsigned int), (GLsizeiptr)indexCount * sizeof(unsigned int), indices);
+	GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	return allocation;
+}
+
+void GeometryBuffer::Free(Allocation& allocation)
+{
+	if (allocation.poolIndex == GeometryBuffer::INVALID_POOL) {
+		return;
+	}
+
+	LayoutPool& pool = this->m_pools[allocation.poolIndex];
+	GeometryBuffer::ReleaseRange(pool.freeVertices, allocation.baseVertex, allocation.vertexCount);
+	GeometryBuffer::ReleaseRange(pool.freeIndices, allocation.firstIndex, allocation.indexCount);
+
+	allocation = Allocation();
+}
+
+unsigned int GeometryBuffer::GetPool(const unsigned int& vertexLayout)
+{
+	for (unsigned int i = 0; i < this->m_pools.size(); i++) {
+		if (this->m_pools[i].vertexLayout == vertexLayout) {
+			return i;
+		}
+	}
+
+	LayoutPool pool;
+	pool.vertexLayout = vertexLayout;
+	pool.stride = Mesh::GetVertexStride(vertexLayout);
+	pool.vertexCapacity = GeometryBuffer::INITIAL_VERTEX_CAPACITY;
+	pool.indexCapacity = GeometryBuffer::INITIAL_INDEX_CAPACITY;
+	pool.freeVertices.push_back({ 0, pool.vertexCapacity });
+	pool.freeIndices.push_back({ 0, pool.indexCapacity });
+
+	glGenVertexArrays(1, &pool.vertexArrayObject);
+	glGenBuffers(1, &pool.vertexBuffer);
+	glGenBuffers(1, &pool.indexBuffer);
+
+	GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, pool.vertexBuffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)pool.vertexCapacity * pool.stride, nullptr, GL_DYNAMIC_DRAW);
+	GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, pool.indexBuffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)pool.indexCapacity * sizeof(unsigned int), nullptr, GL_DYNAMIC_DRAW);
+	GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	// The attribute formats are described once for every mesh of the layout
+	GLStateCache::s_stateCache->BindVertexArray(pool.vertexArrayObject);
+	Mesh::SetVertexAttributes(vertexLayout);
+	Mesh::SetInstanceAttributes();
+	glBindVertexBuffer(GeometryBuffer::VERTEX_BUFFER_BINDING, pool.vertexBuffer, 0, pool.stride);
+	GLStateCache::s_stateCache->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.indexBuffer);
+	GLStateCache::s_stateCache->BindVertexArray(0);
+
+	this->m_pools.push_back(pool);
+	return this->m_pools.size() - 1;
+}
+
+bool GeometryBuffer::TakeRange(std::vector<FreeRange>& freeRanges, const unsigned int& count, unsigned int& offset)
+{
+	for (unsigned int i = 0; i < freeRanges.size(); i++) {
+		if (freeRanges[i].count >= count) {
+			offset = freeRanges[i].offset;
+			freeRanges[i].offset += count;
+			freeRanges[i].count -= count;
+
+			if (freeRanges[i].count == 0) {
+				freeRanges.erase(freeRanges.begin() + i);
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+void GeometryBuffer::ReleaseRange(std::vector<FreeRange>& freeRanges, const unsigned int& offset, const unsigned int& count)
+{
+	if (count == 0) {
+		return;
+	}
+
+	// The ranges are kept sorted by offset so the neighbours are next to each other
+	unsigned int i = 0;
+	while (i < freeRanges.size() && freeRanges[i].offset < offset) {
+		i++;
+	}
+	freeRanges.insert(freeRanges.begin() + i, { offset, count });
+
+	if (i + 1 < freeRanges.size() && freeRanges[i].offset + freeRanges[i].count == freeRanges[i + 1].offset) {
+		freeRanges[i].count += freeRanges[i + 1].count;
+		freeRanges.erase(freeRanges.begin() + i + 1);
+	}
+	if (i > 0 && freeRanges[i - 1].offset + freeRanges[i - 1].count == freeRanges[i].offset) {
+		freeRanges[i - 1].count += freeRanges[i].count;
+		freeRanges.erase(freeRanges.begin() + i);
+	}
+}
+
+void GeometryBuffer::GrowBuffer(GLuint& buffer, const size_t& oldSize, const size_t& newSize)
+{
+	GLuint newBuffer;
+	glGenBuffers(1, &newBuffer);
+
+	GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, newSize, nullptr, GL_DYNAMIC_DRAW);
+
+	// Copy on the GPU so the meshes already placed don't have to be uploaded again
+	GLStateCache::s_stateCache->BindBuffer(GL_COPY_READ_BUFFER, buffer);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSize);
+
+	GLStateCache::s_stateCache->BindBuffer(GL_COPY_READ_BUFFER, 0);
+	GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	GLStateCache::s_stateCache->OnBufferDeleted(buffer);
+	glDeleteBuffers(1, &buffer);
+	buffer = newBuffer;
+}
+
+void GeometryBuffer::GrowVertices(LayoutPool& pool, const unsigned int& count)
+{
+	unsigned int newCapacity = pool.vertexCapacity;
+	while (newCapacity - pool.vertexCapacity < count) {
+		newCapacity *= 2;
+	}
+
+	GeometryBuffer::GrowBuffer(pool.vertexBuffer, (size_t)pool.vertexCapacity * pool.stride, (size_t)newCapacity * pool.stride);
+	GeometryBuffer::ReleaseRange(pool.freeVertices, pool.vertexCapacity, newCapacity - pool.vertexCapacity);
+	pool.vertexCapacity = newCapacity;
+
+	GLStateCache::s_stateCache->BindVertexArray(pool.vertexArrayObject);
+	glBindVertexBuffer(GeometryBuffer::VERTEX_BUFFER_BINDING, pool.vertexBuffer, 0, pool.stride);
+	GLStateCache::s_stateCache->BindVertexArray(0);
+}
+
+void GeometryBuffer::GrowIndices(LayoutPool& pool, const unsigned int& count)
+{
+	unsigned int newCapacity = pool.indexCapacity;
+	while (newCapacity - pool.indexCapacity < count) {
+		newCapacity *= 2;
+	}
+
+	GeometryBuffer::GrowBuffer(pool.indexBuffer, (size_t)pool.indexCapacity * sizeof(unsigned int), (size_t)newCapacity * sizeof(unsigned int));
+	GeometryBuffer::ReleaseRange(pool.freeIndices, pool.indexCapacity, newCapacity - pool.indexCapacity);
+	pool.indexCapacity = newCapacity;
+
+	// The element buffer is part of the VAO state
+	GLStateCache::s_stateCache->BindVertexArray(pool.vertexArrayObject);
+	GLStateCache::s_stateCache->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.indexBuffer);
+	GLStateCache::s_stateCache->BindVertexArray(0);
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Shared vertex and index storage of every mesh, the meshes with the same vertex layout
+ * live inside the same pair of buffers and share one VAO so a whole material bucket
+ * can be drawn with a single multi draw indirect call
+ */
+class GeometryBuffer {
+public:
+	/**
+	 * Range of a mesh inside the buffers of a pool
+	 */
+	struct Allocation {
+		unsigned int poolIndex = GeometryBuffer::INVALID_POOL;
+		unsigned int baseVertex = 0;
+		unsigned int vertexCount = 0;
+		unsigned int firstIndex = 0;
+		unsigned int indexCount = 0;
+	};
+
+	static const unsigned int INVALID_POOL = 0xFFFFFFFF;
+
+	// Binding point of the shared vertex buffer inside the VAO of a pool
+	static const GLuint VERTEX_BUFFER_BINDING = 0;
+
+	// Capacity a pool starts with, doubled every time it runs out of space
+	static const unsigned int INITIAL_VERTEX_CAPACITY = 1 << 16;
+	static const unsigned int INITIAL_INDEX_CAPACITY = 1 << 18;
+
+private:
+	/**
+	 * Free block of vertices or indices inside a pool
+	 */
+	struct FreeRange {
+		unsigned int offset;
+		unsigned int count;
+	};
+
+	/**
+	 * Buffers shared by all the meshes with the same vertex layout
+	 */
+	struct LayoutPool {
+		unsigned int vertexLayout;
+		unsigned int stride;
+
+		GLuint vertexArrayObject = 0;
+		GLuint vertexBuffer = 0;
+		GLuint indexBuffer = 0;
+
+		unsigned int vertexCapacity = 0;
+		unsigned int indexCapacity = 0;
+
+		std::vector<FreeRange> freeVertices;
+		std::vector<FreeRange> freeIndices;
+	};
+
+	std::vector<LayoutPool> m_pools;
+
+public:
+	static GeometryBuffer* s_geometryBuffer;
+
+	GeometryBuffer() {}
+	~GeometryBuffer();
+
+	/**
+	 * Copy the geometry of a mesh inside the pool of its layout
+	 * @param vertexLayout						Mask of VertexAttribute values of the vertex data
+	 * @param vertexData						Vertices already packed following the layout
+	 * @param vertexCount						Number of vertices
+	 * @param indices							Indices relative to the first vertex of the mesh
+	 * @param indexCount						Number of indices
+	 * @return Allocation						Range the mesh was placed in
+	 */
+	Allocation Allocate(const unsigned int& vertexLayout, const void* vertexData, const unsigned int& vertexCount, const unsigned int* indices, const unsigned int& indexCount);
+
+	/**
+	 * Give back the range of a mesh so it can be reused by the next allocations
+	 * @param allocation						Range returned by Allocate
+	 */
+	void Free(Allocation& allocation);
+
+private:
+	/**
+	 * Find the pool of a vertex layout or create it with the initial capacity
+	 * @param vertexLayout						Mask of VertexAttribute values
+	 * @return unsigned int						Index of the pool
+	 */
+	unsigned int GetPool(const unsigned int& vertexLayout);
+
+	/**
+	 * Take a block from the free ranges of a pool, first fit
+	 * @param freeRanges						Free ranges of the buffer
+	 * @param count								Number of elements that are needed
+	 * @param offset							Start of the block that was found
+	 * @return bool								false if no free range is big enough
+	 */
+	static bool TakeRange(std::vector<FreeRange>& freeRanges, const unsigned int& count, unsigned int& offset);
+
+	/**
+	 * Return a block to the free ranges and merge it with its neighbours
+	 * @param freeRanges						Free ranges of the buffer
+	 * @param offset							Start of the block
+	 * @param count								Number of elements in the block
+	 */
+	static void ReleaseRange(std::vector<FreeRange>& freeRanges, const unsigned int& offset, const unsigned int& count);
+
+	/**
+	 * Move a buffer into a bigger one keeping its content
+	 * @param buffer							Buffer that is replaced
+	 * @param oldSize							Size in bytes of the content
+	 * @param newSize							Size in bytes of the new buffer
+	 */
+	static void GrowBuffer(GLuint& buffer, const size_t& oldSize, const size_t& newSize);
+
+	/**
+	 * Double the vertex storage of a pool until the requested count fits
+	 * @param pool								Pool that runs out of vertices
+	 * @param count								Number of vertices that have to fit
+	 */
+	void GrowVertices(LayoutPool& pool, const unsigned int& count);
+
+	/**
+	 * Double the index storage of a pool until the requested count fits
+	 * @param pool								Pool that runs out of indices
+	 * @param count								Number of indices that have to fit
+	 */
+	void GrowIndices(LayoutPool& pool, const unsigned int& count);
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline GLuint GetVertexArrayObject(const unsigned int& poolIndex) const { return this->m_pools[poolIndex].vertexArrayObject; }
+	inline unsigned int GetPoolCount() const { return this->m_pools.size(); }
+};
@@ -1,103 +1,214 @@
 #include "Material.h"
+#include "../Utils/RingBuffer.h"
+#include "../Utils/GLStateCache.h"
+#include "../Utils/Hash.h"
+#include "../Shaders/ShaderLibrary.h"
+#include "AssetManager.h"
+#include <algorithm>
 
-void Material::BindMaterial(const Transform& go_transform)
+unsigned int Material::s_materialCount = 0;
+
+const char* Material::s_featureDefines[MaterialFeature::NUMBER_FEATURES] = {
+	"HAS_DIFFUSE_MAP",
+	"HAS_SPECULAR_MAP",
+	"HAS_NORMAL_MAP",
+	"HAS_EMISSION_MAP",
+	"HAS_VERTEX_COLOUR"
+};
+
+Material::Material(const std::vector<Texture*>& textures, const std::shared_ptr<Shader>& shader)
+	: m_shader(shader), m_textures(textures), m_materialId(s_materialCount++)
+{
+	Material::AcquireTextures(this->m_textures);
+	this->ResolveTextureUnits();
+}
+
+Material::~Material()
+{
+	/* The ShaderLibrary owns the program and the AssetManager the textures, the material only drops its references */
+	Material::ReleaseTextures(this->m_textures);
+}
+
+void Material::SetTextures(const std::vector<Texture*>& newTextures)
+{
+	// Acquire first so a texture kept by the new set never drops to no references
+	Material::AcquireTextures(newTextures);
+	Material::ReleaseTextures(this->m_textures);
+
+	this->m_textures = newTextures;
+	this->ResolveTextureUnits();
+}
+
+void Material::AcquireTextures(const std::vector<Texture*>& textures)
+{
+	// The materials destroyed after the AssetManager don't own anything anymore
+	if (AssetManager::s_assetManager == nullptr)
+		return;
+
+	for (Texture* texture : textures)
+		AssetManager::s_assetManager->AcquireTexture(texture);
+}
+
+void Material::ReleaseTextures(const std::vector<Texture*>& textures)
+{
+	if (AssetManager::s_assetManager == nullptr)
+		return;
+
+	for (Texture* texture : textures)
+		AssetManager::s_assetManager->ReleaseTexture(texture);
+}
+
+void Material::BindMaterial()
 {
 	this->m_shader->BindShader();
 
-	this->m_shader->UpdateShader(go_transform, *Camera::s_camera, 0);
-
-	if (this->m_shader->GetShaderType() == ShaderType::EMPTY) {
-		for (unsigned int i = 0; i < this->m_textures.size(); i++)
-		{
-			this->m_textures[i]->BindTexture(i);
-			switch (this->m_textures[i]->GetTextureType())
-			{
-			case TextureType::DIFFUSE:
-				glUniform1f(
-					glGetUniformLocation(this->m_shader->GetProgramID(),
-						"materialMap.diffuseMap"), i);
-				break;
-			}
-		}
+	Material::BindMaterialData(this->WriteMaterialData());
+
+	for (unsigned int i = 0; i < Shader::NUMBER_TEXTURE_UNITS; i++)
+	{
+		if (this->m_unitTextures[i] != nullptr)
+			this->m_unitTextures[i]->BindTexture(i);
 	}
-	else if (this->m_shader->GetShaderType() == ShaderType::FLAT)
+}
+
+GLintptr Material::WriteMaterialData() const
+{
+	MaterialDataBlock materialData = {};
+	materialData.diffuseColour = glm::vec4(this->m_diffuseColour, 1.0f);
+	materialData.specularColour = glm::vec4(this->m_specularColour, 1.0f);
+	materialData.emissionColour = glm::vec4(this->m_emissionColour, 1.0f);
+	materialData.shininess = this->m_shininess;
+
+	return RingBuffer::s_frameRingBuffer->Write(&materialData, sizeof(MaterialDataBlock), RingBuffer::s_frameRingBuffer->GetUniformAlignment());
+}
+
+void Material::BindMaterialData(const GLintptr& offset)
+{
+	GLStateCache::s_stateCache->BindBufferRange(GL_UNIFORM_BUFFER, Shader::MATERIAL_DATA_BINDING, RingBuffer::s_frameRingBuffer->GetBuffer(), offset, sizeof(MaterialDataBlock));
+}
+
+void Material::UnbindMaterial()
+{
+	this->m_shader->UnbindShader();
+
+	for (unsigned int i = 0; i < Shader::NUMBER_TEXTURE_UNITS; i++)
 	{
-		glUniform3f(
-			glGetUniformLocation(this->m_shader->GetProgramID(),
-				"materialProperties.diffuseColour"), this->m_diffuseColour.x, this->m_diffuseColour.y, this->m_diffuseColour.z);
-
-		for (unsigned int i = 0; i < this->m_textures.size(); i++)
-		{
-			this->m_textures[i]->BindTexture(i);
-			switch (this->m_textures[i]->GetTextureType())
-			{
-			case TextureType::DIFFUSE:
-				glUniform1f(
-					glGetUniformLocation(this->m_shader->GetProgramID(),
-						"materialMap.diffuseMap"), i);
-				break;
-			}
-		}
+		if (this->m_unitTextures[i] != nullptr)
+			this->m_unitTextures[i]->UnbindTexture(i);
 	}
-	else if (this->m_shader->GetShaderType() == ShaderType::PHONG)
+}
+
+void Material::ResolveTextureUnits()
+{
+	// Without a texture of their own the samplers keep reading the first texture as before
+	Texture* fallbackTexture = this->m_textures.empty() ? nullptr : this->m_textures[0];
+	for (unsigned int i = 0; i < Shader::NUMBER_TEXTURE_UNITS; i++)
 	{
-		glUniform3f(
-			glGetUniformLocation(this->m_shader->GetProgramID(), 
-				"material.diffuseColour"), this->m_diffuseColour.x, this->m_diffuseColour.y, this->m_diffuseColour.z);
-
-		glUniform3f(
-			glGetUniformLocation(this->m_shader->GetProgramID(),
-				"material.specularColour"), this->m_specularColour.x, this->m_specularColour.y, this->m_specularColour.z);
-
-		glUniform3f(
-			glGetUniformLocation(this->m_shader->GetProgramID(),
-				"material.emissionColour"), this->m_emissionColour.x, this->m_emissionColour.y, this->m_emissionColour.z);
-
-		glUniform1f(
-			glGetUniformLocation(this->m_shader->GetProgramID(),
-				"material.shininess"), this->m_shininess);
-
-		for (unsigned int i = 0; i < this->m_textures.size(); i++)
-		{
-			this->m_textures[i]->BindTexture(i);
-			switch (this->m_textures[i]->GetTextureType())
-			{
-			case TextureType::DIFFUSE:
-				glUniform1f(
-					glGetUniformLocation(this->m_shader->GetProgramID(),
-						"material.diffuseMap"), i);
-				break;
-			case TextureType::SPECULAR:
-				glUniform1f(
-					glGetUniformLocation(this->m_shader->GetProgramID(),
-						"material.specularMap"), i);
-				break;
-			case TextureType::BUMP:
-				glUniform1f(
-					glGetUniformLocation(this->m_shader->GetProgramID(),
-						"material.bumpMap"), i);
-				break;
-
-			default:
-				std::cout << "ERROR: The texture could not be loaded" << std::endl;
-				break;
-			}
-		}
+		this->m_unitTextures[i] = fallbackTexture;
 	}
-	else
+
+	for (Texture* texture : this->m_textures)
 	{
-		std::cout << "ERROR: Unable to bind the textures! Please check the Shader's Uniforms! Shader Type: {0}", this->m_shader->GetShaderType();
+		if (texture == nullptr)
+			continue;
+
+		int textureUnit = Shader::GetTextureUnit(texture->GetTextureType());
+		if (textureUnit != -1)
+			this->m_unitTextures[textureUnit] = texture;
+		else
+			std::cout << "ERROR: The texture could not be loaded" << std::endl;
 	}
+
+	// Only the diffuse unit keeps sampling the fallback, the other maps are off without a texture of their own
+	const MaterialFeature unitFeatures[Shader::NUMBER_TEXTURE_UNITS] = {
+		MaterialFeature::FEATURE_DIFFUSE_MAP,
+		MaterialFeature::FEATURE_SPECULAR_MAP,
+		MaterialFeature::FEATURE_NORMAL_MAP,
+		MaterialFeature::FEATURE_EMISSION_MAP
+	};
+
+	for (unsigned int i = 0; i < Shader::NUMBER_TEXTURE_UNITS; i++)
+	{
+		bool hasMap = this->m_unitTextures[i] != nullptr
+			&& (i == Shader::DIFFUSE_UNIT || this->m_unitTextures[i] != fallbackTexture || Shader::GetTextureUnit(fallbackTexture->GetTextureType()) == (int)i);
+
+		this->m_features = hasMap ? this->m_features | unitFeatures[i] : this->m_features & ~unitFeatures[i];
+	}
+
+	this->ResolveShaderVariant();
 }
 
-void Material::UnbindMaterial()
+void Material::ResolveShaderVariant()
 {
-	this->m_shader->UnbindShader();
+	if (this->m_shader == nullptr)
+		return;
+
+	std::vector<std::string> defines = Material::GetFeatureDefines(this->m_features & Material::GetSupportedFeatures(this->m_shader->GetShaderType()));
+	if (defines != this->m_shader->GetDefines())
+		this->m_shader = ShaderLibrary::s_shaderLibrary->GetShader(this->m_shader->GetShaderType(), defines);
+}
+
+unsigned int Material::GetSupportedFeatures(const ShaderType& shaderType)
+{
+	switch (shaderType) {
+	case ShaderType::PHONG:
+		return MaterialFeature::FEATURE_DIFFUSE_MAP | MaterialFeature::FEATURE_SPECULAR_MAP | MaterialFeature::FEATURE_NORMAL_MAP
+			| MaterialFeature::FEATURE_EMISSION_MAP | MaterialFeature::FEATURE_VERTEX_COLOUR;
+	default:
+		return MaterialFeature::FEATURE_DIFFUSE_MAP | MaterialFeature::FEATURE_VERTEX_COLOUR;
+	}
+}
 
-	for (unsigned int i = 0; i < this->m_textures.size(); i++)
+std::vector<std::string> Material::GetFeatureDefines(const unsigned int& features)
+{
+	// Sorted the same way the library hands them to the program so they can be compared
+	std::vector<std::string> defines;
+	for (unsigned int i = 0; i < MaterialFeature::NUMBER_FEATURES; i++)
 	{
-		Texture* texture = this->m_textures[i];
-		if (texture)
-			texture->UnbindTexture(i);
+		if (features & (1 << i))
+			defines.push_back(Material::s_featureDefines[i]);
 	}
+	std::sort(defines.begin(), defines.end());
+
+	return defines;
+}
+
+bool Material::HasSameState(const Material& other) const
+{
+	if (this == &other)
+		return true;
+
+	if (this->m_shader != other.m_shader
+		|| this->m_diffuseColour != other.m_diffuseColour
+		|| this->m_specularColour != other.m_specularColour
+		|| this->m_emissionColour != other.m_emissionColour
+		|| this->m_shininess != other.m_shininess)
+		return false;
+
+	for (unsigned int i = 0; i < Shader::NUMBER_TEXTURE_UNITS; i++)
+	{
+		if (this->m_unitTextures[i] != other.m_unitTextures[i])
+			return false;
+	}
+
+	return true;
+}
+
+uint64_t Material::GetStateHash() const
+{
+	// 64bit FNV-1a over the raw values compared by HasSameState
+	uint64_t hash = Hash::FNV_OFFSET_BASIS;
+	auto hashBytes = [&hash](const void* data, size_t size) {
+		hash = Hash::Fnv1a(data, size, hash);
+	};
+
+	const Shader* shader = this->m_shader.get();
+	hashBytes(&shader, sizeof(shader));
+	hashBytes(this->m_unitTextures, sizeof(this->m_unitTextures));
+	hashBytes(&this->m_diffuseColour, sizeof(glm::vec3));
+	hashBytes(&this->m_specularColour, sizeof(glm::vec3));
+	hashBytes(&this->m_emissionColour, sizeof(glm::vec3));
+	hashBytes(&this->m_shininess, sizeof(float));
+
+	return hash;
 }
\ No newline at end of file
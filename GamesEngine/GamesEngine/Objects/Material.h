@@ -1,53 +1,172 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <memory>
+#include <cstdint>
+#include <string>
+#include <vector>
 #include "../Shaders/Shader.h"
 #include "Texture.h"
 
+/**
+ * Mirror of the MaterialData uniform block read by the shaders ( std140 layout )
+ */
+struct MaterialDataBlock {
+	glm::vec4 diffuseColour;
+	glm::vec4 specularColour;
+	glm::vec4 emissionColour;
+	float shininess;
+	float padding[3];
+};
+
+/**
+ * Inputs a material actually has, every feature turns into a define of the shader variant
+ * the material is drawn with so the program only samples and computes what is there
+ */
+enum MaterialFeature {
+	FEATURE_DIFFUSE_MAP = 1 << 0,
+	FEATURE_SPECULAR_MAP = 1 << 1,
+	FEATURE_NORMAL_MAP = 1 << 2,
+	FEATURE_EMISSION_MAP = 1 << 3,
+	FEATURE_VERTEX_COLOUR = 1 << 4,
+
+	NUMBER_FEATURES = 5
+};
+
 class Material {
 private:
-	Shader* m_shader;
+	// Program shared with every other material of the same shader type
+	std::shared_ptr<Shader> m_shader;
 	std::vector<Texture*> m_textures;
+
+	// Texture bound to each of the shader's fixed texture units
+	Texture* m_unitTextures[Shader::NUMBER_TEXTURE_UNITS];
 	glm::vec3 m_diffuseColour = glm::vec3(1.0f, 1.0f, 1.0f);
 	glm::vec3 m_specularColour = glm::vec3(1.0f, 1.0f, 1.0f);
 	glm::vec3 m_emissionColour = glm::vec3(0.0f, 0.0f, 0.0f);
 	float m_shininess = 128.0f;
 
+	// MaterialFeature bits of the material, vertex colours are used until the mesh says otherwise
+	unsigned int m_features = MaterialFeature::FEATURE_VERTEX_COLOUR;
+
+	// Unique id of the material used for sorting the draws
+	unsigned int m_materialId;
+
+	// Number of materials created so far
+	static unsigned int s_materialCount;
+
+	// Define of each MaterialFeature bit, in bit order
+	static const char* s_featureDefines[MaterialFeature::NUMBER_FEATURES];
+
 public:
-	Material(Shader* shader) : m_shader(shader) {}
-	Material(const std::vector<Texture*>& textures, Shader* shader) : m_textures(textures), m_shader(shader) {}
-	~Material() {
-		delete m_shader;
+	Material(const std::shared_ptr<Shader>& shader) : m_shader(shader), m_materialId(s_materialCount++) { this->ResolveTextureUnits(); }
+	Material(const std::vector<Texture*>& textures, const std::shared_ptr<Shader>& shader);
+	~Material();
 
-		/*for (Texture* texture : m_textures) -- Commented as the Resource Manager should deal with this
-			delete texture;*/
-	}
+	Material(const Material&) = delete;
+	Material& operator=(const Material&) = delete;
 
 	/**
 	 * Bind material which will action the binding of both the texture
 	 * and the shader, exporting at the same time the necesarry uniforms
-	 * @param go_transform							The transform of the specific object that the
-	 *												material belogs to
 	 */
-	void BindMaterial(const Transform& go_transform);
+	void BindMaterial();
+
+	/**
+	 * Copy the material parameters into the frame ring buffer
+	 * @return GLintptr						Offset of the MaterialData block inside the ring
+	 */
+	GLintptr WriteMaterialData() const;
+
+	/**
+	 * Bind a MaterialData block written in the frame ring buffer
+	 * ( the program and the textures are bound by the caller )
+	 * @param offset						Offset returned by WriteMaterialData
+	 */
+	static void BindMaterialData(const GLintptr& offset);
 
 	/**
 	 * Unbind material which will action the unbinding of both the texture and the shader
 	 */
 	void UnbindMaterial();
 
+	/**
+	 * Assign the textures of the material to the texture units of the shader, units without
+	 * a texture of their type fall back to the first texture of the material
+	 * The map features are updated from the units that got a texture of their own
+	 */
+	void ResolveTextureUnits();
+
+	/**
+	 * Swap the shader for the variant of the same type compiled with the defines of the
+	 * features it supports, the library only compiles a variant the first time it's asked for
+	 */
+	void ResolveShaderVariant();
+
+	/**
+	 * Features a shader type reads, the others would only create identical variants
+	 * @param shaderType							Type of the shader
+	 * @return unsigned int							MaterialFeature bits
+	 */
+	static unsigned int GetSupportedFeatures(const ShaderType& shaderType);
+
+	/**
+	 * Defines a program is compiled with for a set of features
+	 * @param features								MaterialFeature bits
+	 * @return vector<string>						One define per feature
+	 */
+	static std::vector<std::string> GetFeatureDefines(const unsigned int& features);
+
+	/**
+	 * Check if two materials would set exactly the same state, in which case the
+	 * meshes using them can be drawn together
+	 * @param other									Material that is compared with this one
+	 * @return bool									true if the shader, textures and colours match
+	 */
+	bool HasSameState(const Material& other) const;
+
+	/**
+	 * Hash of everything compared by HasSameState, used to sort the draws
+	 * @return uint64_t								Hash of the material state
+	 */
+	uint64_t GetStateHash() const;
+
+private:
+	/**
+	 * Take or drop a reference in the AssetManager to every texture of a set,
+	 * the textures stay loaded as long as a material uses them
+	 * @param textures								Textures of the material
+	 */
+	static void AcquireTextures(const std::vector<Texture*>& textures);
+	static void ReleaseTextures(const std::vector<Texture*>& textures);
+
 	/**
 	 * Getters and setters
 	 */
 public:
-	inline Shader* GetShader() const { return this->m_shader; }
-	inline std::vector<Texture*> GetTextures() const { return this->m_textures; }
+	inline Shader* GetShader() const { return this->m_shader.get(); }
+	inline const std::shared_ptr<Shader>& GetSharedShader() const { return this->m_shader; }
+	inline const std::vector<Texture*>& GetTextures() const { return this->m_textures; }
 	inline const glm::vec3& GetDiffuseColour() const { return this->m_diffuseColour; }
 	inline const glm::vec3& GetSpecularColour() const { return this->m_specularColour; }
 	inline const glm::vec3& GetEmissionColour() const { return this->m_emissionColour; }
 	inline const float& GetShininess() const { return this->m_shininess; }
+	inline const unsigned int& GetMaterialId() const { return this->m_materialId; }
+	inline const unsigned int& GetFeatures() const { return this->m_features; }
+	inline bool HasFeature(const MaterialFeature& feature) const { return (this->m_features & feature) != 0; }
+	inline Texture* GetUnitTexture(const unsigned int& unit) const { return this->m_unitTextures[unit]; }
 
-	inline void SetShader(Shader* newShader) { this->m_shader = newShader; }
-	inline void SetTextures(const std::vector<Texture*>& newTextures) { this->m_textures = newTextures; }
+	inline void SetShader(const std::shared_ptr<Shader>& newShader) {
+		this->m_shader = newShader;
+		this->ResolveShaderVariant();
+	}
+	inline void SetFeature(const MaterialFeature& feature, const bool& enabled) {
+		unsigned int newFeatures = enabled ? this->m_features | feature : this->m_features & ~feature;
+		if (newFeatures != this->m_features) {
+			this->m_features = newFeatures;
+			this->ResolveShaderVariant();
+		}
+	}
+	void SetTextures(const std::vector<Texture*>& newTextures);
 	inline void SetDiffuseColour(const glm::vec3& newColour) { this->m_diffuseColour = newColour; }
 	inline void SetSpecularColour(const glm::vec3& newColour) { this->m_specularColour = newColour; }
 	inline void SetEmissionColour(const glm::vec3& newColour) { this->m_emissionColour = newColour; }
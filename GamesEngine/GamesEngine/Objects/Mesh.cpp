@@ -1,167 +1,312 @@
 #include "Mesh.h"
-
-Mesh::Mesh(Material* material, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const GLenum& movementState)
+#include "../Mathematics/MeshSimplifier.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+const Mesh::AttributeDescription Mesh::s_attributes[] = {
+	{ VertexAttribute::VERTEX_POSITION, 0, 3, offsetof(Vertex, pos) },
+	{ VertexAttribute::VERTEX_TEXTURE, 1, 2, offsetof(Vertex, textureCoord) },
+	{ VertexAttribute::VERTEX_NORMAL, 2, 3, offsetof(Vertex, normals) },
+	{ VertexAttribute::VERTEX_COLOUR, 3, 3, offsetof(Vertex, colour) },
+	{ VertexAttribute::VERTEX_TANGENT, 4, 3, offsetof(Vertex, tangent) },
+	{ VertexAttribute::VERTEX_BITANGENT, 5, 3, offsetof(Vertex, biTangent) }
+};
+
+const float Mesh::LOD_TRIANGLE_RATIOS[Mesh::MAX_LODS - 1] = { 0.5f, 0.25f, 0.1f };
+const float Mesh::LOD_ERRORS[Mesh::MAX_LODS - 1] = { 0.005f, 0.015f, 0.04f };
+const float Mesh::LOD_SCREEN_SIZES[Mesh::MAX_LODS - 1] = { 0.3f, 0.12f, 0.05f };
+
+Mesh::Geometry::Geometry(const CookedGeometry& cooked)
 {
-	this->m_material = material;
+	this->vertexLayout = cooked.vertexLayout | VertexAttribute::VERTEX_POSITION;
+	this->localBounds = cooked.localBounds;
+	this->usesVertexColour = cooked.usesVertexColour;
 
-	this->m_vertices = vertices;
-	this->m_indices = indices;
+	// The first level is the mesh itself, every index after it belongs to the simplified levels
+	unsigned int meshIndexCount = cooked.lodCount > 0 ? cooked.lods[0].indexCount : cooked.indexCount;
 
-	this->m_drawCount = indices.size();
+	this->vertices.assign(cooked.vertices, cooked.vertices + cooked.vertexCount);
+	this->indices.assign(cooked.indices, cooked.indices + meshIndexCount);
+	this->lodIndices.assign(cooked.indices + meshIndexCount, cooked.indices + cooked.indexCount);
+	this->lods.assign(cooked.lods, cooked.lods + cooked.lodCount);
+
+	this->drawCount = meshIndexCount;
+}
+
+Mesh::Geometry::~Geometry()
+{
+	GeometryBuffer::s_geometryBuffer->Free(this->allocation);
+}
 
+Mesh::Mesh(Material* material, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const GLenum& movementState, const unsigned int& vertexLayout)
+	: m_geometry(std::make_shared<Geometry>())
+{
+	this->m_material = material;
 	this->m_movementState = movementState;
 
-	// Generate the id for the VAO
-	// You need to pass in the memory location of it because it need to be a pointer and if it's not an array is not automaticaly a pointer in the class
-	glGenVertexArrays(1, &this->m_vertexArrayObject);
+	this->m_geometry->vertices = vertices;
+	this->m_geometry->indices = indices;
+	this->m_geometry->vertexLayout = vertexLayout;
 
-	// Bind the VAO
-	glBindVertexArray(this->m_vertexArrayObject);
+	// Bounds are computed once here so nothing has to walk the vertices later
+	Mesh::CookGeometry(*this->m_geometry, false);
 
-	// Generate the id for the VBO
-	glGenBuffers(NUMBER_BUFFERS, this->m_vertexBufferObject);
+	// White vertex colours change nothing, the material can use the variant that skips them
+	if (this->m_material != nullptr) {
+		this->m_material->SetFeature(MaterialFeature::FEATURE_VERTEX_COLOUR, this->m_geometry->usesVertexColour);
+	}
 
 	this->SetArrayData();
+}
+
+Mesh::Mesh(Material* material, const std::shared_ptr<Geometry>& geometry, const GLenum& movementState)
+	: m_geometry(geometry)
+{
+	this->m_material = material;
+	this->m_movementState = movementState;
 
-	// Stop everything which affects the VAO
-	glBindVertexArray(0);
+	if (this->m_material != nullptr) {
+		this->m_material->SetFeature(MaterialFeature::FEATURE_VERTEX_COLOUR, this->m_geometry->usesVertexColour);
+	}
 }
 
 Mesh::~Mesh()
 {
+	// The geometry leaves the geometry buffer with the last mesh that uses it
 	delete this->m_material;
-	glDeleteVertexArrays(1, &this->m_vertexArrayObject);
-	glDeleteBuffers(1, this->m_vertexBufferObject);
 }
 
-void Mesh::SetArrayData() {
-	// Redefine so the shaders can access the values
-	std::vector<glm::vec3> positions;
-	std::vector<glm::vec2> textureCoords;
-	std::vector<glm::vec3> colour;
-	std::vector<glm::vec3> normals;
-	std::vector<glm::vec3> tangents;
-	std::vector<glm::vec3> biTangents;
+void Mesh::BuildLods() {
+	this->DetachGeometry();
+	Mesh::GenerateLodIndices(*this->m_geometry);
+	this->m_currentLod = 0;
+	this->SetArrayData();
+}
 
-	for (unsigned int i = 0; i < this->m_vertices.size(); i++)
-	{
-		positions.push_back(this->m_vertices[i].pos);
-		textureCoords.push_back(this->m_vertices[i].textureCoord);
-		colour.push_back(this->m_vertices[i].colour);
-		normals.push_back(this->m_vertices[i].normals);
-		tangents.push_back(this->m_vertices[i].tangent);
-		biTangents.push_back(this->m_vertices[i].biTangent);
+void Mesh::DetachGeometry() {
+	if (this->m_geometry.use_count() <= 1) {
+		return;
 	}
 
-	// POSITION
-	this->SetBufferData(this->m_vertexBufferObject[POSITION_VBO], positions.data(), positions.size() * sizeof(glm::vec3));
+	std::shared_ptr<Geometry> sharedGeometry = this->m_geometry;
+	this->m_geometry = std::make_shared<Geometry>();
+	this->m_geometry->vertices = sharedGeometry->vertices;
+	this->m_geometry->indices = sharedGeometry->indices;
+	this->m_geometry->lodIndices = sharedGeometry->lodIndices;
+	this->m_geometry->lods = sharedGeometry->lods;
+	this->m_geometry->drawCount = sharedGeometry->drawCount;
+	this->m_geometry->vertexLayout = sharedGeometry->vertexLayout;
+	this->m_geometry->localBounds = sharedGeometry->localBounds;
+	this->m_geometry->usesVertexColour = sharedGeometry->usesVertexColour;
+
+	// The copy can't be instanced with the original anymore, the caller uploads it once it's changed
+	this->m_geometry->geometryId = 0;
+}
 
-	// Set the information to the first input in the buffer
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+unsigned int Mesh::SelectLod(const float& screenSize) {
+	if (this->m_geometry->lods.size() <= 1) {
+		return 0;
+	}
+	this->m_currentLod = std::min(this->m_currentLod, (unsigned int)this->m_geometry->lods.size() - 1);
 
-	// TEXTURE
-	this->SetBufferData(this->m_vertexBufferObject[TEXTURE_COORD], textureCoords.data(), textureCoords.size() * sizeof(glm::vec2));
+	// Coarser while the mesh is clearly below the threshold of the next level
+	while (this->m_currentLod + 1 < this->m_geometry->lods.size()
+		&& screenSize < Mesh::LOD_SCREEN_SIZES[this->m_currentLod] * (1.0f - Mesh::LOD_HYSTERESIS)) {
+		this->m_currentLod++;
+	}
 
-	// Set the information to the first input in the buffer
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, 0);
+	// Finer while it's clearly above the threshold of the current level
+	while (this->m_currentLod > 0
+		&& screenSize > Mesh::LOD_SCREEN_SIZES[this->m_currentLod - 1] * (1.0f + Mesh::LOD_HYSTERESIS)) {
+		this->m_currentLod--;
+	}
 
-	// NORMAL
-	this->SetBufferData(this->m_vertexBufferObject[NORMAL_VB], normals.data(), normals.size() * sizeof(glm::vec3));
+	return this->m_currentLod;
+}
 
-	// Set the information to the first input in the buffer
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, 0);
+void Mesh::CookGeometry(Geometry& geometry, const bool& buildLods) {
+	// Position is always required in order to rasterise the mesh
+	geometry.vertexLayout |= VertexAttribute::VERTEX_POSITION;
+	geometry.drawCount = geometry.indices.size();
+
+	Mesh::CalculateLocalBounds(geometry);
+
+	geometry.usesVertexColour = false;
+	if (geometry.vertexLayout & VertexAttribute::VERTEX_COLOUR) {
+		for (const Vertex& vertex : geometry.vertices) {
+			if (vertex.colour != glm::vec3(1.0f, 1.0f, 1.0f)) {
+				geometry.usesVertexColour = true;
+				break;
+			}
+		}
+	}
 
-	// COLOUR
-	this->SetBufferData(this->m_vertexBufferObject[COLOUR_VB], colour.data(), colour.size() * sizeof(glm::vec3));
+	if (buildLods) {
+		Mesh::GenerateLodIndices(geometry);
+	}
+}
 
-	// Set the information to the first input in the buffer
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 0, 0);
+void Mesh::GenerateLodIndices(Geometry& geometry) {
+	geometry.lodIndices.clear();
+	geometry.lods.clear();
 
-	//TANGENT
-	this->SetBufferData(this->m_vertexBufferObject[TANGENT_VB], tangents.data(), tangents.size() * sizeof(glm::vec3));
+	if (geometry.indices.size() / 3 < Mesh::MIN_LOD_TRIANGLES) {
+		return;
+	}
 
-	// Set the information to the first input in the buffer
-	glEnableVertexAttribArray(4);
-	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, 0, 0);
+	geometry.lods.push_back({ 0, (unsigned int)geometry.indices.size() });
+	for (unsigned int i = 0; i < Mesh::MAX_LODS - 1; i++) {
+		unsigned int targetIndexCount = (unsigned int)(geometry.indices.size() / 3 * Mesh::LOD_TRIANGLE_RATIOS[i]) * 3;
+		std::vector<unsigned int> lodIndices = MeshSimplifier::Simplify(geometry.vertices, geometry.indices, targetIndexCount, Mesh::LOD_ERRORS[i]);
 
-	//BITANGENT
-	this->SetBufferData(this->m_vertexBufferObject[BITANGENT_VB], biTangents.data(), biTangents.size() * sizeof(glm::vec3));
+		// A level that keeps most of the triangles of the previous one isn't worth a range
+		if (lodIndices.empty() || lodIndices.size() > geometry.lods.back().indexCount * 0.8f) {
+			continue;
+		}
 
-	// Set the information to the first input in the buffer
-	glEnableVertexAttribArray(5);
-	glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, 0, 0);
+		geometry.lods.push_back({ (unsigned int)(geometry.indices.size() + geometry.lodIndices.size()), (unsigned int)lodIndices.size() });
+		geometry.lodIndices.insert(geometry.lodIndices.end(), lodIndices.begin(), lodIndices.end());
+	}
 
-	// INDEX
-	this->SetBufferData(this->m_vertexBufferObject[INDEX_VB], this->m_indices.data(), this->m_indices.size() * sizeof(unsigned int), true);
+	if (geometry.lods.size() == 1) {
+		geometry.lods.clear();
+	}
 }
 
-void Mesh::SetBufferData(GLuint bufferObject, const void* data, unsigned int size, bool indices) {
-	glBindBuffer((indices ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER), bufferObject);
-	glBufferData((indices ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER), size, data, this->m_movementState);
+void Mesh::UploadGeometry(Geometry& geometry) {
+	GeometryBuffer::s_geometryBuffer->Free(geometry.allocation);
+
+	// The levels of detail are placed right after the indices of the mesh
+	std::vector<unsigned int> combinedIndices;
+	const std::vector<unsigned int>* indices = &geometry.indices;
+	if (!geometry.lodIndices.empty()) {
+		combinedIndices.reserve(geometry.indices.size() + geometry.lodIndices.size());
+		combinedIndices.insert(combinedIndices.end(), geometry.indices.begin(), geometry.indices.end());
+		combinedIndices.insert(combinedIndices.end(), geometry.lodIndices.begin(), geometry.lodIndices.end());
+		indices = &combinedIndices;
+	}
+
+	// The full layout is the Vertex class itself so it's copied straight from the vertex array
+	if (geometry.vertexLayout == VertexLayout::LAYOUT_FULL) {
+		geometry.allocation = GeometryBuffer::s_geometryBuffer->Allocate(geometry.vertexLayout,
+			geometry.vertices.data(), geometry.vertices.size(), indices->data(), indices->size());
+		return;
+	}
+
+	std::vector<unsigned char> packedData;
+	Mesh::PackVertexData(geometry, packedData);
+	geometry.allocation = GeometryBuffer::s_geometryBuffer->Allocate(geometry.vertexLayout,
+		packedData.data(), geometry.vertices.size(), indices->data(), indices->size());
 }
 
-void Mesh::ResetArrayBufferData() {
-	// Redefine so the shaders can access the values
-	std::vector<glm::vec3> positions;
-	std::vector<glm::vec2> textureCoords;
-	std::vector<glm::vec3> colour;
-	std::vector<glm::vec3> normals;
-	std::vector<glm::vec3> tangents;
-	std::vector<glm::vec3> biTangents;
+void Mesh::SetVertexAttributes(const unsigned int& vertexLayout) {
+	size_t packedOffset = 0;
 
-	for (unsigned int i = 0; i < this->m_vertices.size(); i++)
-	{
-		positions.push_back(this->m_vertices[i].pos);
-		textureCoords.push_back(this->m_vertices[i].textureCoord);
-		colour.push_back(this->m_vertices[i].colour);
-		normals.push_back(this->m_vertices[i].normals);
-		tangents.push_back(this->m_vertices[i].tangent);
-		biTangents.push_back(this->m_vertices[i].biTangent);
-	}
+	for (unsigned int i = 0; i < Mesh::NUMBER_ATTRIBUTES; i++) {
+		const AttributeDescription& description = Mesh::s_attributes[i];
 
-	this->m_drawCount = this->m_indices.size();
+		if (vertexLayout & description.attribute) {
+			// The full layout is the Vertex class itself, any other layout is tightly packed
+			size_t offset = vertexLayout == VertexLayout::LAYOUT_FULL ? description.vertexOffset : packedOffset;
 
-	// POSITION
-	this->SetBufferData(this->m_vertexBufferObject[POSITION_VBO], positions.data(), positions.size() * sizeof(glm::vec3));
+			// Set the information to the specific input in the buffer
+			glEnableVertexAttribArray(description.location);
+			glVertexAttribFormat(description.location, description.components, GL_FLOAT, GL_FALSE, offset);
+			glVertexAttribBinding(description.location, GeometryBuffer::VERTEX_BUFFER_BINDING);
 
-	// TEXTURE
-	this->SetBufferData(this->m_vertexBufferObject[TEXTURE_COORD], textureCoords.data(), textureCoords.size() * sizeof(glm::vec2));
+			packedOffset += description.components * sizeof(float);
+		}
+		else {
+			// Attributes missing from the layout read the default generic value
+			glDisableVertexAttribArray(description.location);
+		}
+	}
+}
 
-	// NORMAL
-	this->SetBufferData(this->m_vertexBufferObject[NORMAL_VB], normals.data(), normals.size() * sizeof(glm::vec3));
+void Mesh::SetInstanceAttributes() {
+	// One mat4 takes four vec4 locations
+	for (GLuint i = 0; i < 4; i++) {
+		glEnableVertexAttribArray(Mesh::INSTANCE_MODEL_LOCATION + i);
+		glVertexAttribFormat(Mesh::INSTANCE_MODEL_LOCATION + i, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, modelMatrix) + i * sizeof(glm::vec4));
+		glVertexAttribBinding(Mesh::INSTANCE_MODEL_LOCATION + i, Mesh::INSTANCE_BUFFER_BINDING);
+	}
 
-	// COLOUR
-	this->SetBufferData(this->m_vertexBufferObject[COLOUR_VB], colour.data(), colour.size() * sizeof(glm::vec3));
+	glEnableVertexAttribArray(Mesh::INSTANCE_COLOUR_LOCATION);
+	glVertexAttribFormat(Mesh::INSTANCE_COLOUR_LOCATION, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, colour));
+	glVertexAttribBinding(Mesh::INSTANCE_COLOUR_LOCATION, Mesh::INSTANCE_BUFFER_BINDING);
 
-	//TANGENT
-	this->SetBufferData(this->m_vertexBufferObject[TANGENT_VB], tangents.data(), tangents.size() * sizeof(glm::vec3));
+	// One mat3 takes three vec3 locations, only the first three floats of each column are read
+	for (GLuint i = 0; i < 3; i++) {
+		glEnableVertexAttribArray(Mesh::INSTANCE_NORMAL_LOCATION + i);
+		glVertexAttribFormat(Mesh::INSTANCE_NORMAL_LOCATION + i, 3, GL_FLOAT, GL_FALSE, offsetof(InstanceData, normalMatrix) + i * sizeof(glm::vec4));
+		glVertexAttribBinding(Mesh::INSTANCE_NORMAL_LOCATION + i, Mesh::INSTANCE_BUFFER_BINDING);
+	}
 
-	//BITANGENT
-	this->SetBufferData(this->m_vertexBufferObject[BITANGENT_VB], biTangents.data(), biTangents.size() * sizeof(glm::vec3));
+	// Advance once per instance instead of once per vertex
+	glVertexBindingDivisor(Mesh::INSTANCE_BUFFER_BINDING, 1);
+}
 
-	// INDEX
-	this->SetBufferData(this->m_vertexBufferObject[INDEX_VB], this->m_indices.data(), this->m_indices.size() * sizeof(unsigned int), true);
+void Mesh::PackVertexData(const Geometry& geometry, std::vector<unsigned char>& packedData) {
+	// Pack only the attributes that are part of the layout
+	unsigned int stride = Mesh::GetVertexStride(geometry.vertexLayout);
+	packedData.resize(geometry.vertices.size() * stride);
+
+	unsigned char* destination = packedData.data();
+	for (unsigned int v = 0; v < geometry.vertices.size(); v++) {
+		const unsigned char* source = (const unsigned char*)&geometry.vertices[v];
+
+		for (unsigned int i = 0; i < Mesh::NUMBER_ATTRIBUTES; i++) {
+			if (geometry.vertexLayout & Mesh::s_attributes[i].attribute) {
+				size_t size = Mesh::s_attributes[i].components * sizeof(float);
+				std::memcpy(destination, source + Mesh::s_attributes[i].vertexOffset, size);
+				destination += size;
+			}
+		}
+	}
 }
 
-void Mesh::CalculateBoundingBox(glm::vec3& min, glm::vec3& max) {
-	for (int i = 0; i < this->m_vertices.size() / 3; i++) {
-		if (this->m_vertices[i].pos.x < min.x) min.x = this->m_vertices[i].pos.x;
-		if (this->m_vertices[i].pos.y < min.y) min.y = this->m_vertices[i].pos.y;
-		if (this->m_vertices[i].pos.z < min.z) min.z = this->m_vertices[i].pos.z;
+unsigned int Mesh::GetVertexStride(const unsigned int& vertexLayout) {
+	if (vertexLayout == VertexLayout::LAYOUT_FULL) {
+		return sizeof(Vertex);
+	}
 
-		if (this->m_vertices[i].pos.x > max.x) max.x = this->m_vertices[i].pos.x;
-		if (this->m_vertices[i].pos.y > max.y) max.y = this->m_vertices[i].pos.y;
-		if (this->m_vertices[i].pos.z > max.z) max.z = this->m_vertices[i].pos.z;
+	unsigned int stride = 0;
+	for (unsigned int i = 0; i < Mesh::NUMBER_ATTRIBUTES; i++) {
+		if (vertexLayout & Mesh::s_attributes[i].attribute) {
+			stride += Mesh::s_attributes[i].components * sizeof(float);
+		}
 	}
+
+	return stride;
 }
 
-void Mesh::DrawMesh() {
-	glBindVertexArray(this->m_vertexArrayObject);
+void Mesh::ResetArrayBufferData() {
+	this->DetachGeometry();
+	this->m_geometry->drawCount = this->m_geometry->indices.size();
+	Mesh::CalculateLocalBounds(*this->m_geometry);
+
+	// Levels built from the previous vertices would no longer match
+	if (!this->m_geometry->lods.empty()) {
+		Mesh::GenerateLodIndices(*this->m_geometry);
+		this->m_currentLod = 0;
+	}
+
+	// The mesh is moved to a new range of the shared buffer
+	this->SetArrayData();
+}
 
-	glDrawElements(GL_TRIANGLES, this->m_drawCount, GL_UNSIGNED_INT, nullptr);
-	glBindVertexArray(0);
-}
\ No newline at end of file
+void Mesh::CalculateBoundingBox(glm::vec3& min, glm::vec3& max) {
+	if (!this->m_geometry->localBounds.IsValid())
+		return;
+
+	min = glm::min(min, this->m_geometry->localBounds.min);
+	max = glm::max(max, this->m_geometry->localBounds.max);
+}
+
+void Mesh::CalculateLocalBounds(Geometry& geometry) {
+	geometry.localBounds = BoundingBox();
+	for (const Vertex& vertex : geometry.vertices) {
+		geometry.localBounds.AddPoint(vertex.pos);
+	}
+}
@@ -2,67 +2,223 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <vector>
+#include <memory>
 #include "../Mathematics/Vertex.h"
+#include "../Mathematics/BoundingBox.h"
 #include "Material.h"
+#include "GeometryBuffer.h"
 
 class Mesh
 {
 private:
-	enum
-	{
-		POSITION_VBO,
-		TEXTURE_COORD,
-		NORMAL_VB,
-		COLOUR_VB,
-		TANGENT_VB,
-		BITANGENT_VB,
-
-		INDEX_VB,
-
-		NUMBER_BUFFERS
+	/**
+	 * Shader layout location, component count and offset inside the
+	 * Vertex class for each attribute of the interleaved buffer
+	 */
+	struct AttributeDescription {
+		VertexAttribute attribute;
+		GLuint location;
+		GLint components;
+		size_t vertexOffset;
+	};
+	static const AttributeDescription s_attributes[];
+	static const unsigned int NUMBER_ATTRIBUTES = 6;
+
+public:
+	/**
+	 * Per instance data read by the vertex shader ( divisor 1 ), the model matrix takes
+	 * four consecutive locations starting at INSTANCE_MODEL_LOCATION and the normal matrix
+	 * three locations starting at INSTANCE_NORMAL_LOCATION ( columns padded to vec4 )
+	 */
+	struct InstanceData {
+		glm::mat4 modelMatrix;
+		glm::vec4 colour;
+		glm::vec4 normalMatrix[3];
+	};
+	static const GLuint INSTANCE_BUFFER_BINDING = 6;
+	static const GLuint INSTANCE_MODEL_LOCATION = 6;
+	static const GLuint INSTANCE_COLOUR_LOCATION = 10;
+	static const GLuint INSTANCE_NORMAL_LOCATION = 11;
+
+	/**
+	 * Range of the index list of a level of detail, relative to the first index of the mesh
+	 */
+	struct LodRange {
+		unsigned int firstIndex;
+		unsigned int indexCount;
 	};
 
-	Material* m_material;
+	// Levels of detail including the full mesh, simplified levels and the triangles they keep
+	static const unsigned int MAX_LODS = 4;
+	static const float LOD_TRIANGLE_RATIOS[MAX_LODS - 1];
+	static const float LOD_ERRORS[MAX_LODS - 1];
+
+	// Projected radius ( fraction of half the screen height ) below which each simplified level is used
+	static const float LOD_SCREEN_SIZES[MAX_LODS - 1];
 
-	// Lists of vertices and indices
-	std::vector<Vertex> m_vertices;
-	std::vector<unsigned int> m_indices;
+	// Margin around the screen sizes so a mesh on the edge of a threshold doesn't switch every frame
+	static constexpr float LOD_HYSTERESIS = 0.15f;
 
-	// Id for the VAO
-	GLuint m_vertexArrayObject;
+	// Meshes smaller than this are always drawn at full detail
+	static const unsigned int MIN_LOD_TRIANGLES = 256;
 
-	// Id for the VBO
-	GLuint m_vertexBufferObject[NUMBER_BUFFERS];
+	/**
+	 * Geometry that was already processed once and is read back as it is ( see MeshCache ),
+	 * the indices of the levels of detail follow the indices of the mesh like in the geometry buffer
+	 */
+	struct CookedGeometry {
+		const Vertex* vertices = nullptr;
+		unsigned int vertexCount = 0;
+		const unsigned int* indices = nullptr;
+		unsigned int indexCount = 0;
+		const LodRange* lods = nullptr;
+		unsigned int lodCount = 0;
+		BoundingBox localBounds;
+		unsigned int vertexLayout = VertexLayout::LAYOUT_FULL;
+		bool usesVertexColour = false;
+	};
+
+	/**
+	 * Vertices, indices and levels of detail of a mesh, every mesh loaded from the same file shares
+	 * them so a level holds one copy of each model in memory and inside the geometry buffer
+	 */
+	struct Geometry {
+		// Lists of vertices and indices
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
 
-	// Number of the triagnles which need to be drawn
-	unsigned int m_drawCount;
+		// Simplified index lists stored after the original indices, level 0 is the mesh itself
+		std::vector<unsigned int> lodIndices;
+		std::vector<LodRange> lods;
+
+		// Range of the vertices and indices inside the shared geometry buffer
+		GeometryBuffer::Allocation allocation;
+
+		// Number of the triagnles which need to be drawn
+		unsigned int drawCount = 0;
+
+		// Mask of VertexAttribute values stored in the vertex buffer
+		unsigned int vertexLayout = VertexLayout::LAYOUT_FULL;
+
+		// Bounds of the vertices in model space
+		BoundingBox localBounds;
+
+		// Whether a vertex colour isn't white, the materials can skip them otherwise
+		bool usesVertexColour = false;
+
+		// Meshes with the same non zero id share the same geometry and can be instanced
+		unsigned int geometryId = 0;
+
+		Geometry() {}
+
+		/**
+		 * Copy geometry that was cooked before, the bounds, levels of detail and vertex colour
+		 * use are taken as they were stored
+		 * @param cooked					Vertices, indices and levels of detail of the mesh
+		 */
+		explicit Geometry(const CookedGeometry& cooked);
+		~Geometry();
+
+		Geometry(const Geometry&) = delete;
+		Geometry& operator=(const Geometry&) = delete;
+	};
+
+private:
+	Material* m_material = nullptr;
+
+	// Geometry of the mesh, possibly shared with other meshes
+	std::shared_ptr<Geometry> m_geometry;
+
+	// Level drawn last, kept for the hysteresis of the selection
+	unsigned int m_currentLod = 0;
 
 	// Movement state
 	GLenum m_movementState;
 
+	// Colour multiplied with the vertex colour, sent per instance
+	glm::vec3 m_colour = glm::vec3(1.0f, 1.0f, 1.0f);
+
 public:
-	Mesh() {}
-	Mesh(Material* material, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const GLenum& movementState);
+	Mesh() : m_geometry(std::make_shared<Geometry>()) {}
+	Mesh(
+		Material* material, 
+		const std::vector<Vertex>& vertices, 
+		const std::vector<unsigned int>& indices, 
+		const GLenum& movementState, 
+		const unsigned int& vertexLayout = VertexLayout::LAYOUT_FULL);
+
+	/**
+	 * Create a placement of a geometry that was already uploaded, only the material,
+	 * colour and movement state belong to the new mesh
+	 * @param material						Material of the mesh
+	 * @param geometry						Geometry shared with the other meshes of the same file
+	 * @param movementState					Movement state of the mesh
+	 */
+	Mesh(Material* material, const std::shared_ptr<Geometry>& geometry, const GLenum& movementState);
 	~Mesh();
 
 	/**
-	 * Use the specific indices or vertices for drawing the VAO
+	 * Places the vertices and indices inside the shared geometry buffer of the vertex layout,
+	 * the previous range of the mesh is released first
+	 */
+	void SetArrayData() { Mesh::UploadGeometry(*this->m_geometry); }
+
+	/**
+	 * Process the vertices and indices of a geometry without touching the context so it can run
+	 * on a worker thread: the bounds, the draw count, the vertex colour use and the levels of detail
+	 * @param geometry						Geometry with its vertices, indices and vertex layout set
+	 * @param buildLods						Whether the simplified levels of detail are built
+	 */
+	static void CookGeometry(Geometry& geometry, const bool& buildLods);
+
+	/**
+	 * Place a geometry inside the shared geometry buffer of its layout ( main thread only ),
+	 * the previous range of the geometry is released first
+	 * @param geometry						Geometry that is uploaded
+	 */
+	static void UploadGeometry(Geometry& geometry);
+
+	/**
+	 * Build the simplified levels of detail of the mesh with quadric edge collapse, the levels
+	 * share the vertices of the mesh and their indices are uploaded right after its own
 	 */
-	void DrawMesh();
+	void BuildLods();
 
 	/**
-	 * Binds the data on the specific layout location and entry point on the shader
+	 * Pick the level of detail for the size the mesh takes on screen, the level only changes
+	 * once the size is past the threshold by LOD_HYSTERESIS
+	 * @param screenSize					Projected radius as a fraction of half the screen height
+	 * @return unsigned int					Level that should be drawn
 	 */
-	void SetArrayData();
+	unsigned int SelectLod(const float& screenSize);
 
 	/**
-	 * Binds the specific data to the right buffer
-	 * @param bufferObject					Buffer location for bufferData
-	 * @param data							Buffer data casted in void*
-	 * @param size							Necesary size for the buffer
-	 * @param indices						Whether it should bind to the array or to the buffer
+	 * Describe the vertex attributes of a layout inside the bound VAO, the vertices
+	 * are read from GeometryBuffer::VERTEX_BUFFER_BINDING
+	 * @param vertexLayout					Mask of VertexAttribute values
 	 */
-	void SetBufferData(GLuint bufferObject, const void* data, unsigned int size, bool indices = false);
+	static void SetVertexAttributes(const unsigned int& vertexLayout);
+
+	/**
+	 * Describe the per instance attributes inside the bound VAO, the instance buffer itself is
+	 * attached to INSTANCE_BUFFER_BINDING by the renderer before drawing
+	 */
+	static void SetInstanceAttributes();
+
+	/**
+	 * Packs the vertices in a single interleaved array following the vertex layout
+	 * of the geometry ( the full layout is used straight from the vertex array )
+	 * @param geometry						Geometry whose vertices are packed
+	 * @param packedData					Array that receives the packed vertices
+	 */
+	static void PackVertexData(const Geometry& geometry, std::vector<unsigned char>& packedData);
+
+	/**
+	 * Calculate the size in bytes of a single vertex for a specific layout
+	 * @param vertexLayout					Mask of VertexAttribute values
+	 * @return unsigned int					Stride of the interleaved buffer
+	 */
+	static unsigned int GetVertexStride(const unsigned int& vertexLayout);
 
 	/**
 	 * Resets the array buffer data on request based on the changes made to vertices data
@@ -76,19 +232,69 @@ public:
 	 */
 	void CalculateBoundingBox(glm::vec3& min, glm::vec3& max);
 
+	/**
+	 * Compute the model space bounds from every vertex of a geometry
+	 * @param geometry						Geometry whose bounds are computed
+	 */
+	static void CalculateLocalBounds(Geometry& geometry);
+
+private:
+	/**
+	 * Simplify the indices of a geometry into its level of detail indices, levels that don't
+	 * remove enough triangles compared to the previous one are skipped
+	 * @param geometry						Geometry that is simplified
+	 */
+	static void GenerateLodIndices(Geometry& geometry);
+
+	/**
+	 * Give the mesh its own copy of a geometry that other meshes use, called before the
+	 * geometry is changed so the other meshes keep drawing the original one
+	 * Only the vertices and indices are copied, the copy is uploaded by SetArrayData
+	 */
+	void DetachGeometry();
+
 	/**
 	 * Getters and setters
 	 */
 public:
 	inline Material* GetMeshMaterial() const { return this->m_material; }
-	inline GLuint* GetVertexBufferObject() const { return (GLuint*)(&this->m_vertexBufferObject[0]); }
-	inline const std::vector<Vertex>& GetVertices() const { return this->m_vertices; }
-	inline const std::vector<unsigned int>& GetIndices() const { return this->m_indices; }
+	inline GLuint GetVertexArrayObject() const {
+		if (this->m_geometry->allocation.poolIndex == GeometryBuffer::INVALID_POOL) {
+			return 0;
+		}
+		return GeometryBuffer::s_geometryBuffer->GetVertexArrayObject(this->m_geometry->allocation.poolIndex);
+	}
+	inline const GeometryBuffer::Allocation& GetGeometryAllocation() const { return this->m_geometry->allocation; }
+	inline const unsigned int& GetDrawCount() const { return this->m_geometry->drawCount; }
+	inline unsigned int GetLodCount() const { return this->m_geometry->lods.empty() ? 1 : this->m_geometry->lods.size(); }
+	inline LodRange GetLod(const unsigned int& lod) const {
+		if (lod == 0 || lod >= this->m_geometry->lods.size()) {
+			return LodRange{ 0, this->m_geometry->drawCount };
+		}
+		return this->m_geometry->lods[lod];
+	}
+	inline const std::vector<Vertex>& GetVertices() const { return this->m_geometry->vertices; }
+	inline const std::vector<unsigned int>& GetIndices() const { return this->m_geometry->indices; }
+	inline const std::vector<unsigned int>& GetLodIndices() const { return this->m_geometry->lodIndices; }
+	inline const std::vector<LodRange>& GetLods() const { return this->m_geometry->lods; }
 	inline const GLenum& GetMovementState() const { return this->m_movementState; }
+	inline const unsigned int& GetVertexLayout() const { return this->m_geometry->vertexLayout; }
+	inline const BoundingBox& GetLocalBounds() const { return this->m_geometry->localBounds; }
+	inline const glm::vec3& GetColour() const { return this->m_colour; }
+	inline const unsigned int& GetGeometryId() const { return this->m_geometry->geometryId; }
+	inline const std::shared_ptr<Geometry>& GetSharedGeometry() const { return this->m_geometry; }
 
 	inline void SetMeshMaterial(Material* newMaterial) { this->m_material = newMaterial; }
-	inline void SetVertices(const std::vector<Vertex>& newVertices) { this->m_vertices = newVertices; }
-	inline void SetIndices(const std::vector<unsigned int>& newIndices) { this->m_indices = newIndices; }
+	inline void SetColour(const glm::vec3& newColour) { this->m_colour = newColour; }
+	inline void SetGeometryId(const unsigned int& newGeometryId) { this->m_geometry->geometryId = newGeometryId; }
+	inline void SetVertices(const std::vector<Vertex>& newVertices) {
+		this->DetachGeometry();
+		this->m_geometry->vertices = newVertices;
+	}
+	inline void SetIndices(const std::vector<unsigned int>& newIndices) {
+		this->DetachGeometry();
+		this->m_geometry->indices = newIndices;
+	}
 	inline void SetMovementState(const GLenum& newMovingState) { this->m_movementState = newMovingState; }
 	inline void SetMovementState(const GLenum& newMovingState, rp3d::RigidBody* parentGOrb) { 
 		this->m_movementState = newMovingState; 
@@ -0,0 +1,246 @@
+#include "MeshCache.h"
+#include "../Utils/Hash.h"
+#include <sys/stat.h>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <ctime>
+#include <thread>
+#include <functional>
+
+bool MeshCache::Open(const std::string& sourcePath, const bool& importTextures) {
+	this->m_file.Close();
+	this->m_meshes.clear();
+
+	unsigned long long sourceSize;
+	long long sourceTime;
+	if (!MeshCache::ReadSourceInfo(sourcePath, sourceSize, sourceTime)) {
+		return false;
+	}
+
+	if (!this->m_file.Open(MeshCache::GetCachePath(sourcePath))) {
+		return false;
+	}
+
+	const unsigned char* data = this->m_file.GetData();
+	const unsigned long long fileSize = this->m_file.GetSize();
+
+	FileHeader header;
+	bool valid = fileSize >= sizeof(FileHeader);
+	if (valid) {
+		std::memcpy(&header, data, sizeof(FileHeader));
+		valid = std::memcmp(header.magic, "FEMC", 4) == 0
+			&& header.version == MeshCache::VERSION
+			&& header.vertexSize == sizeof(Vertex)
+			&& header.importTextures == (importTextures ? 1u : 0u)
+			&& header.sourceSize == sourceSize
+			&& fileSize >= sizeof(FileHeader) + (unsigned long long)header.meshCount * sizeof(MeshRecord);
+	}
+
+	// A file touched without being changed still matches its content
+	if (valid && header.sourceTime != sourceTime) {
+		valid = MeshCache::HashFile(sourcePath) == header.sourceHash;
+	}
+
+	for (unsigned int i = 0; valid && i < header.meshCount; i++) {
+		MeshRecord record;
+		std::memcpy(&record, data + sizeof(FileHeader) + i * sizeof(MeshRecord), sizeof(MeshRecord));
+
+		// Every block has to lie inside the file, a cache cut short is imported again
+		valid = record.vertexOffset + (unsigned long long)record.vertexCount * sizeof(Vertex) <= fileSize
+			&& record.indexOffset + (unsigned long long)record.indexCount * sizeof(unsigned int) <= fileSize
+			&& record.lodOffset + (unsigned long long)record.lodCount * sizeof(Mesh::LodRange) <= fileSize
+			&& record.textureOffset + (unsigned long long)record.textureCount * sizeof(TextureRecord) <= fileSize
+			&& record.lodCount <= Mesh::MAX_LODS;
+		if (!valid) {
+			break;
+		}
+
+		// The ranges of the levels and every index are used as they are, they have to stay inside the mesh
+		const Mesh::LodRange* lods = (const Mesh::LodRange*)(data + record.lodOffset);
+		for (unsigned int l = 0; valid && l < record.lodCount; l++) {
+			valid = (unsigned long long)lods[l].firstIndex + lods[l].indexCount <= record.indexCount;
+		}
+
+		const unsigned int* indices = (const unsigned int*)(data + record.indexOffset);
+		for (unsigned int index = 0; valid && index < record.indexCount; index++) {
+			valid = indices[index] < record.vertexCount;
+		}
+
+		if (!valid) {
+			break;
+		}
+
+		CachedMesh cachedMesh;
+		cachedMesh.geometry.vertices = (const Vertex*)(data + record.vertexOffset);
+		cachedMesh.geometry.vertexCount = record.vertexCount;
+		cachedMesh.geometry.indices = indices;
+		cachedMesh.geometry.indexCount = record.indexCount;
+		cachedMesh.geometry.lods = lods;
+		cachedMesh.geometry.lodCount = record.lodCount;
+		cachedMesh.geometry.localBounds = BoundingBox(
+			glm::vec3(record.boundsMin[0], record.boundsMin[1], record.boundsMin[2]),
+			glm::vec3(record.boundsMax[0], record.boundsMax[1], record.boundsMax[2]));
+		cachedMesh.geometry.vertexLayout = record.vertexLayout;
+		cachedMesh.geometry.usesVertexColour = record.usesVertexColour != 0;
+
+		const TextureRecord* textureRecords = (const TextureRecord*)(data + record.textureOffset);
+		for (unsigned int t = 0; t < record.textureCount; t++) {
+			std::string fileName(textureRecords[t].fileName, strnlen(textureRecords[t].fileName, MeshCache::MAX_TEXTURE_NAME));
+			cachedMesh.textures.push_back(TextureReference{ fileName, Texture::ConvertIntToType(textureRecords[t].textureType) });
+		}
+
+		this->m_meshes.push_back(cachedMesh);
+	}
+
+	if (!valid) {
+		this->m_file.Close();
+		this->m_meshes.clear();
+	}
+
+	return valid;
+}
+
+bool MeshCache::Write(const std::string& sourcePath, const bool& importTextures, const std::vector<CookedMesh>& meshes) {
+	FileHeader header;
+	std::memset(&header, 0, sizeof(FileHeader));
+	std::memcpy(header.magic, "FEMC", 4);
+	header.version = MeshCache::VERSION;
+	header.vertexSize = sizeof(Vertex);
+	header.importTextures = importTextures ? 1 : 0;
+	header.meshCount = meshes.size();
+
+	if (!MeshCache::ReadSourceInfo(sourcePath, header.sourceSize, header.sourceTime)) {
+		return false;
+	}
+	header.sourceHash = MeshCache::HashFile(sourcePath);
+
+	// The time only has a resolution of a second, a file changed in the same second as it was
+	// imported would look untouched, so the content has to be compared on the next load
+	if (header.sourceTime >= (long long)std::time(nullptr)) {
+		header.sourceTime = -1;
+	}
+
+	// Place the blocks of every mesh after the header and the records
+	std::vector<MeshRecord> records(meshes.size());
+	std::vector<std::vector<TextureRecord>> textureRecords(meshes.size());
+	unsigned long long offset = MeshCache::AlignOffset(sizeof(FileHeader) + meshes.size() * sizeof(MeshRecord));
+
+	for (unsigned int i = 0; i < meshes.size(); i++) {
+		const Mesh::Geometry& geometry = *meshes[i].geometry;
+		MeshRecord& record = records[i];
+		std::memset(&record, 0, sizeof(MeshRecord));
+
+		record.vertexLayout = geometry.vertexLayout;
+		record.usesVertexColour = geometry.usesVertexColour ? 1 : 0;
+		record.vertexCount = geometry.vertices.size();
+		record.indexCount = geometry.indices.size() + geometry.lodIndices.size();
+		record.lodCount = geometry.lods.size();
+
+		for (unsigned int axis = 0; axis < 3; axis++) {
+			record.boundsMin[axis] = geometry.localBounds.min[axis];
+			record.boundsMax[axis] = geometry.localBounds.max[axis];
+		}
+
+		for (const TextureReference& texture : meshes[i].textures) {
+			if (texture.fileName.size() >= MeshCache::MAX_TEXTURE_NAME) {
+				std::cout << "ERROR: Texture name " << texture.fileName << " is too long for the mesh cache" << std::endl;
+				return false;
+			}
+
+			TextureRecord textureRecord;
+			std::memset(&textureRecord, 0, sizeof(TextureRecord));
+			textureRecord.textureType = texture.textureType;
+			std::memcpy(textureRecord.fileName, texture.fileName.c_str(), texture.fileName.size());
+			textureRecords[i].push_back(textureRecord);
+		}
+		record.textureCount = textureRecords[i].size();
+
+		record.vertexOffset = offset;
+		offset = MeshCache::AlignOffset(offset + (unsigned long long)record.vertexCount * sizeof(Vertex));
+		record.indexOffset = offset;
+		offset = MeshCache::AlignOffset(offset + (unsigned long long)record.indexCount * sizeof(unsigned int));
+		record.lodOffset = offset;
+		offset = MeshCache::AlignOffset(offset + (unsigned long long)record.lodCount * sizeof(Mesh::LodRange));
+		record.textureOffset = offset;
+		offset = MeshCache::AlignOffset(offset + (unsigned long long)record.textureCount * sizeof(TextureRecord));
+	}
+
+	// Written next to the final file first so a load never maps a cache that is half written,
+	// the name is unique per thread since two workers can import the same file
+	std::string cachePath = MeshCache::GetCachePath(sourcePath);
+	std::string temporaryPath = cachePath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+	std::ofstream cacheFile(temporaryPath, std::ios::binary | std::ios::trunc);
+	if (!cacheFile.is_open()) {
+		std::cout << "ERROR: Mesh cache " << cachePath << " could not be written" << std::endl;
+		return false;
+	}
+
+	unsigned long long written = 0;
+	auto writeBlock = [&cacheFile, &written](const unsigned long long& blockOffset, const void* blockData, const unsigned long long& blockSize) {
+		static const char zeros[MeshCache::BLOCK_ALIGNMENT] = {};
+		while (written < blockOffset) {
+			unsigned long long padding = std::min<unsigned long long>(blockOffset - written, MeshCache::BLOCK_ALIGNMENT);
+			cacheFile.write(zeros, padding);
+			written += padding;
+		}
+		if (blockSize > 0) {
+			cacheFile.write((const char*)blockData, blockSize);
+			written += blockSize;
+		}
+	};
+
+	writeBlock(0, &header, sizeof(FileHeader));
+	writeBlock(sizeof(FileHeader), records.data(), records.size() * sizeof(MeshRecord));
+
+	for (unsigned int i = 0; i < meshes.size(); i++) {
+		const Mesh::Geometry& geometry = *meshes[i].geometry;
+		const MeshRecord& record = records[i];
+
+		writeBlock(record.vertexOffset, geometry.vertices.data(), geometry.vertices.size() * sizeof(Vertex));
+		writeBlock(record.indexOffset, geometry.indices.data(), geometry.indices.size() * sizeof(unsigned int));
+		writeBlock(record.indexOffset + geometry.indices.size() * sizeof(unsigned int),
+			geometry.lodIndices.data(), geometry.lodIndices.size() * sizeof(unsigned int));
+		writeBlock(record.lodOffset, geometry.lods.data(), geometry.lods.size() * sizeof(Mesh::LodRange));
+		writeBlock(record.textureOffset, textureRecords[i].data(), textureRecords[i].size() * sizeof(TextureRecord));
+	}
+
+	cacheFile.close();
+	if (cacheFile.fail()) {
+		std::cout << "ERROR: Mesh cache " << cachePath << " could not be written" << std::endl;
+		std::remove(temporaryPath.c_str());
+		return false;
+	}
+
+	// rename doesn't replace an existing file on every platform
+	std::remove(cachePath.c_str());
+	if (std::rename(temporaryPath.c_str(), cachePath.c_str()) != 0) {
+		std::cout << "ERROR: Mesh cache " << cachePath << " could not be written" << std::endl;
+		std::remove(temporaryPath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool MeshCache::ReadSourceInfo(const std::string& sourcePath, unsigned long long& size, long long& time) {
+	struct stat fileInfo;
+	if (stat(sourcePath.c_str(), &fileInfo) != 0) {
+		return false;
+	}
+
+	size = (unsigned long long)fileInfo.st_size;
+	time = (long long)fileInfo.st_mtime;
+	return true;
+}
+
+unsigned long long MeshCache::HashFile(const std::string& filePath) {
+	MappedFile file;
+	if (!file.Open(filePath)) {
+		return 0;
+	}
+
+	return Hash::Fnv1a(file.GetData(), file.GetSize());
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+#pragma once
+#include "Mesh.h"
+#include "Texture.h"
+#include "../Utils/MappedFile.h"
+#include <vector>
+#include <string>
+#include <memory>
+
+/**
+ * Binary copy of the meshes imported from a model file, written the first time the file is
+ * imported with ::assimp:: and mapped straight into memory on the next loads
+ * The cache holds the vertices and indices ( levels of detail included ) in the exact order they
+ * are uploaded, the bounds of every mesh and the textures its material references
+ * It's only used while the size and modification time of the source file match, or its content
+ * hash does when only the time changed ( a fresh checkout of the same file )
+ */
+class MeshCache {
+public:
+	// Increase whenever the layout of the file or of the Vertex class changes
+	static const unsigned int VERSION = 1;
+	static const unsigned int MAX_TEXTURE_NAME = 256;
+
+	/**
+	 * Texture referenced by the material of a cached mesh
+	 */
+	struct TextureReference {
+		std::string fileName;
+		TextureType textureType;
+	};
+
+	/**
+	 * Mesh read back from the cache, the geometry points into the mapped file
+	 */
+	struct CachedMesh {
+		Mesh::CookedGeometry geometry;
+		std::vector<TextureReference> textures;
+	};
+
+	/**
+	 * Mesh imported from a model file that isn't uploaded yet, the geometry already has its
+	 * bounds and levels of detail so it can be written to the cache as it is
+	 */
+	struct CookedMesh {
+		std::shared_ptr<Mesh::Geometry> geometry;
+		std::vector<TextureReference> textures;
+	};
+
+private:
+	struct FileHeader {
+		char magic[4];
+		unsigned int version;
+		unsigned int vertexSize;
+		unsigned int importTextures;
+		unsigned long long sourceSize;
+		long long sourceTime;
+		unsigned long long sourceHash;
+		unsigned int meshCount;
+		unsigned int padding;
+	};
+
+	struct MeshRecord {
+		unsigned int vertexLayout;
+		unsigned int usesVertexColour;
+		unsigned int vertexCount;
+		unsigned int indexCount;
+		unsigned int lodCount;
+		unsigned int textureCount;
+		float boundsMin[3];
+		float boundsMax[3];
+		unsigned long long vertexOffset;
+		unsigned long long indexOffset;
+		unsigned long long lodOffset;
+		unsigned long long textureOffset;
+	};
+
+	struct TextureRecord {
+		unsigned int textureType;
+		char fileName[MAX_TEXTURE_NAME];
+	};
+
+	// Every block of the file starts on this boundary
+	static const unsigned int BLOCK_ALIGNMENT = 16;
+
+	MappedFile m_file;
+	std::vector<CachedMesh> m_meshes;
+
+public:
+	MeshCache() {}
+	~MeshCache() {}
+
+	/**
+	 * Map the cache of a model file and check that it still matches the file
+	 * @param sourcePath						Path of the model file the cache was written for
+	 * @param importTextures					Whether the textures of the materials were imported
+	 * @return bool								false if there is no cache or it's out of date,
+	 *											the model has to be imported again
+	 */
+	bool Open(const std::string& sourcePath, const bool& importTextures);
+
+	/**
+	 * Write the cache of a model file from the meshes that were imported from it, safe to call
+	 * from a worker thread ( the meshes don't have to be uploaded )
+	 * @param sourcePath						Path of the model file the meshes were imported from
+	 * @param importTextures					Whether the textures of the materials were imported
+	 * @param meshes							Meshes of the file with their levels of detail built
+	 * @return bool								false if the cache couldn't be written
+	 */
+	static bool Write(const std::string& sourcePath, const bool& importTextures, const std::vector<CookedMesh>& meshes);
+
+	/**
+	 * Build the path of the cache written for a model file
+	 * @param sourcePath						Path of the model file
+	 * @return string							Path of its cache
+	 */
+	static std::string GetCachePath(const std::string& sourcePath) { return sourcePath + ".meshcache"; }
+
+private:
+	/**
+	 * Read the size and modification time of the source file
+	 * @param sourcePath						Path of the model file
+	 * @param size								Size of the file in bytes
+	 * @param time								Last modification time of the file
+	 * @return bool								false if the file doesn't exist
+	 */
+	static bool ReadSourceInfo(const std::string& sourcePath, unsigned long long& size, long long& time);
+
+	/**
+	 * FNV-1a hash of the whole content of a file
+	 * @param filePath							Path of the file
+	 * @return unsigned long long				Hash of the content, 0 if the file couldn't be read
+	 */
+	static unsigned long long HashFile(const std::string& filePath);
+
+	/**
+	 * Round an offset up to the alignment of the blocks
+	 * @param offset							Offset inside the file
+	 * @return unsigned long long				First aligned offset at or after it
+	 */
+	static unsigned long long AlignOffset(const unsigned long long& offset) {
+		return (offset + MeshCache::BLOCK_ALIGNMENT - 1) / MeshCache::BLOCK_ALIGNMENT * MeshCache::BLOCK_ALIGNMENT;
+	}
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline const std::vector<CachedMesh>& GetMeshes() const { return this->m_meshes; }
+};
\ No newline at end of file
@@ -1,127 +1,93 @@
 #include "SkyBox.h"
+#include "AssetManager.h"
+#include "../Shaders/ShaderLibrary.h"
+#include "../Shaders/FrameUniforms.h"
+#include "../Utils/GLStateCache.h"
 
-SkyBox::SkyBox(float size) {
-	Transform* newSkyBoxTransform = new Transform(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f));
+SkyBox::SkyBox() {
+	// Two triangles per face of a unit cube, the size doesn't matter as it is drawn on the far plane
+	const float vertices[NUMBER_VERTICES * 3] = {
+		-1.0f,  1.0f, -1.0f,   -1.0f, -1.0f, -1.0f,    1.0f, -1.0f, -1.0f,
+		 1.0f, -1.0f, -1.0f,    1.0f,  1.0f, -1.0f,   -1.0f,  1.0f, -1.0f,
 
-	std::vector<unsigned int> indices = {
-		0, 3, 1,
-		1, 3, 2
-	};
+		-1.0f, -1.0f,  1.0f,   -1.0f, -1.0f, -1.0f,   -1.0f,  1.0f, -1.0f,
+		-1.0f,  1.0f, -1.0f,   -1.0f,  1.0f,  1.0f,   -1.0f, -1.0f,  1.0f,
 
-	std::vector<Vertex> verticesFRONT =
-	{
-		Vertex(glm::vec3(size, -size, size), glm::vec2(0.0,1.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(size, size, size), glm::vec2(0.0,0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(-size, size, size), glm::vec2(1.0,0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(-size, -size, size), glm::vec2(1.0,1.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0))
-	};
+		 1.0f, -1.0f, -1.0f,    1.0f, -1.0f,  1.0f,    1.0f,  1.0f,  1.0f,
+		 1.0f,  1.0f,  1.0f,    1.0f,  1.0f, -1.0f,    1.0f, -1.0f, -1.0f,
 
-	std::vector<Vertex> verticesBACK =
-	{
-		Vertex(glm::vec3(-size, -size, -size), glm::vec2(0.0,1.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(-size, size, -size), glm::vec2(0.0,0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(size, size, -size), glm::vec2(1.0,0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(size, -size, -size), glm::vec2(1.0,1.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0))
-	};
+		-1.0f, -1.0f,  1.0f,   -1.0f,  1.0f,  1.0f,    1.0f,  1.0f,  1.0f,
+		 1.0f,  1.0f,  1.0f,    1.0f, -1.0f,  1.0f,   -1.0f, -1.0f,  1.0f,
 
-	std::vector<Vertex> verticesTOP =
-	{
-		Vertex(glm::vec3(size, size, size), glm::vec2(0.0,1.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(size, size, -size), glm::vec2(0.0,0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(-size, size, -size), glm::vec2(1.0,0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(-size, size, size), glm::vec2(1.0,1.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0))
-	};
+		-1.0f,  1.0f, -1.0f,    1.0f,  1.0f, -1.0f,    1.0f,  1.0f,  1.0f,
+		 1.0f,  1.0f,  1.0f,   -1.0f,  1.0f,  1.0f,   -1.0f,  1.0f, -1.0f,
 
-	std::vector<Vertex> verticesBOTTOM =
-	{
-		Vertex(glm::vec3(size, -size, -size), glm::vec2(0.0,1.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(size, -size, size), glm::vec2(0.0,0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(-size, -size, size), glm::vec2(1.0,0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(-size, -size, -size), glm::vec2(1.0,1.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
+		-1.0f, -1.0f, -1.0f,   -1.0f, -1.0f,  1.0f,    1.0f, -1.0f, -1.0f,
+		 1.0f, -1.0f, -1.0f,   -1.0f, -1.0f,  1.0f,    1.0f, -1.0f,  1.0f
 	};
 
-	std::vector<Vertex> verticesRIGHT =
-	{
-		Vertex(glm::vec3(size, -size, -size), glm::vec2(0.0,1.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(size, size, -size), glm::vec2(0.0,0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(size, size, size), glm::vec2(1.0,0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(size, -size, size), glm::vec2(1.0,1.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0))
-	};
+	glGenVertexArrays(1, &this->m_vertexArrayObject);
+	glGenBuffers(1, &this->m_vertexBuffer);
 
-	std::vector<Vertex> verticesLEFT =
-	{
-		Vertex(glm::vec3(-size, -size, size), glm::vec2(0.0,1.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(-size, size, size), glm::vec2(0.0,0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(-size, size, -size), glm::vec2(1.0,0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0)),
-		Vertex(glm::vec3(-size, -size, -size), glm::vec2(1.0,1.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(1.0,1.0,1.0), glm::vec3(0.0,0.0,0.0),glm::vec3(0.0,0.0,0.0))
-	};
+	GLStateCache::s_stateCache->BindVertexArray(this->m_vertexArrayObject);
+	GLStateCache::s_stateCache->BindBuffer(GL_ARRAY_BUFFER, this->m_vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	glEnableVertexAttribArray(0);
+	glVertexAttribFormat(0, 3, GL_FLOAT, GL_FALSE, 0);
+	glVertexAttribBinding(0, 0);
+	glBindVertexBuffer(0, this->m_vertexBuffer, 0, 3 * sizeof(float));
+
+	GLStateCache::s_stateCache->BindVertexArray(0);
+	GLStateCache::s_stateCache->BindBuffer(GL_ARRAY_BUFFER, 0);
 
-	this->m_skyBoxObject = 
-		new GameObject(
-			newSkyBoxTransform,
-			std::vector<Mesh*> {
-				new Mesh(
-					new Material(
-						std::vector<Texture*>{new Texture("SkyBox/Front.bmp", TextureType::DIFFUSE, 2048, 2048)},
-						new Shader(ShaderType::FLAT)),
-					verticesFRONT,
-					indices,
-					GL_DYNAMIC_DRAW
-				),
-				new Mesh(
-					new Material(
-						std::vector<Texture*>{new Texture("SkyBox/Back.bmp", TextureType::DIFFUSE, 2048, 2048)},
-						new Shader(ShaderType::FLAT)),
-					verticesBACK,
-					indices,
-					GL_DYNAMIC_DRAW
-				),
-				new Mesh(
-					new Material(
-						std::vector<Texture*>{new Texture("SkyBox/Top.bmp", TextureType::DIFFUSE, 2048, 2048)},
-						new Shader(ShaderType::FLAT)),
-					verticesTOP,
-					indices,
-					GL_DYNAMIC_DRAW
-				),
-				new Mesh(
-					new Material(
-						std::vector<Texture*>{new Texture("SkyBox/Bottom.bmp", TextureType::DIFFUSE, 2048, 2048)},
-						new Shader(ShaderType::FLAT)),
-					verticesBOTTOM,
-					indices,
-					GL_DYNAMIC_DRAW
-				),
-				new Mesh(
-					new Material(
-						std::vector<Texture*>{new Texture("SkyBox/Right.bmp", TextureType::DIFFUSE, 2048, 2048)},
-						new Shader(ShaderType::FLAT)),
-					verticesRIGHT,
-					indices,
-					GL_DYNAMIC_DRAW
-				),
-				new Mesh(
-					new Material(
-						std::vector<Texture*>{new Texture("SkyBox/Left.bmp", TextureType::DIFFUSE, 2048, 2048)},
-						new Shader(ShaderType::FLAT)),
-					verticesLEFT,
-					indices,
-					GL_DYNAMIC_DRAW
-				)
-			},
-			false
-		);
+	// Faces in the order of the cube map targets, +X, -X, +Y, -Y, +Z, -Z
+	glGenTextures(1, &this->m_cubeMapTexture);
+	AssetManager::s_assetManager->LoadCubeMap(
+		std::vector<std::string> {
+			"SkyBox/Right.bmp",
+			"SkyBox/Left.bmp",
+			"SkyBox/Top.bmp",
+			"SkyBox/Bottom.bmp",
+			"SkyBox/Front.bmp",
+			"SkyBox/Back.bmp"
+		},
+		this->m_cubeMapTexture,
+		this->m_faceSize
+	);
+
+	// Sample across the edges of the faces instead of clamping to each one
+	glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+	this->m_shader = ShaderLibrary::s_shaderLibrary->GetShader(ShaderType::SKYBOX);
 }
 
 SkyBox::~SkyBox() {
-	delete this->m_skyBoxObject;
+	GLStateCache::s_stateCache->OnVertexArrayDeleted(this->m_vertexArrayObject);
+	GLStateCache::s_stateCache->OnBufferDeleted(this->m_vertexBuffer);
+	GLStateCache::s_stateCache->OnTextureDeleted(this->m_cubeMapTexture);
+	glDeleteVertexArrays(1, &this->m_vertexArrayObject);
+	glDeleteBuffers(1, &this->m_vertexBuffer);
+	glDeleteTextures(1, &this->m_cubeMapTexture);
 }
 
 void SkyBox::DrawSkyBox() {
-	glm::vec3 currentCamPos = Camera::s_camera->GetCurrentActiveTransform()->GetPos();
-	if (this->m_skyBoxObject->GetTransform()->GetPos() 
-		!= currentCamPos) {
-		this->m_skyBoxObject->GetTransform()->SetPos(currentCamPos);
-	}
-	this->m_skyBoxObject->DrawMesh();
+	FrameUniforms::s_frameUniforms->BindFrameData();
+
+	// The cube is on the far plane, equal depth passes where the clear value was kept
+	GLStateCache::s_stateCache->DepthFunc(GL_LEQUAL);
+	GLStateCache::s_stateCache->DepthMask(GL_FALSE);
+
+	this->m_shader->BindShader();
+	GLStateCache::s_stateCache->BindTextureUnit(Shader::DIFFUSE_UNIT, GL_TEXTURE_CUBE_MAP, this->m_cubeMapTexture);
+	GLStateCache::s_stateCache->BindVertexArray(this->m_vertexArrayObject);
+
+	glDrawArrays(GL_TRIANGLES, 0, SkyBox::NUMBER_VERTICES);
+
+	GLStateCache::s_stateCache->BindVertexArray(0);
+	GLStateCache::s_stateCache->BindTextureUnit(Shader::DIFFUSE_UNIT, GL_TEXTURE_CUBE_MAP, 0);
+	this->m_shader->UnbindShader();
+
+	GLStateCache::s_stateCache->DepthMask(GL_TRUE);
+	GLStateCache::s_stateCache->DepthFunc(GL_LESS);
 }
\ No newline at end of file
@@ -1,16 +1,29 @@
 #pragma once
-#include "GameObject.h"
+#include "../Shaders/Shader.h"
+#include <glad/glad.h>
+#include <memory>
 
 class SkyBox {
 private:
-	GameObject* m_skyBoxObject;
+	// Unit cube drawn from the inside, positions only
+	GLuint m_vertexArrayObject = 0;
+	GLuint m_vertexBuffer = 0;
+
+	// The six faces in a single GL_TEXTURE_CUBE_MAP
+	GLuint m_cubeMapTexture = 0;
+	int m_faceSize = 0;
+
+	std::shared_ptr<Shader> m_shader;
+
+	static const unsigned int NUMBER_VERTICES = 36;
 
 public:
-	SkyBox(float size);
+	SkyBox();
 	~SkyBox();
 
 	/**
-	 * Method that deals with all the bindings in order to draw skybox
+	 * Draw the skybox with a single call, it has to be drawn after the opaque geometry as it
+	 * sits on the far plane and only the pixels that nothing covered pass the depth test
 	 */
 	void DrawSkyBox();
 
@@ -19,5 +32,6 @@ public:
 	 */
 
 public:
-	inline GameObject* GetSkyBoxFaces() const { return this->m_skyBoxObject; }
+	inline const GLuint& GetCubeMapTexture() const { return this->m_cubeMapTexture; }
+	inline const int& GetFaceSize() const { return this->m_faceSize; }
 };
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "StaticBatch.h"
+#include "../Utils/RenderQueue.h"
+
+bool StaticBatch::IsStaticObject(GameObject* gameObject)
+{
+	// An object still drawing its placeholder would be merged with the wrong geometry
+	if (gameObject->GetObjectType() != ObjectType::COMMON || gameObject->GetMeshes().empty() || gameObject->GetIsLoading()) {
+		return false;
+	}
+
+	for (Mesh* mesh : gameObject->GetMeshes()) {
+		if (mesh->GetMovementState() != GL_STATIC_DRAW) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void StaticBatch::BuildBatch(const std::vector<GameObject*>& gameObjects)
+{
+	this->ClearBatch();
+
+	/**
+	 * Geometry collected for a cell before it's uploaded
+	 */
+	struct PendingBatch {
+		glm::ivec3 cell;
+		Material* material;
+		unsigned int vertexLayout;
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+	};
+	std::vector<PendingBatch> pendingBatches;
+
+	for (GameObject* gameObject : gameObjects) {
+		if (!gameObject->GetIsActive() || !StaticBatch::IsStaticObject(gameObject)) {
+			continue;
+		}
+
+		const glm::mat4& modelMatrix = gameObject->GetTransform()->GetModelMatrix();
+		const glm::mat3& normalMatrix = gameObject->GetTransform()->GetNormalMatrix();
+		glm::mat3 modelAxes(modelMatrix);
+
+		for (Mesh* mesh : gameObject->GetMeshes()) {
+			if (mesh->GetDrawCount() == 0 || mesh->GetMeshMaterial() == nullptr) {
+				continue;
+			}
+
+			// The cell is picked from the centre of the mesh so each mesh lives in a single cell
+			BoundingBox worldBounds = mesh->GetLocalBounds().Transformed(modelMatrix);
+			glm::vec3 center = (worldBounds.min + worldBounds.max) * 0.5f;
+			glm::ivec3 cell = glm::ivec3(glm::floor(center / StaticBatch::CELL_SIZE));
+
+			PendingBatch* batch = nullptr;
+			for (PendingBatch& pending : pendingBatches) {
+				if (pending.cell == cell
+					&& pending.vertexLayout == mesh->GetVertexLayout()
+					&& pending.material->HasSameState(*mesh->GetMeshMaterial())) {
+					batch = &pending;
+					break;
+				}
+			}
+			if (batch == nullptr) {
+				pendingBatches.push_back({ cell, mesh->GetMeshMaterial(), mesh->GetVertexLayout() });
+				batch = &pendingBatches.back();
+			}
+
+			// Keep the normals the way each shader was transforming them
+			bool usesNormalMatrix = mesh->GetMeshMaterial()->GetShader()->GetShaderType() == ShaderType::PHONG;
+			glm::mat3 normalTransform = usesNormalMatrix ? normalMatrix : modelAxes;
+
+			unsigned int indexOffset = batch->vertices.size();
+			batch->vertices.reserve(batch->vertices.size() + mesh->GetVertices().size());
+			for (const Vertex& vertex : mesh->GetVertices()) {
+				Vertex worldVertex = vertex;
+				worldVertex.pos = glm::vec3(modelMatrix * glm::vec4(vertex.pos, 1.0f));
+				worldVertex.normals = normalTransform * vertex.normals;
+				worldVertex.tangent = normalMatrix * vertex.tangent;
+				worldVertex.biTangent = normalMatrix * vertex.biTangent;
+				worldVertex.colour = vertex.colour * mesh->GetColour();
+				batch->vertices.push_back(worldVertex);
+			}
+
+			batch->indices.reserve(batch->indices.size() + mesh->GetIndices().size());
+			for (const unsigned int& index : mesh->GetIndices()) {
+				batch->indices.push_back(index + indexOffset);
+			}
+		}
+
+		gameObject->SetStaticBatched(true);
+		this->m_batchedObjects.push_back(gameObject);
+	}
+
+	for (PendingBatch& pending : pendingBatches) {
+		// Every mesh owns its material so the batch gets a copy of the shared state
+		Material* batchMaterial = new Material(pending.material->GetTextures(), pending.material->GetSharedShader());
+		batchMaterial->SetDiffuseColour(pending.material->GetDiffuseColour());
+		batchMaterial->SetSpecularColour(pending.material->GetSpecularColour());
+		batchMaterial->SetEmissionColour(pending.material->GetEmissionColour());
+		batchMaterial->SetShininess(pending.material->GetShininess());
+
+		// The levels of detail are built before the cell is uploaded so it's placed in the buffer only once
+		std::shared_ptr<Mesh::Geometry> geometry = std::make_shared<Mesh::Geometry>();
+		geometry->vertices = std::move(pending.vertices);
+		geometry->indices = std::move(pending.indices);
+		geometry->vertexLayout = pending.vertexLayout;
+		Mesh::CookGeometry(*geometry, true);
+		Mesh::UploadGeometry(*geometry);
+
+		Mesh* batchMesh = new Mesh(batchMaterial, geometry, GL_STATIC_DRAW);
+		this->m_batches.push_back({ pending.cell, batchMesh });
+	}
+}
+
+void StaticBatch::ClearBatch()
+{
+	for (BatchCell& batch : this->m_batches) {
+		delete batch.mesh;
+	}
+	this->m_batches.clear();
+
+	for (GameObject* gameObject : this->m_batchedObjects) {
+		gameObject->SetStaticBatched(false);
+	}
+	this->m_batchedObjects.clear();
+}
+
+unsigned int StaticBatch::PushVisibleCells(RenderQueue& renderQueue, const Frustum& frustum, const glm::vec3& cameraPos)
+{
+	unsigned int visibleCells = 0;
+	for (BatchCell& batch : this->m_batches) {
+		if (frustum.IsBoxVisible(batch.mesh->GetLocalBounds())) {
+			renderQueue.PushMesh(batch.mesh, &this->m_identityTransform, cameraPos);
+			visibleCells++;
+		}
+	}
+	return visibleCells;
+}
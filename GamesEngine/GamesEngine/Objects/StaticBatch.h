@@ -0,0 +1,75 @@
+#pragma once
+#include "GameObject.h"
+#include "../Mathematics/Frustum.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+// Forward declarations
+class RenderQueue;
+
+/**
+ * Merges the meshes of the static objects of a level into world space buffers,
+ * one buffer per spatial cell and per material state so they can still be culled
+ */
+class StaticBatch {
+private:
+	/**
+	 * Meshes merged inside the same cell that share the same material state
+	 */
+	struct BatchCell {
+		glm::ivec3 cell;
+		Mesh* mesh;
+	};
+
+	// Merged meshes of all the cells
+	std::vector<BatchCell> m_batches;
+
+	// Objects that are drawn through the merged meshes
+	std::vector<GameObject*> m_batchedObjects;
+
+	// The merged vertices are already in world space
+	Transform m_identityTransform;
+
+public:
+	// Size of a cell of the grid the static objects are split into
+	static constexpr float CELL_SIZE = 100.0f;
+
+	StaticBatch() {}
+	~StaticBatch() {
+		this->ClearBatch();
+	}
+
+	/**
+	 * Check if an object never moves and can be merged in the static batch
+	 * @param gameObject						Object that is checked
+	 * @return bool								true if every mesh is marked as STATIC and loaded
+	 */
+	static bool IsStaticObject(GameObject* gameObject);
+
+	/**
+	 * Merge all the static objects into the cell meshes, the previous batch is cleared
+	 * @param gameObjects						Objects of the scene
+	 */
+	void BuildBatch(const std::vector<GameObject*>& gameObjects);
+
+	/**
+	 * Delete the merged meshes and release the batched objects
+	 */
+	void ClearBatch();
+
+	/**
+	 * Queue the merged meshes of the cells that intersect the frustum
+	 * @param renderQueue						Queue the visible cells are pushed to
+	 * @param frustum							Frustum of the camera
+	 * @param cameraPos							Position of the camera used for the sort key
+	 * @return unsigned int						Number of visible cells
+	 */
+	unsigned int PushVisibleCells(RenderQueue& renderQueue, const Frustum& frustum, const glm::vec3& cameraPos);
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline unsigned int GetBatchCount() const { return this->m_batches.size(); }
+	inline unsigned int GetBatchedObjectCount() const { return this->m_batchedObjects.size(); }
+};
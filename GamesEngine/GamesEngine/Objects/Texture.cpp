@@ -1,5 +1,6 @@
 #include "Texture.h"
 #include "AssetManager.h"
+#include "../Utils/GLStateCache.h"
 #include <iostream>
 
 Texture::Texture(const std::string& fileName, const TextureType& textureType, int width, int height)
@@ -9,20 +10,22 @@ Texture::Texture(const std::string& fileName, const TextureType& textureType, in
 	this->m_textureHeight = height;
 	this->m_textureType = textureType;
 
+	// Drawn with a single texel until the image is decoded and uploaded by the AssetManager
 	glGenTextures(1, &this->m_textureId);
-	AssetManager::s_assetManager->LoadTexture(fileName, this->m_textureId, this->m_textureWidth, this->m_textureHeight);
-	AssetManager::s_assetManager->PushLoadedAsset(AssetType::TEXTURE, (unsigned int*)this);
+	AssetManager::s_assetManager->LoadPlaceholderTexture(textureType, this->m_textureId);
 }
 
-Texture::~Texture() {}
+Texture::~Texture()
+{
+	glDeleteTextures(1, &this->m_textureId);
+	GLStateCache::s_stateCache->OnTextureDeleted(this->m_textureId);
+}
 
 void Texture::BindTexture(unsigned int unit)
 {
-	glActiveTexture(GL_TEXTURE0 + unit);
-	glBindTexture(GL_TEXTURE_2D, this->m_textureId);
+	GLStateCache::s_stateCache->BindTextureUnit(unit, GL_TEXTURE_2D, this->m_textureId);
 }
 
 void Texture::UnbindTexture(unsigned int unit) {
-	glActiveTexture(GL_TEXTURE0 + unit);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLStateCache::s_stateCache->BindTextureUnit(unit, GL_TEXTURE_2D, 0);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <glad/glad.h>
+#include "AssetRegistry.h"
 
 // Forward declarations
 class AssetManager;
@@ -20,6 +21,9 @@ private:
 
 	TextureType m_textureType;
 
+	// Handle of the texture inside the registry of the AssetManager
+	AssetHandle<Texture> m_assetHandle;
+
 public:
 	static TextureType ConvertIntToType(const int& id) {
 		switch (id) {
@@ -61,13 +65,20 @@ public:
 	 */
 public:
 	inline const std::string& GetTextureName() const { return this->m_textureName; }
+	inline const GLuint& GetTextureID() const { return this->m_textureId; }
 	inline const TextureType& GetTextureType() const { return this->m_textureType; }
 	inline const int& GetTextureSize() const { return this->m_textureWidth; }
+	inline const AssetHandle<Texture>& GetAssetHandle() const { return this->m_assetHandle; }
 
 	inline void SetTextureName(const std::string& newTexturePath) { this->m_textureName = newTexturePath; }
 	inline void SetTextureType(const TextureType& newTextureType) { this->m_textureType = newTextureType; }
+	inline void SetAssetHandle(const AssetHandle<Texture>& newAssetHandle) { this->m_assetHandle = newAssetHandle; }
 	inline void SetTextureSize(const int& newTextureSize) { 
 		this->m_textureWidth = newTextureSize;
 		this->m_textureHeight = newTextureSize;
 	}
+	inline void SetTextureSize(const int& newTextureWidth, const int& newTextureHeight) {
+		this->m_textureWidth = newTextureWidth;
+		this->m_textureHeight = newTextureHeight;
+	}
 };
\ No newline at end of file
@@ -1,11 +1,32 @@
 #version 430 core
 
+// Depth pre-pass, only the depth of the fragment is written
+#ifdef DEPTH_ONLY
+void main()
+{
+}
+#else
+
 in vec2 texCoord0;
 in vec3 normal0;
 in vec4 colour0;
 in vec4 FragPos;
 
-uniform vec3 cameraPos;
+// Per frame data shared by every program ( std140, see FrameUniforms.h )
+layout (std140, binding = 0) uniform FrameData
+{
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+	vec4 cameraPos;
+
+	vec4 directionalLightDirection;
+	vec4 directionalLightAmbient;
+	vec4 directionalLightDiffuse;
+	vec4 directionalLightSpecular;
+
+	uvec4 clusterGrid;				// xyz = number of clusters, w = number of visible point lights
+	vec4 clusterDepth;				// x = slice scale, y = slice bias ( see LightClusters.h )
+};
 
 out vec4 colourExport;
 uniform sampler2D diffuse;
@@ -25,7 +46,7 @@ vec4 makeColour()
 
 	vec3 lightDiffuse = diffDir * vec3(1.0, 1.0, 1.0); // Diffuse direction and the light colour
 
-	vec3 viewDir = normalize(cameraPos - FragPos.xyz);
+	vec3 viewDir = normalize(cameraPos.xyz - FragPos.xyz);
 	vec3 reflectDir = reflect(-lightDir, norm);
 
 	spec = pow(max(dot(viewDir, reflectDir), 0.0), 16) * specularStrength;
@@ -36,7 +57,12 @@ vec4 makeColour()
 void main()
 {
 	expColour = makeColour();
+#ifdef HAS_DIFFUSE_MAP
 	vec4 textureSet = texture(diffuse, texCoord0);
+#else
+	vec4 textureSet = vec4(1.0);
+#endif
 	
 	colourExport = colour0 * textureSet * clamp(dot(vec3(0,1,0), normalize(normal0)), 0.4, 1.0);
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
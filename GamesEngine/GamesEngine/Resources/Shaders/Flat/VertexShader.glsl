@@ -7,15 +7,34 @@ layout (location = 3) in vec3 colour;
 layout (location = 4) in vec3 biTangent;
 layout (location = 5) in vec3 tangent;
 
+// Per instance data ( see Mesh::InstanceData )
+layout (location = 6) in mat4 modelMatrix;
+layout (location = 10) in vec4 instanceColour;
+
 out vec2 texCoord0;
 out vec3 normal0; 
 out vec4 colour0;
 
 out vec4 FragPos;
 
-uniform mat4 viewMatrix;
-uniform mat4 projectionMatrix;
-uniform mat4 modelMatrix;
+// Per frame data shared by every program ( std140, see FrameUniforms.h )
+layout (std140, binding = 0) uniform FrameData
+{
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+	vec4 cameraPos;
+
+	vec4 directionalLightDirection;
+	vec4 directionalLightAmbient;
+	vec4 directionalLightDiffuse;
+	vec4 directionalLightSpecular;
+
+	uvec4 clusterGrid;				// xyz = number of clusters, w = number of visible point lights
+	vec4 clusterDepth;				// x = slice scale, y = slice bias ( see LightClusters.h )
+};
+
+// Same position math in every program so the depth pre-pass matches the main pass exactly
+invariant gl_Position;
 
 void main()
 {
@@ -27,6 +46,10 @@ void main()
 	FragPos = worldPos;
 
 	texCoord0 = textureCoord;
-	colour0 = vec4(colour, 1.0);
+#ifdef HAS_VERTEX_COLOUR
+	colour0 = vec4(colour, 1.0) * instanceColour;
+#else
+	colour0 = instanceColour;
+#endif
 	normal0 = (modelMatrix * vec4(normal, 0.0)).xyz;
 }
\ No newline at end of file
@@ -8,17 +8,22 @@ in vec3 normal0;
 in vec3 colour0;
 in mat3 tangentSpace0;
 
-// Material
+// Material, every map is only sampled by the variants compiled with its HAS_*_MAP define ( see MaterialFeature )
 struct Material
 {
 	sampler2D diffuseMap;
 	sampler2D specularMap;
 	sampler2D bumpMap;
 	sampler2D emissionMap;
-	vec3 diffuseColour;	
-	vec3 specularColour;	
-	vec3 emissionColour;
-	float shininess;																
+};
+
+// Material parameters streamed per draw bucket ( std140, see MaterialDataBlock )
+layout (std140, binding = 1) uniform MaterialData
+{
+	vec4 materialDiffuseColour;
+	vec4 materialSpecularColour;
+	vec4 materialEmissionColour;
+	float materialShininess;
 };
 
 // Lights
@@ -30,49 +35,99 @@ struct DirectionalLight
 	vec3 specular;
 };
 
+// Point light of the clustered lists ( std430, see PointLightBlock )
 struct PointLight {
-	vec3 position;
+	vec4 position;		// w = radius
+	vec4 diffuse;		// w = intensity
+	vec4 ambient;
+	vec4 specular;
+	vec4 attenuation;	// x = constant, y = linear, z = quadratic
+};
 
-	vec3 ambient;
-	vec3 diffuse;
-	vec3 specular;
+uniform Material material;
 
-	float intensity;
+// Per frame data shared by every program ( std140, see FrameUniforms.h )
+layout (std140, binding = 0) uniform FrameData
+{
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+	vec4 cameraPos;
+
+	vec4 directionalLightDirection;
+	vec4 directionalLightAmbient;
+	vec4 directionalLightDiffuse;
+	vec4 directionalLightSpecular;
 
-	float constant;
-    float linear;
-    float quadratic;
+	uvec4 clusterGrid;				// xyz = number of clusters, w = number of visible point lights
+	vec4 clusterDepth;				// x = slice scale, y = slice bias ( see LightClusters.h )
 };
 
-uniform Material material;
-uniform DirectionalLight directionalLight;
-uniform PointLight pointLight;
-uniform vec3 cameraPos;
+// Clustered point lights built on the CPU every frame ( see LightClusters.h )
+layout (std430, binding = 2) readonly buffer PointLights
+{
+	PointLight pointLights[];
+};
+
+layout (std430, binding = 3) readonly buffer ClusterRanges
+{
+	uvec2 clusterRanges[];		// x = first index in lightIndices, y = number of lights
+};
+
+layout (std430, binding = 4) readonly buffer LightIndices
+{
+	uint lightIndices[];
+};
 				
 // Declaration
-vec3 CalculateDirLight(DirectionalLight light, vec3 normal, vec3 viewDir);
-vec3 CalculatePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float cutoff);
+vec3 CalculateDirLight(DirectionalLight light, vec3 normal, vec3 viewDir, vec3 albedo, vec3 specularColour);
+vec3 CalculatePointLight(PointLight light, vec3 normal, vec3 viewDir, float cutoff, vec3 albedo, vec3 specularColour);
+uint FindCluster();
 
 void main()													
 {					
+#ifdef HAS_NORMAL_MAP
 	vec3 norm = (255.0/128.0 * texture(material.bumpMap, texCoord0).rgb - 1.0) * (2.0 * normal0 - 1.0); //in tangent space (-1, 1).
+#else
+	vec3 norm = tangentSpace0 * normal0;	// Geometric normal in the same space as the light directions
+#endif
 	norm = normalize(norm);
 
-	vec3 viewDir = normalize(tangentSpace0 * cameraPos - tangentSpace0 * FragPos);
-
-	vec3 result = CalculateDirLight(directionalLight, norm, viewDir);
-
-	//result += CalculatePointLight(pointLight, norm, FragPos, viewDir, 0.3);	
-
-	//Support for multiple lights. Not implemented yet 
-	//for(int i=0; i<NUM_LIGHTS; i++)		//NUM_LIGHTS = number of point lights in the scene. Sent as uniform
-	//{
-	//	result += CalculatePointLight(pointLight[i], norm, FragPos, viewDir, 0.3);	
-	//}
-	//
-	vec3 emission = vec3(0.0);
-	
-	emission = texture(material.emissionMap, texCoord0).rgb * material.emissionColour; // * material.emissionAmp;	//emissionAmp is 0 if the texture exists and 1 otherwise
+	// Surface colours are read once and shared by every light
+#ifdef HAS_DIFFUSE_MAP
+	vec3 albedo = texture(material.diffuseMap, texCoord0).rgb * materialDiffuseColour.rgb;
+#else
+	vec3 albedo = materialDiffuseColour.rgb;
+#endif
+
+#ifdef HAS_SPECULAR_MAP
+	vec3 specularColour = texture(material.specularMap, texCoord0).rgb * materialSpecularColour.rgb;
+#else
+	vec3 specularColour = materialSpecularColour.rgb;
+#endif
+
+	vec3 viewDir = normalize(tangentSpace0 * cameraPos.xyz - tangentSpace0 * FragPos);
+
+	DirectionalLight directionalLight = DirectionalLight(
+		directionalLightDirection.xyz,
+		directionalLightAmbient.xyz,
+		directionalLightDiffuse.xyz,
+		directionalLightSpecular.xyz);
+
+	vec3 result = CalculateDirLight(directionalLight, norm, viewDir, albedo, specularColour);
+
+	// Only the point lights that reach the cluster of the fragment are evaluated
+	if (clusterGrid.w > 0) {
+		uvec2 clusterRange = clusterRanges[FindCluster()];
+		for (uint i = 0; i < clusterRange.y; i++) {
+			result += CalculatePointLight(pointLights[lightIndices[clusterRange.x + i]], norm, viewDir, 0.3, albedo, specularColour);
+		}
+	}
+
+#ifdef HAS_EMISSION_MAP
+	vec3 emission = texture(material.emissionMap, texCoord0).rgb * materialEmissionColour.rgb;
+#else
+	vec3 emission = materialEmissionColour.rgb;
+#endif
 	
 	result += emission;
 
@@ -80,52 +135,71 @@ void main()
 };		
 
 
-vec3 CalculateDirLight(DirectionalLight light, vec3 normal, vec3 viewDir)
+vec3 CalculateDirLight(DirectionalLight light, vec3 normal, vec3 viewDir, vec3 albedo, vec3 specularColour)
 {
 	vec3 lightDir = normalize(tangentSpace0 * (-light.direction));
 
 	// Ambient
-	vec3 ambient = light.ambient * vec3(texture(material.diffuseMap, texCoord0)) * material.diffuseColour;
+	vec3 ambient = light.ambient * albedo;
 
 	// Diffuse
 	float diff = max(dot(normal, lightDir), 0.0);
 
-	vec3 diffuse = colour0 * light.diffuse * diff * vec3(texture(material.diffuseMap, texCoord0)) * material.diffuseColour;
+	vec3 diffuse = colour0 * light.diffuse * diff * albedo;
 
 	// Specular
 	vec3 reflectDir = reflect(-lightDir, normal);
 
-	float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-	vec3 specular = light.specular * spec * vec3(texture(material.specularMap, texCoord0)) * material.specularColour;
+	float spec = pow(max(dot(viewDir, reflectDir), 0.0), materialShininess);
+	vec3 specular = light.specular * spec * specularColour;
 	
 	return (ambient + diffuse + specular);
 }
 
-vec3 CalculatePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float cutoff)
+vec3 CalculatePointLight(PointLight light, vec3 normal, vec3 viewDir, float cutoff, vec3 albedo, vec3 specularColour)
 {
-	vec3 lightDir = normalize(tangentSpace0 * light.position - fragPos);
+	// The normal and the view direction are in tangent space
+	vec3 toLight = light.position.xyz - FragPos;
+	vec3 lightDir = normalize(tangentSpace0 * toLight);
 
 	// Ambient
-	vec3 ambient = light.ambient * vec3(texture(material.diffuseMap, texCoord0)) * material.diffuseColour;
+	vec3 ambient = light.ambient.rgb * albedo;
 	
 	// Diffuse
 	float diff = max(dot(normal, lightDir), 0.0);
-	vec3 diffuse = colour0 * light.diffuse * diff * vec3(texture(material.diffuseMap, texCoord0)) * material.diffuseColour;
+	vec3 diffuse = colour0 * light.diffuse.rgb * diff * albedo;
 	
 	// Specular
 	vec3 reflectDir = reflect(-lightDir, normal);
-	float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-	vec3 specular = light.specular * spec * vec3(texture(material.specularMap, texCoord0)) * material.specularColour;
+	float spec = pow(max(dot(viewDir, reflectDir), 0.0), materialShininess);
+	vec3 specular = light.specular.rgb * spec * specularColour;
 
 	// Attenuation
-	float distance = length(tangentSpace0 * light.position - fragPos);
-	float attenuation = light.intensity / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+	float distance = length(toLight);
+	float attenuation = light.diffuse.w / (light.attenuation.x + light.attenuation.y * distance + light.attenuation.z * (distance * distance));
 	attenuation = (attenuation - cutoff) / (1 - cutoff);
 	attenuation = max(attenuation, 0.0);
 
+	// Fade to zero at the radius the light was binned with so the cluster edges don't show
+	float rangeFactor = clamp(1.0 - pow(distance / light.position.w, 4.0), 0.0, 1.0);
+	attenuation *= rangeFactor * rangeFactor;
+
 	ambient *= attenuation;
 	diffuse *= attenuation;
 	specular *= attenuation;
 
 	return (ambient + diffuse + specular);
-}
\ No newline at end of file
+}
+
+uint FindCluster()
+{
+	// Same grid as LightClusters::Build, screen tiles from the NDC position and exponential depth slices
+	vec4 viewPos = viewMatrix * vec4(FragPos, 1.0);
+	vec4 clipPos = projectionMatrix * viewPos;
+
+	vec2 gridSize = vec2(clusterGrid.xy);
+	uvec2 tile = uvec2(clamp((clipPos.xy / clipPos.w * 0.5 + 0.5) * gridSize, vec2(0.0), gridSize - 1.0));
+	uint slice = uint(clamp(log(-viewPos.z) * clusterDepth.x - clusterDepth.y, 0.0, float(clusterGrid.z - 1)));
+
+	return tile.x + clusterGrid.x * (tile.y + clusterGrid.y * slice);
+}
@@ -7,6 +7,11 @@ layout (location = 3) in vec3 colour;
 layout (location = 4) in vec3 biTangent;
 layout (location = 5) in vec3 tangent;
 
+// Per instance data ( see Mesh::InstanceData )
+layout (location = 6) in mat4 modelMatrix;
+layout (location = 10) in vec4 instanceColour;
+layout (location = 11) in mat3 normalMatrix;		// inverse transpose of the model matrix, built on the CPU
+
 out mat3 tangentSpace0;
 out vec2 texCoord0;
 out vec3 normal0; 
@@ -14,9 +19,24 @@ out vec3 colour0;
 
 out vec3 FragPos;
 
-uniform mat4 viewMatrix;
-uniform mat4 projectionMatrix;
-uniform mat4 modelMatrix;
+// Per frame data shared by every program ( std140, see FrameUniforms.h )
+layout (std140, binding = 0) uniform FrameData
+{
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+	vec4 cameraPos;
+
+	vec4 directionalLightDirection;
+	vec4 directionalLightAmbient;
+	vec4 directionalLightDiffuse;
+	vec4 directionalLightSpecular;
+
+	uvec4 clusterGrid;				// xyz = number of clusters, w = number of visible point lights
+	vec4 clusterDepth;				// x = slice scale, y = slice bias ( see LightClusters.h )
+};
+
+// Same position math in every program so the depth pre-pass matches the main pass exactly
+invariant gl_Position;
 
 void main()
 {
@@ -27,16 +47,18 @@ void main()
 
 	FragPos = worldPos.xyz;
 
-	mat3 normalMat = transpose(inverse(mat3(modelMatrix)));
-
 	texCoord0 = textureCoord;
-	colour0 = colour;
+#ifdef HAS_VERTEX_COLOUR
+	colour0 = colour * instanceColour.rgb;
+#else
+	colour0 = instanceColour.rgb;
+#endif
 	//normal0 = (modelMatrix * vec4(normal, 0.0)).xyz;
-	normal0 = normalMat * normal;
+	normal0 = normalMatrix * normal;
 	
-	vec3 T = normalize(normalMat * tangent);
-	vec3 N = normalize(normalMat * normal);
-	vec3 B = normalize(normalMat * biTangent);
+	vec3 T = normalize(normalMatrix * tangent);
+	vec3 N = normalize(normalMatrix * normal);
+	vec3 B = normalize(normalMatrix * biTangent);
 	T = normalize(T - dot(T, N) * N); //Gram-Schmidt (reorganise vectors to be perpendicular to each other again.)
 	
 	mat3 TBN = transpose(mat3(
@@ -0,0 +1,11 @@
+#version 430 core
+
+in vec3 texCoord0;
+
+out vec4 colourExport;
+uniform samplerCube skyBox;
+
+void main()
+{
+	colourExport = texture(skyBox, texCoord0);
+}
\ No newline at end of file
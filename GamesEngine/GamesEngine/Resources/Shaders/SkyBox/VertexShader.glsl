@@ -0,0 +1,32 @@
+#version 430 core
+
+layout (location = 0) in vec3 position;
+
+out vec3 texCoord0;
+
+// Per frame data shared by every program ( std140, see FrameUniforms.h )
+layout (std140, binding = 0) uniform FrameData
+{
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+	vec4 cameraPos;
+
+	vec4 directionalLightDirection;
+	vec4 directionalLightAmbient;
+	vec4 directionalLightDiffuse;
+	vec4 directionalLightSpecular;
+
+	uvec4 clusterGrid;				// xyz = number of clusters, w = number of visible point lights
+	vec4 clusterDepth;				// x = slice scale, y = slice bias ( see LightClusters.h )
+};
+
+void main()
+{
+	// The cube follows the camera so only the rotation of the view is applied
+	vec4 clipPos = projectionMatrix * vec4(mat3(viewMatrix) * position, 1.0);
+
+	// z = w puts every fragment on the far plane, behind everything drawn before
+	gl_Position = clipPos.xyww;
+
+	texCoord0 = position;
+}
\ No newline at end of file
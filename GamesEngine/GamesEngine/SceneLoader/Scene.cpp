@@ -1,5 +1,7 @@
 #include "Scene.h"
 #include "../Utils/NetworkEngine.h"
+#include "../Shaders/ShaderLibrary.h"
+#include "../Shaders/FrameUniforms.h"
 #include <iostream>
 #include <sstream>
 
@@ -33,6 +35,53 @@ void Scene::ExportDataParser(int levelParsed, const std::vector<GameObject*>& ga
 	levelVersionNode->ToElement()->SetText(std::to_string(levelParsed).c_str());
 	rootNode->InsertEndChild(levelVersionNode);
 
+	// Create the main node that stores the lights of the scene
+	tinyxml2::XMLNode* levelLightsNode = levelData.NewElement("SCENELIGHTS");
+	rootNode->InsertEndChild(levelLightsNode);
+
+	for (unsigned int i = 0; i < this->lights.size(); i++) {
+		const Light* light = this->lights[i];
+		bool isPointLight = light->GetType() == LightType::Point;
+
+		tinyxml2::XMLNode* lightNode = levelData.NewElement("LIGHT");
+		levelLightsNode->InsertEndChild(lightNode);
+
+		// Set the type of the light
+		tinyxml2::XMLNode* lightTypeNode = levelData.NewElement("LIGHTTYPE");
+		lightTypeNode->ToElement()->SetText(isPointLight ? "POINT" : "DIRECTIONAL");
+		lightNode->InsertEndChild(lightTypeNode);
+
+		// Set the position of a point light or the direction of a directional light
+		glm::vec3 lightVector = isPointLight ? light->GetPos() : light->GetDir();
+		tinyxml2::XMLNode* lightVectorNode = levelData.NewElement(isPointLight ? "LIGHT-POSITION" : "LIGHT-DIRECTION");
+		lightVectorNode->ToElement()->SetAttribute("AXIS-X", lightVector.x);
+		lightVectorNode->ToElement()->SetAttribute("AXIS-Y", lightVector.y);
+		lightVectorNode->ToElement()->SetAttribute("AXIS-Z", lightVector.z);
+		lightNode->InsertEndChild(lightVectorNode);
+
+		// Set each colour of the light ( DIFFUSE, AMBIENT, SPECULAR )
+		const char* colourNames[3] = { "LIGHT-DIFFUSE", "LIGHT-AMBIENT", "LIGHT-SPECULAR" };
+		glm::vec3 colours[3] = { light->GetDiffuse(), light->GetAmbient(), light->GetSpecular() };
+		for (unsigned int c = 0; c < 3; c++) {
+			tinyxml2::XMLNode* lightColourNode = levelData.NewElement(colourNames[c]);
+			lightColourNode->ToElement()->SetAttribute("AXIS-X", colours[c].x * 255);
+			lightColourNode->ToElement()->SetAttribute("AXIS-Y", colours[c].y * 255);
+			lightColourNode->ToElement()->SetAttribute("AXIS-Z", colours[c].z * 255);
+			lightNode->InsertEndChild(lightColourNode);
+		}
+
+		// Set the range of a point light
+		if (isPointLight) {
+			tinyxml2::XMLNode* lightRadiusNode = levelData.NewElement("LIGHTRADIUS");
+			lightRadiusNode->ToElement()->SetText(light->GetRadius());
+			lightNode->InsertEndChild(lightRadiusNode);
+
+			tinyxml2::XMLNode* lightIntensityNode = levelData.NewElement("LIGHTINTENSITY");
+			lightIntensityNode->ToElement()->SetText(light->GetIntesity());
+			lightNode->InsertEndChild(lightIntensityNode);
+		}
+	}
+
 	// Create the main node that stores the list of gameObjects
 	tinyxml2::XMLNode* levelGameObjectsNode = levelData.NewElement("GAMEOBJECTS");
 	rootNode->InsertEndChild(levelGameObjectsNode);
@@ -105,9 +154,9 @@ void Scene::ExportDataParser(int levelParsed, const std::vector<GameObject*>& ga
 
 			// Set the colour of the new imported 3D object
 			tinyxml2::XMLNode* objectColourNode = levelData.NewElement("COLOUR");
-			objectColourNode->ToElement()->SetAttribute("R", tempReferrence[0]->GetVertices()[0].colour.r * 255);
-			objectColourNode->ToElement()->SetAttribute("G", tempReferrence[0]->GetVertices()[0].colour.g * 255);
-			objectColourNode->ToElement()->SetAttribute("B", tempReferrence[0]->GetVertices()[0].colour.b * 255);
+			objectColourNode->ToElement()->SetAttribute("R", tempReferrence[0]->GetColour().r * 255);
+			objectColourNode->ToElement()->SetAttribute("G", tempReferrence[0]->GetColour().g * 255);
+			objectColourNode->ToElement()->SetAttribute("B", tempReferrence[0]->GetColour().b * 255);
 			objectNode->InsertEndChild(objectColourNode);
 		}
 		else {
@@ -302,6 +351,55 @@ void Scene::LevelDataParser(int levelParsed, std::vector<GameObject*>& gameObjec
 	tinyxml2::XMLNode* levelVersionNode = rootNode->FirstChildElement("VERSION");
 	if (std::atoi(levelVersionNode->FirstChild()->Value()) == levelParsed) {
 
+		/* SCENE LIGHTS */
+		tinyxml2::XMLNode* sceneLightsNode = rootNode->FirstChildElement("SCENELIGHTS");
+		if (sceneLightsNode != nullptr && sceneLightsNode->FirstChildElement("LIGHT") != nullptr) {
+			// The lights of the level replace the default directional light
+			for (unsigned int i = 0; i < this->lights.size(); i++) {
+				delete this->lights[i];
+			}
+			this->lights.clear();
+
+			tinyxml2::XMLNode* lightNode = sceneLightsNode->FirstChildElement("LIGHT");
+			while (lightNode != nullptr) {
+				/* LIGHT TYPE */
+				bool isPointLight = std::string(lightNode->FirstChildElement("LIGHTTYPE")->FirstChild()->Value()) == "POINT";
+
+				/* POSITION / DIRECTION */
+				tinyxml2::XMLNode* lightVectorNode = lightNode->FirstChildElement(isPointLight ? "LIGHT-POSITION" : "LIGHT-DIRECTION");
+				glm::vec3 lightVector(
+					std::stof(lightVectorNode->ToElement()->FindAttribute("AXIS-X")->Value()),
+					std::stof(lightVectorNode->ToElement()->FindAttribute("AXIS-Y")->Value()),
+					std::stof(lightVectorNode->ToElement()->FindAttribute("AXIS-Z")->Value())
+				);
+
+				/* COLOURS */
+				const char* colourNames[3] = { "LIGHT-DIFFUSE", "LIGHT-AMBIENT", "LIGHT-SPECULAR" };
+				glm::vec3 colours[3];
+				for (unsigned int c = 0; c < 3; c++) {
+					tinyxml2::XMLNode* lightColourNode = lightNode->FirstChildElement(colourNames[c]);
+					colours[c] = glm::vec3(
+						std::stof(lightColourNode->ToElement()->FindAttribute("AXIS-X")->Value()) / 255,
+						std::stof(lightColourNode->ToElement()->FindAttribute("AXIS-Y")->Value()) / 255,
+						std::stof(lightColourNode->ToElement()->FindAttribute("AXIS-Z")->Value()) / 255
+					);
+				}
+
+				if (isPointLight) {
+					/* RADIUS / INTENSITY */
+					float radius = std::stof(lightNode->FirstChildElement("LIGHTRADIUS")->FirstChild()->Value());
+					float intensity = std::stof(lightNode->FirstChildElement("LIGHTINTENSITY")->FirstChild()->Value());
+
+					this->lights.push_back(new Light(LightType::Point, lightVector, colours[0], colours[1], colours[2], radius, intensity));
+				}
+				else {
+					this->lights.push_back(new Light(LightType::Directional, lightVector, colours[0], colours[1], colours[2]));
+				}
+
+				lightNode = lightNode->NextSiblingElement("LIGHT");
+			}
+		}
+
 		/* GAME OBJECTS LIST */
 		tinyxml2::XMLNode* gameObjectsListNode = rootNode->FirstChildElement("GAMEOBJECTS");
 		
@@ -385,15 +483,15 @@ void Scene::LevelDataParser(int levelParsed, std::vector<GameObject*>& gameObjec
 							tinyxml2::XMLNode* shaderMaterialNode = materialNode->FirstChildElement("SHADERTYPE");
 
 							/* -- SHADER */
-							Shader* meshShader;
+							std::shared_ptr<Shader> meshShader;
 							if (std::string(shaderMaterialNode->FirstChild()->Value()) == "EMPTY")
-								meshShader = new Shader(ShaderType::EMPTY);
+								meshShader = ShaderLibrary::s_shaderLibrary->GetShader(ShaderType::EMPTY);
 							else if (std::string(shaderMaterialNode->FirstChild()->Value()) == "FLAT")
-								meshShader = new Shader(ShaderType::FLAT);
+								meshShader = ShaderLibrary::s_shaderLibrary->GetShader(ShaderType::FLAT);
 							else if (std::string(shaderMaterialNode->FirstChild()->Value()) == "PHONG")
-								meshShader = new Shader(ShaderType::PHONG);
+								meshShader = ShaderLibrary::s_shaderLibrary->GetShader(ShaderType::PHONG);
 							else
-								meshShader = new Shader(ShaderType::EMPTY);
+								meshShader = ShaderLibrary::s_shaderLibrary->GetShader(ShaderType::EMPTY);
 
 							/* -- TEXTURE LIST */
 							tinyxml2::XMLNode* textureListNode = materialNode->FirstChildElement("TEXTURELIST");
@@ -517,7 +615,8 @@ void Scene::LevelDataParser(int levelParsed, std::vector<GameObject*>& gameObjec
 							while (ss >> temp)
 								indices.push_back(temp);
 
-							objectMeshes.push_back(new Mesh(newMeshMaterial, vertices, indices, moveState));
+							// Level file meshes don't store any tangent space
+							objectMeshes.push_back(new Mesh(newMeshMaterial, vertices, indices, moveState, VertexLayout::LAYOUT_NO_TANGENT));
 
 							meshNode = meshNode->NextSibling();
 						}
@@ -557,21 +656,12 @@ void Scene::LevelDataParser(int levelParsed, std::vector<GameObject*>& gameObjec
 
 void Scene::DrawScene(const bool& builderActive)
 {
+	// Objects move first so every matrix they dirty this frame goes through the batch pass below
 	for (std::vector<GameObject*>::size_type i = 0; i != this->gameObjects.size(); i++) {
-		for (std::vector<Light*>::size_type j = 0; j != this->lights.size() && this->gameObjects[i]->GetMeshes().size() > 0; j++)
-		{
-			this->lights[j]->SetUniforms(this->gameObjects[i]->GetMeshById(0)->GetMeshMaterial()->GetShader());
-		}
-
 		// If networking type is server don't draw the player entity nor update it
-		if (this->gameObjects[i]->GetObjectType() == ObjectType::PLAYER
-			&& NetworkEngine::s_networkEngine->GetNetworkType() == NetworkType::SERVER
-			&& !builderActive) {
+		if (this->IsHiddenServerPlayer(this->gameObjects[i], builderActive)) {
 			continue;
 		}
-		else {
-			this->gameObjects[i]->DrawMesh();
-		}
 
 		if (!builderActive) {
 			this->gameObjects[i]->Update();
@@ -586,6 +676,53 @@ void Scene::DrawScene(const bool& builderActive)
 			}
 		}
 	}
+
+	// Every object that moved since the last frame gets its matrices rebuilt in one pass
+	TransformPool::s_transformPool->UpdateDirtyMatrices();
+
+	// The lights are uploaded once for the whole frame instead of once per object
+	FrameUniforms::s_frameUniforms->SetLightData(this->lights);
+	FrameUniforms::s_frameUniforms->BindFrameData();
+
+	glm::vec3 cameraPos = Camera::s_camera->GetCurrentActiveTransform()->GetPos();
+
+	// Only the objects that intersect the view of the camera are queued
+	Frustum cameraFrustum(Camera::s_camera->GetProjection() * Camera::s_camera->GetView());
+	this->m_visibleObjects = 0;
+
+	// Objects are only merged once their models replaced the placeholders
+	bool assetsLoading = AssetManager::s_assetManager->HasPendingModels();
+	if (this->m_assetsLoading && !assetsLoading) {
+		this->InvalidateStaticBatch();
+	}
+	this->m_assetsLoading = assetsLoading;
+
+	// Static objects are merged once after loading or editing the level
+	if (this->m_staticBatchDirty) {
+		this->m_staticBatch.BuildBatch(this->gameObjects);
+		this->m_staticBatchDirty = false;
+	}
+
+	this->m_renderQueue.Clear();
+	this->m_visibleStaticCells = this->m_staticBatch.PushVisibleCells(this->m_renderQueue, cameraFrustum, cameraPos);
+	for (std::vector<GameObject*>::size_type i = 0; i != this->gameObjects.size(); i++) {
+		if (!this->IsHiddenServerPlayer(this->gameObjects[i], builderActive)
+			&& this->gameObjects[i]->GetIsActive()
+			&& !this->gameObjects[i]->GetIsStaticBatched()
+			&& cameraFrustum.IsBoxVisible(this->gameObjects[i]->GetWorldBounds())) {
+			this->m_renderQueue.PushGameObject(this->gameObjects[i], cameraPos);
+			this->m_visibleObjects++;
+		}
+	}
+
+	// Draw everything that was queued sorted by state
+	this->m_renderQueue.Submit();
+}
+
+bool Scene::IsHiddenServerPlayer(GameObject* gameObject, const bool& builderActive) const {
+	return gameObject->GetObjectType() == ObjectType::PLAYER
+		&& NetworkEngine::s_networkEngine->GetNetworkType() == NetworkType::SERVER
+		&& !builderActive;
 }
 
 void Scene::HandleEvents(Event& e) {
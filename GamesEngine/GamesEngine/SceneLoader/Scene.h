@@ -1,6 +1,9 @@
 #pragma once
 #include "../Objects/GameObject.h"
+#include "../Objects/StaticBatch.h"
 #include "../Shaders/Light.h"
+#include "../Utils/RenderQueue.h"
+#include "../Mathematics/Frustum.h"
 #include <tinyxml2/tinyxml2.h>
 #include <string>
 #include <regex>
@@ -18,9 +21,18 @@
  * --|-|-@soundName							SOUNDNAME		----- TODO
  * --|-|-@soundType							SOUNDCHANNEL	----- TODO
  * --|-|-@soundEvent						SOUNDACTION		----- TODO
- * --@sceneLighting							SCENELIGHTS		----- TODO
- * --|-@specificLight						LIGHT			----- TODO
- * --|-|-@lightType							LIGHTTYPE		----- TODO
+ * --@sceneLighting							SCENELIGHTS ( If it has no LIGHT the default directional light is kept )
+ * --|-@specificLight						LIGHT
+ * --|-|-@lightType							LIGHTTYPE ( DIRECTIONAL / POINT )
+ * --|-|-@(ifPoint)
+ * --|-|-|-@lightPosition					LIGHT-POSITION ( Attributes: AXIS-X, AXIS-Y, AXIS-Z )
+ * --|-|-|-@lightRadius						LIGHTRADIUS (FLOAT) ( Range used by the clustered light culling )
+ * --|-|-|-@lightIntensity					LIGHTINTENSITY (FLOAT)
+ * --|-|-@(ELSE)
+ * --|-|-|-@lightDirection					LIGHT-DIRECTION ( Attributes: AXIS-X, AXIS-Y, AXIS-Z )
+ * --|-|-@diffuseColour						LIGHT-DIFFUSE ( Attributes: AXIS-X, AXIS-Y, AXIS-Z -- Range(1,255) )
+ * --|-|-@ambientColour						LIGHT-AMBIENT ( Attributes: AXIS-X, AXIS-Y, AXIS-Z -- Range(1,255) )
+ * --|-|-@specularColour					LIGHT-SPECULAR ( Attributes: AXIS-X, AXIS-Y, AXIS-Z -- Range(1,255) )
  * --@gameObjectIterator					GAMEOBJECTS
  * --|-@object								OBJECT
  * --|-|-@isActive							ACTIVE
@@ -65,6 +77,20 @@ private:
 	std::vector<GameObject*> gameObjects;
 	std::vector<Light*> lights;
 
+	// Draws of the current frame sorted by state before submitting
+	RenderQueue m_renderQueue;
+
+	// Number of objects that passed the frustum culling in the last draw
+	unsigned int m_visibleObjects = 0;
+
+	// Static objects merged per cell, rebuilt on the next draw once it's dirty
+	StaticBatch m_staticBatch;
+	bool m_staticBatchDirty = true;
+	unsigned int m_visibleStaticCells = 0;
+
+	// Whether models were still loading during the last draw, the batch is rebuilt once they're done
+	bool m_assetsLoading = false;
+
 	// Scene current level
 	int m_currentLevel;
 
@@ -108,6 +134,10 @@ public:
 	 * @param gameObjectsList					List of the game objects where the objects will be created
 	 */
 	void ClearDataParsed(std::vector<GameObject*>& gameObjectsList) {
+		// The batch keeps references to the objects of the scene
+		if (&gameObjectsList == &this->gameObjects) {
+			this->InvalidateStaticBatch();
+		}
 		for (int i = 0; i < gameObjectsList.size(); i++) {
 			delete gameObjectsList[i];
 		}
@@ -118,6 +148,7 @@ public:
 	 * Clear the data of the level that this scene belongs to
 	 */
 	void ClearCurrentData() {
+		this->InvalidateStaticBatch();
 		for (int i = 0; i < this->gameObjects.size(); i++) {
 			delete this->gameObjects[i];
 		}
@@ -125,13 +156,30 @@ public:
 	}
 
 	/**
-	 * Draw the meshes that are existing in the current scene
-	 * as well as calculating the uniforms for the specific lights present in the scene
+	 * Queue the meshes that are existing in the current scene and draw them sorted by state
+	 * as well as uploading the uniforms for the specific lights present in the scene
 	 * @param builderActive					If the scene builder is active then disable
 	 *										The update of the physics simulation
 	 */
 	void DrawScene(const bool& builderActive);
 
+	/**
+	 * Check if an object is the player entity of a server, which is neither drawn nor updated
+	 * @param gameObject					Object that is checked
+	 * @param builderActive					The player is kept while the scene builder is active
+	 * @return bool							true if the object has to be skipped
+	 */
+	bool IsHiddenServerPlayer(GameObject* gameObject, const bool& builderActive) const;
+
+	/**
+	 * Release the merged static meshes so they are built again on the next draw,
+	 * needs to be called before any static object is edited or deleted
+	 */
+	void InvalidateStaticBatch() {
+		this->m_staticBatch.ClearBatch();
+		this->m_staticBatchDirty = true;
+	}
+
 	/**
 	 * This method is desined to handle the events from the game objects that
 	 * are at the moment of the update initialised inside the scene
@@ -143,8 +191,12 @@ public:
 	 * Getters and setters
 	 */
 public:
-	inline void AddObjectToScene(GameObject* newGO) { this->gameObjects.push_back(newGO); }
+	inline void AddObjectToScene(GameObject* newGO) { 
+		this->InvalidateStaticBatch();
+		this->gameObjects.push_back(newGO); 
+	}
 	inline void RemoveObjectById(const int& id) {
+		this->InvalidateStaticBatch();
 		// Clears the memory of the specific object instance
 		delete this->gameObjects[id];
 		// Erases the object from the array
@@ -170,6 +222,10 @@ public:
 	}
 	inline const int& GetCurrentLevel() const { return this->m_currentLevel; }
 	inline const std::vector<Light*>& GetSceneLights() const { return this->lights; }
+	inline const RenderQueue& GetRenderQueue() const { return this->m_renderQueue; }
+	inline const unsigned int& GetVisibleObjects() const { return this->m_visibleObjects; }
+	inline const unsigned int& GetVisibleStaticCells() const { return this->m_visibleStaticCells; }
+	inline const StaticBatch& GetStaticBatch() const { return this->m_staticBatch; }
 	inline const Light* GetSceneLightById(const int& id) const { return this->lights[id]; }
 
 	inline void SetCurrentLevel(const int& newLevel) { 
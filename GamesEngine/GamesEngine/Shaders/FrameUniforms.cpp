@@ -0,0 +1,84 @@
+#include "FrameUniforms.h"
+#include "../Utils/RingBuffer.h"
+#include "../Utils/GLStateCache.h"
+#include <algorithm>
+#include <cstring>
+
+FrameUniforms* FrameUniforms::s_frameUniforms = new FrameUniforms();
+
+FrameUniforms::FrameUniforms()
+{
+	this->m_frameData = FrameDataBlock();
+	this->m_frameData.clusterGrid = glm::uvec4(LightClusters::CLUSTERS_X, LightClusters::CLUSTERS_Y, LightClusters::CLUSTERS_Z, 0);
+}
+
+void FrameUniforms::SetCameraData(const Camera& camera)
+{
+	this->m_frameData.viewMatrix = camera.GetView();
+	this->m_frameData.projectionMatrix = camera.GetProjection();
+	this->m_frameData.cameraPos = glm::vec4(camera.GetCurrentActiveTransform()->GetPos(), 1.0f);
+	this->m_dirty = true;
+}
+
+void FrameUniforms::SetLightData(const std::vector<Light*>& lights)
+{
+	for (const Light* light : lights) {
+		if (light->GetType() == LightType::Directional) {
+			this->m_frameData.directionalLightDirection = glm::vec4(light->GetDir(), 0.0f);
+			this->m_frameData.directionalLightAmbient = glm::vec4(light->GetAmbient(), 0.0f);
+			this->m_frameData.directionalLightDiffuse = glm::vec4(light->GetDiffuse(), 0.0f);
+			this->m_frameData.directionalLightSpecular = glm::vec4(light->GetSpecular(), 0.0f);
+			break;
+		}
+	}
+
+	// The clusters follow the camera so the point lights are binned again every frame
+	this->m_lightClusters.Build(lights, this->m_frameData.viewMatrix, this->m_frameData.projectionMatrix);
+	this->m_frameData.clusterGrid.w = this->m_lightClusters.GetLights().size();
+	this->m_frameData.clusterDepth = glm::vec4(this->m_lightClusters.GetSliceScale(), this->m_lightClusters.GetSliceBias(), 0.0f, 0.0f);
+
+	this->m_dirty = true;
+}
+
+void FrameUniforms::BindFrameData()
+{
+	RingBuffer* ringBuffer = RingBuffer::s_frameRingBuffer;
+
+	// The range written in a previous frame gets reused by the ring so it's written again
+	if (this->m_dirty
+		|| this->m_ringGeneration != ringBuffer->GetGeneration()
+		|| this->m_ringFrame != ringBuffer->GetFrameIndex()) {
+		const std::vector<PointLightBlock>& pointLights = this->m_lightClusters.GetLights();
+		const std::vector<ClusterRange>& clusterRanges = this->m_lightClusters.GetClusterRanges();
+		const std::vector<GLuint>& lightIndices = this->m_lightClusters.GetLightIndices();
+
+		// Empty lists still get one element as a range can't be bound with a size of 0
+		this->m_pointLightsSize = std::max<size_t>(pointLights.size(), 1) * sizeof(PointLightBlock);
+		this->m_lightIndicesSize = std::max<size_t>(lightIndices.size(), 1) * sizeof(GLuint);
+
+		// Every range is written again if the ring had to grow in the middle
+		do {
+			this->m_ringGeneration = ringBuffer->GetGeneration();
+
+			this->m_frameDataOffset = ringBuffer->Write(&this->m_frameData, sizeof(FrameDataBlock), ringBuffer->GetUniformAlignment());
+			this->m_clusterRangesOffset = ringBuffer->Write(clusterRanges.data(), clusterRanges.size() * sizeof(ClusterRange), ringBuffer->GetStorageAlignment());
+
+			void* pointLightsData = ringBuffer->Map(this->m_pointLightsSize, ringBuffer->GetStorageAlignment(), this->m_pointLightsOffset);
+			std::memcpy(pointLightsData, pointLights.data(), pointLights.size() * sizeof(PointLightBlock));
+			ringBuffer->Unmap(this->m_pointLightsOffset, this->m_pointLightsSize);
+
+			void* lightIndicesData = ringBuffer->Map(this->m_lightIndicesSize, ringBuffer->GetStorageAlignment(), this->m_lightIndicesOffset);
+			std::memcpy(lightIndicesData, lightIndices.data(), lightIndices.size() * sizeof(GLuint));
+			ringBuffer->Unmap(this->m_lightIndicesOffset, this->m_lightIndicesSize);
+		} while (this->m_ringGeneration != ringBuffer->GetGeneration());
+
+		this->m_ringFrame = ringBuffer->GetFrameIndex();
+		this->m_dirty = false;
+	}
+
+	GLuint buffer = ringBuffer->GetBuffer();
+	GLStateCache::s_stateCache->BindBufferRange(GL_UNIFORM_BUFFER, FrameUniforms::FRAME_DATA_BINDING, buffer, this->m_frameDataOffset, sizeof(FrameDataBlock));
+	GLStateCache::s_stateCache->BindBufferRange(GL_SHADER_STORAGE_BUFFER, FrameUniforms::POINT_LIGHTS_BINDING, buffer, this->m_pointLightsOffset, this->m_pointLightsSize);
+	GLStateCache::s_stateCache->BindBufferRange(GL_SHADER_STORAGE_BUFFER, FrameUniforms::CLUSTER_RANGES_BINDING, buffer, this->m_clusterRangesOffset, LightClusters::NUMBER_CLUSTERS * sizeof(ClusterRange));
+	GLStateCache::s_stateCache->BindBufferRange(GL_SHADER_STORAGE_BUFFER, FrameUniforms::LIGHT_INDICES_BINDING, buffer, this->m_lightIndicesOffset, this->m_lightIndicesSize);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "Light.h"
+#include "LightClusters.h"
+#include "../Utils/Camera.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+ * Mirror of the FrameData uniform block declared in every shader ( std140 layout )
+ * vec3 members are stored as vec4 as std140 aligns them to 16 bytes anyway
+ */
+struct FrameDataBlock {
+	glm::mat4 viewMatrix;
+	glm::mat4 projectionMatrix;
+	glm::vec4 cameraPos;
+
+	glm::vec4 directionalLightDirection;
+	glm::vec4 directionalLightAmbient;
+	glm::vec4 directionalLightDiffuse;
+	glm::vec4 directionalLightSpecular;
+
+	glm::uvec4 clusterGrid;					// xyz = number of clusters, w = number of visible point lights
+	glm::vec4 clusterDepth;					// x = slice scale, y = slice bias ( see LightClusters )
+};
+
+class FrameUniforms {
+private:
+	// CPU copy of the block that gets written when something changed
+	FrameDataBlock m_frameData;
+	bool m_dirty = true;
+
+	// Point lights binned for the current view, streamed through storage blocks
+	LightClusters m_lightClusters;
+
+	// Range of the frame ring buffer holding the last written block
+	GLintptr m_frameDataOffset = 0;
+	GLintptr m_pointLightsOffset = 0;
+	GLintptr m_clusterRangesOffset = 0;
+	GLintptr m_lightIndicesOffset = 0;
+	GLsizeiptr m_pointLightsSize = 0;
+	GLsizeiptr m_lightIndicesSize = 0;
+	unsigned int m_ringGeneration = 0;
+	unsigned int m_ringFrame = 0;
+
+public:
+	/**
+	 * Singletone for the frame uniforms to be accesable from everywhere
+	 */
+	static FrameUniforms* s_frameUniforms;
+
+	// Binding point of the FrameData block inside every program
+	static const GLuint FRAME_DATA_BINDING = 0;
+
+	// Binding points of the clustered light storage blocks
+	static const GLuint POINT_LIGHTS_BINDING = 2;
+	static const GLuint CLUSTER_RANGES_BINDING = 3;
+	static const GLuint LIGHT_INDICES_BINDING = 4;
+
+	FrameUniforms();
+	~FrameUniforms() {}
+
+	/**
+	 * Copy the camera matrices and position into the frame data
+	 * @param camera						Camera used to render the current frame
+	 */
+	void SetCameraData(const Camera& camera);
+
+	/**
+	 * Copy the first directional light into the frame data and bin the point lights into
+	 * the clusters of the camera staged by SetCameraData
+	 * @param lights						Lights present in the scene that is drawn
+	 */
+	void SetLightData(const std::vector<Light*>& lights);
+
+	/**
+	 * Write the frame data and the light clusters in the frame ring buffer if they changed
+	 * since the last write and bind their ranges so all programs can read them
+	 */
+	void BindFrameData();
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline const FrameDataBlock& GetFrameData() const { return this->m_frameData; }
+	inline const LightClusters& GetLightClusters() const { return this->m_lightClusters; }
+};
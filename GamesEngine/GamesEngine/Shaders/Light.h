@@ -41,13 +41,6 @@ public:
 	}
 	~Light() {}
 
-	/**
-	 * Set to the created program the uniform necesarry for the shader
-	 * to build up the fragmentCol based on the lights present in the scene
-	 * @param shader					The program that was bound to this specific shader
-	 */
-	void SetUniforms(Shader* shader);
-
 	/**
 	 * Getters and setters
 	 */
@@ -60,6 +53,9 @@ public:
 	inline const LightType& GetType() const { return this->m_lightType; }
 	inline const float& GetRadius() const { return this->m_radius; }
 	inline const float& GetIntesity() const { return this->m_intensity; }
+	inline const float& GetConstant() const { return this->m_kc; }
+	inline const float& GetLinear() const { return this->m_kl; }
+	inline const float& GetQuadratic() const { return this->m_kq; }
 
 	inline void SetDiffuse(const glm::vec3& newDiff) { this->m_diffuse = newDiff; }
 	inline void SetAmbient(const glm::vec3& newAmbient) { this->m_ambient = newAmbient; }
@@ -0,0 +1,126 @@
+#include "LightClusters.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+void LightClusters::Build(const std::vector<Light*>& lights, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix)
+{
+	this->m_lights.clear();
+	this->m_lightBounds.clear();
+	this->m_lightIndices.clear();
+
+	// Planes of a perspective projection, P[2][2] = -( f + n ) / ( f - n ) and P[3][2] = -2fn / ( f - n )
+	float nearPlane = projectionMatrix[3][2] / (projectionMatrix[2][2] - 1.0f);
+	float farPlane = projectionMatrix[3][2] / (projectionMatrix[2][2] + 1.0f);
+
+	float depthRange = std::log(farPlane / nearPlane);
+	this->m_sliceScale = LightClusters::CLUSTERS_Z / depthRange;
+	this->m_sliceBias = LightClusters::CLUSTERS_Z * std::log(nearPlane) / depthRange;
+
+	for (ClusterRange& range : this->m_clusterRanges) {
+		range.count = 0;
+	}
+
+	// Keep the lights that reach the view and count how many lights land in each cluster
+	for (const Light* light : lights) {
+		if (light->GetType() != LightType::Point) {
+			continue;
+		}
+
+		glm::vec3 center = glm::vec3(viewMatrix * glm::vec4(light->GetPos(), 1.0f));
+		ClusterBounds bounds;
+		if (!this->FindClusterBounds(center, light->GetRadius(), projectionMatrix, nearPlane, farPlane, bounds)) {
+			continue;
+		}
+
+		this->m_lights.push_back({
+			glm::vec4(light->GetPos(), light->GetRadius()),
+			glm::vec4(light->GetDiffuse(), light->GetIntesity()),
+			glm::vec4(light->GetAmbient(), 0.0f),
+			glm::vec4(light->GetSpecular(), 0.0f),
+			glm::vec4(light->GetConstant(), light->GetLinear(), light->GetQuadratic(), 0.0f)
+		});
+		this->m_lightBounds.push_back(bounds);
+
+		for (unsigned int z = bounds.min[2]; z <= bounds.max[2]; z++) {
+			for (unsigned int y = bounds.min[1]; y <= bounds.max[1]; y++) {
+				for (unsigned int x = bounds.min[0]; x <= bounds.max[0]; x++) {
+					this->m_clusterRanges[x + LightClusters::CLUSTERS_X * (y + LightClusters::CLUSTERS_Y * z)].count++;
+				}
+			}
+		}
+	}
+
+	// Place the lists of the clusters one after the other
+	GLuint offset = 0;
+	for (ClusterRange& range : this->m_clusterRanges) {
+		range.offset = offset;
+		offset += range.count;
+		range.count = 0;
+	}
+	this->m_lightIndices.resize(offset);
+
+	for (GLuint i = 0; i < this->m_lightBounds.size(); i++) {
+		const ClusterBounds& bounds = this->m_lightBounds[i];
+
+		for (unsigned int z = bounds.min[2]; z <= bounds.max[2]; z++) {
+			for (unsigned int y = bounds.min[1]; y <= bounds.max[1]; y++) {
+				for (unsigned int x = bounds.min[0]; x <= bounds.max[0]; x++) {
+					ClusterRange& range = this->m_clusterRanges[x + LightClusters::CLUSTERS_X * (y + LightClusters::CLUSTERS_Y * z)];
+					this->m_lightIndices[range.offset + range.count] = i;
+					range.count++;
+				}
+			}
+		}
+	}
+}
+
+bool LightClusters::FindClusterBounds(const glm::vec3& center, const float& radius, const glm::mat4& projectionMatrix,
+	const float& nearPlane, const float& farPlane, ClusterBounds& bounds) const
+{
+	// The camera looks down -z so the depth is the negated z
+	float minDepth = -center.z - radius;
+	float maxDepth = -center.z + radius;
+	if (maxDepth < nearPlane || minDepth > farPlane) {
+		return false;
+	}
+	minDepth = std::max(minDepth, nearPlane);
+	maxDepth = std::min(maxDepth, farPlane);
+
+	// Project the corners of the box around the part of the sphere in front of the near plane
+	glm::vec2 minNdc(FLT_MAX), maxNdc(-FLT_MAX);
+	for (unsigned int corner = 0; corner < 8; corner++) {
+		glm::vec4 viewCorner(
+			center.x + ((corner & 1) ? radius : -radius),
+			center.y + ((corner & 2) ? radius : -radius),
+			(corner & 4) ? -maxDepth : -minDepth,
+			1.0f);
+
+		glm::vec4 clipCorner = projectionMatrix * viewCorner;
+		glm::vec2 ndcCorner = glm::vec2(clipCorner) / clipCorner.w;
+		minNdc = glm::min(minNdc, ndcCorner);
+		maxNdc = glm::max(maxNdc, ndcCorner);
+	}
+
+	if (maxNdc.x < -1.0f || maxNdc.y < -1.0f || minNdc.x > 1.0f || minNdc.y > 1.0f) {
+		return false;
+	}
+
+	glm::vec2 gridSize = glm::vec2(LightClusters::CLUSTERS_X, LightClusters::CLUSTERS_Y);
+	glm::vec2 minTile = glm::clamp((minNdc * 0.5f + 0.5f) * gridSize, glm::vec2(0.0f), gridSize - 1.0f);
+	glm::vec2 maxTile = glm::clamp((maxNdc * 0.5f + 0.5f) * gridSize, glm::vec2(0.0f), gridSize - 1.0f);
+
+	bounds.min[0] = (unsigned int)minTile.x;
+	bounds.min[1] = (unsigned int)minTile.y;
+	bounds.min[2] = this->GetSlice(minDepth);
+	bounds.max[0] = (unsigned int)maxTile.x;
+	bounds.max[1] = (unsigned int)maxTile.y;
+	bounds.max[2] = this->GetSlice(maxDepth);
+	return true;
+}
+
+unsigned int LightClusters::GetSlice(const float& depth) const
+{
+	float slice = std::log(depth) * this->m_sliceScale - this->m_sliceBias;
+	return (unsigned int)glm::clamp(slice, 0.0f, (float)(LightClusters::CLUSTERS_Z - 1));
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include "Light.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+ * Mirror of the PointLight struct of the PointLights storage block ( std430 )
+ */
+struct PointLightBlock {
+	glm::vec4 position;			// w = radius
+	glm::vec4 diffuse;			// w = intensity
+	glm::vec4 ambient;
+	glm::vec4 specular;
+	glm::vec4 attenuation;		// x = constant, y = linear, z = quadratic
+};
+
+/**
+ * Range of the light index list used by a single cluster ( uvec2 in the shader )
+ */
+struct ClusterRange {
+	GLuint offset;
+	GLuint count;
+};
+
+/**
+ * Clustered assignment of the point lights, the view frustum is split in a CLUSTERS_X x CLUSTERS_Y
+ * grid on screen and CLUSTERS_Z exponential slices in depth, every point light is binned into the
+ * clusters its radius reaches so a fragment only loops over the lights of its own cluster
+ * The result is laid out as the storage blocks read by the Phong shader: the visible lights,
+ * one range per cluster and the flat list of light indices the ranges point into
+ */
+class LightClusters {
+public:
+	static const unsigned int CLUSTERS_X = 16;
+	static const unsigned int CLUSTERS_Y = 9;
+	static const unsigned int CLUSTERS_Z = 24;
+	static const unsigned int NUMBER_CLUSTERS = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+
+private:
+	/**
+	 * Clusters covered by a light, inclusive on both ends
+	 */
+	struct ClusterBounds {
+		unsigned int min[3];
+		unsigned int max[3];
+	};
+
+	std::vector<PointLightBlock> m_lights;
+	std::vector<ClusterBounds> m_lightBounds;
+	std::vector<ClusterRange> m_clusterRanges;
+	std::vector<GLuint> m_lightIndices;
+
+	// Depth slice = log( view depth ) * m_sliceScale - m_sliceBias
+	float m_sliceScale = 0.0f;
+	float m_sliceBias = 0.0f;
+
+public:
+	LightClusters() : m_clusterRanges(NUMBER_CLUSTERS, ClusterRange{ 0, 0 }) {}
+	~LightClusters() {}
+
+	/**
+	 * Bin the point lights of a scene into the clusters of the current view
+	 * @param lights							Lights present in the scene that is drawn
+	 * @param viewMatrix						View matrix of the camera
+	 * @param projectionMatrix					Perspective projection of the camera
+	 */
+	void Build(const std::vector<Light*>& lights, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix);
+
+private:
+	/**
+	 * Find the clusters a sphere in view space overlaps
+	 * @param center							Centre of the light in view space
+	 * @param radius							Radius of the light
+	 * @param projectionMatrix					Perspective projection of the camera
+	 * @param nearPlane							Distance of the near plane
+	 * @param farPlane							Distance of the far plane
+	 * @param bounds							Clusters covered by the light
+	 * @return bool								false if the light is outside of the frustum
+	 */
+	bool FindClusterBounds(const glm::vec3& center, const float& radius, const glm::mat4& projectionMatrix,
+		const float& nearPlane, const float& farPlane, ClusterBounds& bounds) const;
+
+	/**
+	 * Depth slice of a distance along the view direction
+	 * @param depth								Positive distance in front of the camera
+	 * @return unsigned int						Slice clamped to the grid
+	 */
+	unsigned int GetSlice(const float& depth) const;
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline const std::vector<PointLightBlock>& GetLights() const { return this->m_lights; }
+	inline const std::vector<ClusterRange>& GetClusterRanges() const { return this->m_clusterRanges; }
+	inline const std::vector<GLuint>& GetLightIndices() const { return this->m_lightIndices; }
+	inline const float& GetSliceScale() const { return this->m_sliceScale; }
+	inline const float& GetSliceBias() const { return this->m_sliceBias; }
+};
@@ -1,92 +1,163 @@
 #include "Shader.h"
+#include "FrameUniforms.h"
+#include "../Utils/GLStateCache.h"
+#include "../Utils/Hash.h"
+#include <sstream>
+#include <cstdint>
+
+#define _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
+#include <experimental/filesystem>
+
+const std::string Shader::BinaryCacheFolder = "Resources/ShaderCache/";
 
 std::vector<std::string> Shader::ShaderComponent = {
 	"Empty",
 	"Flat",
-	"Phong"
+	"Phong",
+	"SkyBox"
 };
 
-Shader::Shader(const ShaderType& shaderType)
+Shader::Shader(const ShaderType& shaderType, const std::vector<std::string>& defines)
 {
 	// Create a shader program
 	this->m_programId = glCreateProgram();
 
 	// Set the type of the current generated shader
 	this->m_shaderType = shaderType;
+	this->m_defines = defines;
 
-	// Attach a vertex shader to the m_shader[0]
-	this->m_shaders[0] = CreateShader(LoadShader("Resources/Shaders/" + Shader::ShaderComponent[shaderType] + "/VertexShader.glsl"), GL_VERTEX_SHADER);
-
-	// Check compile test for vertexshader
-	Shader::CheckCompileShader(this->m_shaders[0]);
+	// The binary loaded from the cache doesn't have any shader objects attached
+	for (unsigned int i = 0; i < Shader::NUMBER_SHADER; i++)
+	{
+		this->m_shaders[i] = 0;
+	}
 
-	// Attach a fragment shader to the m_shader[1]
-	this->m_shaders[1] = CreateShader(LoadShader("Resources/Shaders/" + Shader::ShaderComponent[shaderType] + "/FragmentShader.glsl"), GL_FRAGMENT_SHADER);
+	// Load the sources before anything else as they are part of the cache key
+	std::string vertexSource = InjectDefines(LoadShader("Resources/Shaders/" + Shader::ShaderComponent[shaderType] + "/VertexShader.glsl"), defines);
+	std::string fragmentSource = InjectDefines(LoadShader("Resources/Shaders/" + Shader::ShaderComponent[shaderType] + "/FragmentShader.glsl"), defines);
 
-	// Check compile test for fragment shader
-	Shader::CheckCompileShader(this->m_shaders[1]);
+	std::string cacheFileName = Shader::GetBinaryCacheFileName(vertexSource, fragmentSource, defines);
 
-	// Attach shader to the shader program for both of the shaders
-	for (unsigned int i = 0; i < Shader::NUMBER_SHADER; i++)
+	// Try to skip the compilation entirely by using the program from the previous run
+	if (!this->LoadProgramBinary(cacheFileName))
 	{
-		glAttachShader(this->m_programId, this->m_shaders[i]);
-	}
+		// Attach a vertex shader to the m_shader[0]
+		this->m_shaders[0] = CreateShader(vertexSource, GL_VERTEX_SHADER);
+
+		// Check compile test for vertexshader
+		Shader::CheckCompileShader(this->m_shaders[0]);
+
+		// Attach a fragment shader to the m_shader[1]
+		this->m_shaders[1] = CreateShader(fragmentSource, GL_FRAGMENT_SHADER);
+
+		// Check compile test for fragment shader
+		Shader::CheckCompileShader(this->m_shaders[1]);
+
+		// Attach shader to the shader program for both of the shaders
+		for (unsigned int i = 0; i < Shader::NUMBER_SHADER; i++)
+		{
+			glAttachShader(this->m_programId, this->m_shaders[i]);
+		}
+
+		// Let the driver know that the binary will be retrieved after the link
+		if (Shader::IsBinaryCacheSupported())
+		{
+			glProgramParameteri(this->m_programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+
+		// Link the shaders with the final program
+		glLinkProgram(this->m_programId);
 
-	// Link the shaders with the final program
-	glLinkProgram(this->m_programId);
+		// Validate all the shaders in order to compile with the program
+		glValidateProgram(this->m_programId);
 
-	// Validate all the shaders in order to compile with the program
-	glValidateProgram(this->m_programId);
+		// Store the linked program so the next run can skip the compilation
+		this->SaveProgramBinary(cacheFileName);
+	}
 
-	// Give acces to the transform uniform in vertex shader
-	this->m_uniforms[VIEW_U] = glGetUniformLocation(this->m_programId, "viewMatrix");
-	this->m_uniforms[PROJECTION_U] = glGetUniformLocation(this->m_programId, "projectionMatrix");
-	this->m_uniforms[MODEL_U] = glGetUniformLocation(this->m_programId, "modelMatrix");
-	this->m_uniforms[CAMERA_POS] = glGetUniformLocation(this->m_programId, "cameraPos");
+	// Give acces to the uniforms so nothing has to be looked up by name while drawing
+	this->ResolveUniforms();
 }
 
 Shader::~Shader()
 {
 	for (unsigned int i = 0; i < Shader::NUMBER_SHADER; i++)
 	{
-		glDetachShader(this->m_programId, this->m_shaders[i]);
-		glDeleteShader(this->m_shaders[i]);
+		if (this->m_shaders[i] != 0)
+		{
+			glDetachShader(this->m_programId, this->m_shaders[i]);
+			glDeleteShader(this->m_shaders[i]);
+		}
 	}
+	GLStateCache::s_stateCache->OnProgramDeleted(this->m_programId);
 	glDeleteProgram(this->m_programId);
 }
 
 void Shader::BindShader()
 {
-	glUseProgram(this->m_programId);
+	GLStateCache::s_stateCache->UseProgram(this->m_programId);
 }
 
 void Shader::UnbindShader() {
-	glUseProgram(0);
+	GLStateCache::s_stateCache->UseProgram(0);
 }
 
-void Shader::UpdateShader(const Transform& transform, Camera& camera, bool checkRotation)
+void Shader::ResolveUniforms()
 {
-	glUniformMatrix4fv(this->m_uniforms[VIEW_U], 1, GL_FALSE, &camera.GetView()[0][0]);
-	glUniformMatrix4fv(this->m_uniforms[PROJECTION_U], 1, GL_FALSE, &camera.GetProjection()[0][0]);
-	glUniformMatrix4fv(this->m_uniforms[MODEL_U], 1, GL_FALSE, &transform.ModelMatrix(checkRotation)[0][0]);
-	glUniform3fv(this->m_uniforms[CAMERA_POS], 1, glm::value_ptr(camera.GetCurrentActiveTransform()->GetPos()));
+	// Every program reads the camera and the lights from the same uniform buffer
+	GLuint frameDataIndex = glGetUniformBlockIndex(this->m_programId, "FrameData");
+	if (frameDataIndex != GL_INVALID_INDEX) {
+		glUniformBlockBinding(this->m_programId, frameDataIndex, FrameUniforms::FRAME_DATA_BINDING);
+	}
+
+	// The material parameters are streamed per draw bucket into the MaterialData block
+	GLuint materialDataIndex = glGetUniformBlockIndex(this->m_programId, "MaterialData");
+	if (materialDataIndex != GL_INVALID_INDEX) {
+		glUniformBlockBinding(this->m_programId, materialDataIndex, Shader::MATERIAL_DATA_BINDING);
+	}
+
+	// Sampler names of each shader type
+	const char* samplerUniforms[NUMBER_TEXTURE_UNITS] = { nullptr, nullptr, nullptr, nullptr };
+	switch (this->m_shaderType) {
+	case ShaderType::EMPTY:
+		samplerUniforms[DIFFUSE_UNIT] = "diffuse";
+		break;
+	case ShaderType::FLAT:
+		samplerUniforms[DIFFUSE_UNIT] = "diffuse";
+		break;
+	case ShaderType::PHONG:
+		samplerUniforms[DIFFUSE_UNIT] = "material.diffuseMap";
+		samplerUniforms[SPECULAR_UNIT] = "material.specularMap";
+		samplerUniforms[BUMP_UNIT] = "material.bumpMap";
+		samplerUniforms[EMISSION_UNIT] = "material.emissionMap";
+		break;
+	case ShaderType::SKYBOX:
+		samplerUniforms[DIFFUSE_UNIT] = "skyBox";
+		break;
+	}
+
+	// Sampler values are part of the program state so they only need to be set once
+	GLStateCache::s_stateCache->UseProgram(this->m_programId);
+	for (unsigned int i = 0; i < NUMBER_TEXTURE_UNITS; i++) {
+		if (samplerUniforms[i] != nullptr) {
+			glUniform1i(glGetUniformLocation(this->m_programId, samplerUniforms[i]), i);
+		}
+	}
+	GLStateCache::s_stateCache->UseProgram(0);
 }
 
 std::string Shader::LoadShader(const std::string& fileName)
 {
-	std::ifstream file;
-	file.open((fileName).c_str());
+	std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
 
 	std::string output;
-	std::string line;
 
 	if (file.is_open())
 	{
-		while (file.good())
-		{
-			getline(file, line);
-			output.append(line + "\n");
-		}
+		// Read the whole file in one go instead of line by line
+		std::stringstream buffer;
+		buffer << file.rdbuf();
+		output = buffer.str();
 	}
 	else
 	{
@@ -96,6 +167,31 @@ std::string Shader::LoadShader(const std::string& fileName)
 	return output;
 }
 
+std::string Shader::InjectDefines(const std::string& text, const std::vector<std::string>& defines)
+{
+	if (defines.empty()) {
+		return text;
+	}
+
+	std::string definesBlock;
+	for (const std::string& define : defines) {
+		definesBlock += "#define " + define + "\n";
+	}
+
+	// The version directive has to stay the first statement of the shader
+	size_t versionPosition = text.find("#version");
+	if (versionPosition == std::string::npos) {
+		return definesBlock + text;
+	}
+
+	size_t lineEnd = text.find('\n', versionPosition);
+	if (lineEnd == std::string::npos) {
+		return text + "\n" + definesBlock;
+	}
+
+	return text.substr(0, lineEnd + 1) + definesBlock + text.substr(lineEnd + 1);
+}
+
 GLuint Shader::CreateShader(const std::string& text, GLenum shaderType)
 {
 	// Create a shader
@@ -126,4 +222,134 @@ void Shader::CheckCompileShader(GLuint shader)
 	if (result == GL_FALSE) {
 		std::cout << &vertShaderError[0] << std::endl;
 	}
+}
+
+bool Shader::IsBinaryCacheSupported()
+{
+	// Program binaries are core from 4.1 and a driver can still expose no formats at all
+	if (!GLAD_GL_VERSION_4_1)
+	{
+		return false;
+	}
+
+	GLint numberFormats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numberFormats);
+
+	return numberFormats > 0;
+}
+
+std::string Shader::GetBinaryCacheFileName(const std::string& vertexSource, const std::string& fragmentSource, const std::vector<std::string>& defines)
+{
+	// A driver update invalidates every binary so the driver is part of the key
+	std::string driverString;
+	const GLubyte* glStrings[] = { glGetString(GL_VENDOR), glGetString(GL_RENDERER), glGetString(GL_VERSION) };
+	for (const GLubyte* glString : glStrings)
+	{
+		if (glString != nullptr)
+		{
+			driverString.append(reinterpret_cast<const char*>(glString));
+		}
+		driverString.push_back('|');
+	}
+
+	// 64bit FNV-1a hash of everything that has an effect on the final binary
+	uint64_t hash = Hash::FNV_OFFSET_BASIS;
+	auto hashString = [&hash](const std::string& text) {
+		// Separator so the strings can't run into each other
+		const unsigned char separator = 0xFF;
+		hash = Hash::Fnv1a(text, hash);
+		hash = Hash::Fnv1a(&separator, sizeof(separator), hash);
+	};
+
+	hashString(vertexSource);
+	hashString(fragmentSource);
+	for (const std::string& define : defines)
+	{
+		hashString(define);
+	}
+	hashString(driverString);
+
+	std::stringstream fileName;
+	fileName << Shader::BinaryCacheFolder << std::hex << hash << ".bin";
+
+	return fileName.str();
+}
+
+bool Shader::LoadProgramBinary(const std::string& fileName)
+{
+	if (!Shader::IsBinaryCacheSupported())
+	{
+		return false;
+	}
+
+	std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	// File layout: binary format ( GLenum ) followed by the binary itself
+	GLenum binaryFormat = 0;
+	file.read(reinterpret_cast<char*>(&binaryFormat), sizeof(GLenum));
+
+	std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	if (binary.empty())
+	{
+		return false;
+	}
+
+	glProgramBinary(this->m_programId, binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+	// The driver is allowed to reject any binary so the link status has to be checked
+	GLint linkStatus = GL_FALSE;
+	glGetProgramiv(this->m_programId, GL_LINK_STATUS, &linkStatus);
+	if (linkStatus == GL_FALSE)
+	{
+		std::cout << "WARNING: Shader binary rejected, compiling from source -> " << fileName << std::endl;
+
+		// Start from a clean program so the source compilation doesn't inherit anything
+		GLStateCache::s_stateCache->OnProgramDeleted(this->m_programId);
+		glDeleteProgram(this->m_programId);
+		this->m_programId = glCreateProgram();
+
+		return false;
+	}
+
+	return true;
+}
+
+void Shader::SaveProgramBinary(const std::string& fileName)
+{
+	if (!Shader::IsBinaryCacheSupported())
+	{
+		return;
+	}
+
+	GLint linkStatus = GL_FALSE;
+	glGetProgramiv(this->m_programId, GL_LINK_STATUS, &linkStatus);
+
+	GLint binaryLength = 0;
+	glGetProgramiv(this->m_programId, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+	if (linkStatus == GL_FALSE || binaryLength <= 0)
+	{
+		return;
+	}
+
+	GLenum binaryFormat = 0;
+	std::vector<char> binary(binaryLength);
+	glGetProgramBinary(this->m_programId, binaryLength, nullptr, &binaryFormat, binary.data());
+
+	namespace fs = std::experimental::filesystem;
+	std::error_code errorCode;
+	fs::create_directories(Shader::BinaryCacheFolder, errorCode);
+
+	std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR: Cannot write the shader binary cache -> " << fileName << std::endl;
+		return;
+	}
+
+	file.write(reinterpret_cast<const char*>(&binaryFormat), sizeof(GLenum));
+	file.write(binary.data(), binary.size());
 }
\ No newline at end of file
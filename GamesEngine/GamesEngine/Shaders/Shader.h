@@ -1,6 +1,7 @@
 #pragma once
 #include "../Utils/Camera.h"
 #include "../Mathematics/Transform.h"
+#include "../Objects/Texture.h"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -10,32 +11,58 @@
 #include <string>
 
 enum ShaderType {
-	EMPTY, FLAT, PHONG
+	EMPTY, FLAT, PHONG, SKYBOX
 };
 
 class Shader
 {
-private:
-	enum
+public:
+	// Fixed texture unit of each texture type, the samplers are set only once after the link
+	enum TextureUnit
 	{
-		VIEW_U,
-		PROJECTION_U,
-		MODEL_U,
-		CAMERA_POS,
+		DIFFUSE_UNIT,
+		SPECULAR_UNIT,
+		BUMP_UNIT,
+		EMISSION_UNIT,
 
-		NUMBER_UNIFORMS
+		NUMBER_TEXTURE_UNITS
 	};
 
+private:
 	static const unsigned int NUMBER_SHADER = 2;
 	GLuint m_shaders[NUMBER_SHADER];
-	GLuint m_uniforms[NUMBER_UNIFORMS];
 	GLuint m_programId;
 
 	ShaderType m_shaderType;
 
+	// Preprocessor defines the program was compiled with
+	std::vector<std::string> m_defines;
+
 public:
 	static std::vector<std::string> ShaderComponent;
 
+	// Folder where the linked programs are stored between runs
+	static const std::string BinaryCacheFolder;
+
+	// Binding point of the MaterialData block ( see MaterialDataBlock )
+	static const GLuint MATERIAL_DATA_BINDING = 1;
+
+	static int GetTextureUnit(const TextureType& textureType) {
+		switch (textureType) {
+		case TextureType::DIFFUSE:
+			return TextureUnit::DIFFUSE_UNIT;
+		case TextureType::SPECULAR:
+			return TextureUnit::SPECULAR_UNIT;
+		case TextureType::NORMAL:
+		case TextureType::BUMP:
+			return TextureUnit::BUMP_UNIT;
+		case TextureType::EMISSIVE:
+			return TextureUnit::EMISSION_UNIT;
+		default:
+			return -1;
+		}
+	}
+
 	static ShaderType ConvertIntToType(const int& id) {
 		switch (id) {
 		case 0:
@@ -47,7 +74,7 @@ public:
 		}
 	}
 
-	Shader(const ShaderType& shaderType);
+	Shader(const ShaderType& shaderType, const std::vector<std::string>& defines = {});
 	~Shader();
 
 	/**
@@ -61,12 +88,10 @@ public:
 	void UnbindShader();
 
 	/**
-	 * Updates the shader according with the transform matrix
-	 * @param transform			value of each object used as position info
-	 * @param camera			camera position used for ray direction on the shader
-	 * @param checkRotation		rotation axis ( false => own axis, true => origin )
+	 * Resolve the FrameData and MaterialData block bindings and the sampler units
+	 * once after the program has been linked ( or loaded from the binary cache )
 	 */
-	void UpdateShader(const Transform& transform, Camera& camera, bool checkRotation);
+	void ResolveUniforms();
 
 	/**
 	 * Load the shader from a GLSL file
@@ -75,6 +100,14 @@ public:
 	 */
 	static std::string LoadShader(const std::string& fileName);
 
+	/**
+	 * Insert the preprocessor defines right after the version directive of the shader
+	 * @param text				loaded shader from the external file
+	 * @param defines			names of the defines that need to be added
+	 * @return string			the shader source specialised with the defines
+	 */
+	static std::string InjectDefines(const std::string& text, const std::vector<std::string>& defines);
+
 	/**
 	 * Creates and compiles the shader
 	 * @param text				loaded shader from the external file
@@ -89,7 +122,34 @@ public:
 	 */
 	static void CheckCompileShader(GLuint shader);
 
-	
+	/**
+	 * Check if the driver is able to save and load linked program binaries
+	 * @return bool				true if glGetProgramBinary/glProgramBinary can be used
+	 */
+	static bool IsBinaryCacheSupported();
+
+	/**
+	 * Build the cache file name from a hash of everything that affects the final binary
+	 * @param vertexSource		final source of the vertex shader ( defines included )
+	 * @param fragmentSource	final source of the fragment shader ( defines included )
+	 * @param defines			defines the program was specialised with
+	 * @return string			path of the binary inside BinaryCacheFolder
+	 */
+	static std::string GetBinaryCacheFileName(const std::string& vertexSource, const std::string& fragmentSource, const std::vector<std::string>& defines);
+
+	/**
+	 * Load a previously linked program into m_programId
+	 * @param fileName			path of the cached binary
+	 * @return bool				false if there is no binary or the driver rejected it
+	 */
+	bool LoadProgramBinary(const std::string& fileName);
+
+	/**
+	 * Store the linked program of m_programId on the disk
+	 * @param fileName			path of the cached binary
+	 */
+	void SaveProgramBinary(const std::string& fileName);
+
 
 	/**
 	 * Getters and Setters
@@ -97,6 +157,7 @@ public:
 public:
 	inline const GLuint& GetProgramID() const { return this->m_programId; }
 	inline const ShaderType& GetShaderType() const { return this->m_shaderType; }
+	inline const std::vector<std::string>& GetDefines() const { return this->m_defines; }
 
 	inline void SetProgramID(const GLuint& newProgramID) { this->m_programId = newProgramID; }
 	inline void SetShaderType(const ShaderType& newShaderType) { this->m_shaderType = newShaderType; }
@@ -0,0 +1,39 @@
+#include "ShaderLibrary.h"
+#include <algorithm>
+
+ShaderLibrary* ShaderLibrary::s_shaderLibrary = new ShaderLibrary();
+
+std::shared_ptr<Shader> ShaderLibrary::GetShader(const ShaderType& shaderType, const std::vector<std::string>& defines) {
+	// Sort the defines so the order they were requested in doesn't create duplicate programs
+	std::vector<std::string> sortedDefines = defines;
+	std::sort(sortedDefines.begin(), sortedDefines.end());
+	sortedDefines.erase(std::unique(sortedDefines.begin(), sortedDefines.end()), sortedDefines.end());
+
+	std::string definesKey;
+	for (const std::string& define : sortedDefines) {
+		definesKey += define + ";";
+	}
+
+	ProgramKey key(shaderType, definesKey);
+	auto it = this->m_programs.find(key);
+	if (it != this->m_programs.end()) {
+		return it->second;
+	}
+
+	std::shared_ptr<Shader> newShader = std::make_shared<Shader>(shaderType, sortedDefines);
+	this->m_programs.insert({ key, newShader });
+
+	return newShader;
+}
+
+void ShaderLibrary::ReleaseUnusedShaders() {
+	for (auto it = this->m_programs.begin(); it != this->m_programs.end();) {
+		// The library itself is the only owner left
+		if (it->second.use_count() == 1) {
+			it = this->m_programs.erase(it);
+		}
+		else {
+			it++;
+		}
+	}
+}
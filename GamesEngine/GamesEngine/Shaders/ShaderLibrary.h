@@ -0,0 +1,53 @@
+#pragma once
+#include "Shader.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ShaderLibrary {
+private:
+	// Key of a program inside the library ( shader type + sorted list of defines )
+	typedef std::pair<ShaderType, std::string> ProgramKey;
+
+	// Every program that has been compiled and linked so far
+	std::map<ProgramKey, std::shared_ptr<Shader>> m_programs;
+
+public:
+	/**
+	 * Singletone for the shader library to be accesable from everywhere
+	 */
+	static ShaderLibrary* s_shaderLibrary;
+
+	ShaderLibrary() {}
+	~ShaderLibrary() {
+		this->ClearLibrary();
+	}
+
+	/**
+	 * Get the program for a specific shader type and set of defines, the program
+	 * is compiled only the first time it's requested and then shared by every material
+	 * @param shaderType						Type of the shader that should be used
+	 * @param defines							Preprocessor defines the program is specialised with
+	 * @return shared_ptr<Shader>				Ref-counted handle to the shared program
+	 */
+	std::shared_ptr<Shader> GetShader(const ShaderType& shaderType, const std::vector<std::string>& defines = {});
+
+	/**
+	 * Delete all the programs that are not referrenced by any material anymore
+	 */
+	void ReleaseUnusedShaders();
+
+	/**
+	 * Delete all the programs from the library ( it has to be called while the context is alive )
+	 */
+	void ClearLibrary() {
+		this->m_programs.clear();
+	}
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline unsigned int GetProgramCount() const { return this->m_programs.size(); }
+};
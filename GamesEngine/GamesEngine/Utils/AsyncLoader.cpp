@@ -0,0 +1,97 @@
+#include "AsyncLoader.h"
+#include <algorithm>
+
+AsyncLoader* AsyncLoader::s_asyncLoader = new AsyncLoader();
+
+constexpr double AsyncLoader::UPLOAD_BUDGET;
+
+namespace {
+	thread_local bool s_isWorkerThread = false;
+}
+
+AsyncLoader::AsyncLoader()
+{
+	// The main thread keeps a core for itself
+	unsigned int workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+	for (unsigned int i = 0; i < workerCount; i++) {
+		this->m_workers.push_back(std::thread(&AsyncLoader::RunWorker, this));
+	}
+}
+
+AsyncLoader::~AsyncLoader()
+{
+	// The work that didn't start is dropped, the workers finish what they're running
+	{
+		std::lock_guard<std::mutex> lock(this->m_workMutex);
+		this->m_work.clear();
+		this->m_stopping = true;
+	}
+	this->m_workAvailable.notify_all();
+
+	for (std::thread& worker : this->m_workers) {
+		worker.join();
+	}
+
+	this->m_jobs.clear();
+}
+
+void AsyncLoader::PushWork(const std::function<void()>& work)
+{
+	{
+		std::lock_guard<std::mutex> lock(this->m_workMutex);
+		this->m_work.push_back(work);
+	}
+	this->m_workAvailable.notify_one();
+}
+
+bool AsyncLoader::IsWorkerThread()
+{
+	return s_isWorkerThread;
+}
+
+void AsyncLoader::RunWorker()
+{
+	s_isWorkerThread = true;
+
+	while (true) {
+		std::function<void()> work;
+		{
+			std::unique_lock<std::mutex> lock(this->m_workMutex);
+			this->m_workAvailable.wait(lock, [this]() { return this->m_stopping || !this->m_work.empty(); });
+			if (this->m_stopping) {
+				return;
+			}
+
+			work = this->m_work.front();
+			this->m_work.pop_front();
+		}
+
+		work();
+	}
+}
+
+void AsyncLoader::ProcessJobs(const double& budgetMilliseconds)
+{
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	this->m_completedJobs = 0;
+
+	unsigned int i = 0;
+	while (i < this->m_jobs.size()) {
+		if (!this->m_jobs[i].isReady()) {
+			i++;
+			continue;
+		}
+
+		// Taken out of the queue first, finishing a load can queue new ones ( e.g. the textures of a model )
+		PendingJob job = this->m_jobs[i];
+		this->m_jobs.erase(this->m_jobs.begin() + i);
+
+		job.complete();
+		this->m_completedJobs++;
+
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+		if (elapsed.count() >= budgetMilliseconds) {
+			break;
+		}
+	}
+}
\ No newline at end of file
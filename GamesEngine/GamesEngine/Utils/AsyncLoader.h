@@ -0,0 +1,111 @@
+#pragma once
+#include <future>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+/**
+ * Queue of the assets that are read and decoded on worker threads, only the last step of
+ * every load ( the upload to the context ) runs on the main thread once per frame and the
+ * steps stop as soon as the frame budget is used up, the others wait for the next frame
+ * The work runs on a fixed set of workers ( one per core besides the main thread ), loads
+ * requested while every worker is busy wait for one of them to be free
+ * The main thread never waits for a worker, the jobs that aren't done yet are skipped
+ */
+class AsyncLoader {
+public:
+	// Time of a frame that can be spent on finishing loads, at least one load finishes per frame
+	static constexpr double UPLOAD_BUDGET = 2.0;
+
+private:
+	/**
+	 * Work that was started on a worker thread and the step that finishes it on the main thread
+	 */
+	struct PendingJob {
+		std::function<bool()> isReady;
+		std::function<void()> complete;
+	};
+
+	std::vector<PendingJob> m_jobs;
+
+	// Loads finished by the last call of ProcessJobs
+	unsigned int m_completedJobs = 0;
+
+	// Work waiting for a free worker
+	std::vector<std::thread> m_workers;
+	std::deque<std::function<void()>> m_work;
+	std::mutex m_workMutex;
+	std::condition_variable m_workAvailable;
+	bool m_stopping = false;
+
+public:
+	/**
+	 * Singletone for the loader to be accesable from everywhere
+	 */
+	static AsyncLoader* s_asyncLoader;
+
+	AsyncLoader();
+	~AsyncLoader();
+
+	AsyncLoader(const AsyncLoader&) = delete;
+	AsyncLoader& operator=(const AsyncLoader&) = delete;
+
+	/**
+	 * Run work on one of the workers, the complete step receives its result on the main thread
+	 * @param work								Work that runs on a worker thread
+	 * @param complete							Step that finishes the load on the main thread
+	 */
+	template<typename T>
+	void Enqueue(const std::function<T()>& work, const std::function<void(T&)>& complete) {
+		std::shared_ptr<std::packaged_task<T()>> task = std::make_shared<std::packaged_task<T()>>(work);
+		std::shared_ptr<std::future<T>> result = std::make_shared<std::future<T>>(task->get_future());
+
+		PendingJob job;
+		job.isReady = [result]() {
+			return result->wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		};
+		job.complete = [result, complete]() {
+			T value = result->get();
+			complete(value);
+		};
+		this->m_jobs.push_back(job);
+
+		this->PushWork([task]() { (*task)(); });
+	}
+
+	/**
+	 * Finish the loads whose workers are done, in the order they were queued, until the budget is used up
+	 * @param budgetMilliseconds				Time that can be spent finishing loads this frame
+	 */
+	void ProcessJobs(const double& budgetMilliseconds = AsyncLoader::UPLOAD_BUDGET);
+
+	/**
+	 * Whether the calling thread is one of the workers, work running on them shouldn't start threads of its own
+	 */
+	static bool IsWorkerThread();
+
+private:
+	/**
+	 * Hand work to the first worker that is free
+	 * @param work								Work that runs on a worker thread
+	 */
+	void PushWork(const std::function<void()>& work);
+
+	/**
+	 * Loop of a worker, runs the queued work until the loader is destroyed
+	 */
+	void RunWorker();
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline unsigned int GetPendingJobs() const { return this->m_jobs.size(); }
+	inline const unsigned int& GetCompletedJobs() const { return this->m_completedJobs; }
+	inline unsigned int GetWorkerCount() const { return this->m_workers.size(); }
+};
\ No newline at end of file
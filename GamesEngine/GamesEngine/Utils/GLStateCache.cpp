@@ -0,0 +1,301 @@
+#include "GLStateCache.h"
+
+GLStateCache* GLStateCache::s_stateCache = new GLStateCache();
+
+void GLStateCache::Invalidate()
+{
+	this->m_program = GLStateCache::UNKNOWN;
+	this->m_vertexArray = GLStateCache::UNKNOWN;
+	this->m_activeUnit = GLStateCache::UNKNOWN;
+
+	for (unsigned int i = 0; i < GLStateCache::MAX_TEXTURE_UNITS; i++) {
+		this->m_textures2D[i] = GLStateCache::UNKNOWN;
+		this->m_texturesCube[i] = GLStateCache::UNKNOWN;
+		this->m_samplers[i] = GLStateCache::UNKNOWN;
+	}
+
+	for (unsigned int i = 0; i < NUMBER_BUFFER_TARGETS; i++) {
+		this->m_buffers[i] = GLStateCache::UNKNOWN;
+	}
+
+	for (unsigned int i = 0; i < GLStateCache::MAX_INDEXED_BINDINGS; i++) {
+		this->m_uniformBindings[i] = { GLStateCache::UNKNOWN, 0, 0 };
+		this->m_storageBindings[i] = { GLStateCache::UNKNOWN, 0, 0 };
+	}
+
+	for (unsigned int i = 0; i < NUMBER_CAPABILITIES; i++) {
+		this->m_capabilities[i] = GLStateCache::UNKNOWN;
+	}
+
+	this->m_depthFunc = GLStateCache::UNKNOWN;
+	this->m_depthMask = GLStateCache::UNKNOWN;
+	this->m_blendSource = GLStateCache::UNKNOWN;
+	this->m_blendDestination = GLStateCache::UNKNOWN;
+}
+
+void GLStateCache::UseProgram(const GLuint& program)
+{
+	if (this->m_program == program) {
+		this->m_eliminatedCalls++;
+		return;
+	}
+
+	glUseProgram(program);
+	this->m_program = program;
+	this->m_issuedCalls++;
+}
+
+void GLStateCache::BindVertexArray(const GLuint& vertexArray)
+{
+	if (this->m_vertexArray == vertexArray) {
+		this->m_eliminatedCalls++;
+		return;
+	}
+
+	glBindVertexArray(vertexArray);
+	this->m_vertexArray = vertexArray;
+	this->m_issuedCalls++;
+}
+
+void GLStateCache::ActiveTexture(const GLuint& unit)
+{
+	if (this->m_activeUnit == unit) {
+		this->m_eliminatedCalls++;
+		return;
+	}
+
+	glActiveTexture(GL_TEXTURE0 + unit);
+	this->m_activeUnit = unit;
+	this->m_issuedCalls++;
+}
+
+void GLStateCache::BindTexture(const GLenum& target, const GLuint& texture)
+{
+	GLuint* boundTextures = target == GL_TEXTURE_2D ? this->m_textures2D
+		: target == GL_TEXTURE_CUBE_MAP ? this->m_texturesCube
+		: nullptr;
+
+	// Without a known active unit there's nothing to compare against
+	if (boundTextures == nullptr || this->m_activeUnit >= GLStateCache::MAX_TEXTURE_UNITS) {
+		glBindTexture(target, texture);
+		this->m_issuedCalls++;
+		return;
+	}
+
+	if (boundTextures[this->m_activeUnit] == texture) {
+		this->m_eliminatedCalls++;
+		return;
+	}
+
+	glBindTexture(target, texture);
+	boundTextures[this->m_activeUnit] = texture;
+	this->m_issuedCalls++;
+}
+
+void GLStateCache::BindTextureUnit(const GLuint& unit, const GLenum& target, const GLuint& texture)
+{
+	if (unit < GLStateCache::MAX_TEXTURE_UNITS) {
+		const GLuint* boundTextures = target == GL_TEXTURE_2D ? this->m_textures2D
+			: target == GL_TEXTURE_CUBE_MAP ? this->m_texturesCube
+			: nullptr;
+
+		// Skip both the unit switch and the bind
+		if (boundTextures != nullptr && boundTextures[unit] == texture) {
+			this->m_eliminatedCalls += 2;
+			return;
+		}
+	}
+
+	this->ActiveTexture(unit);
+	this->BindTexture(target, texture);
+}
+
+void GLStateCache::BindSampler(const GLuint& unit, const GLuint& sampler)
+{
+	if (unit < GLStateCache::MAX_TEXTURE_UNITS) {
+		if (this->m_samplers[unit] == sampler) {
+			this->m_eliminatedCalls++;
+			return;
+		}
+		this->m_samplers[unit] = sampler;
+	}
+
+	glBindSampler(unit, sampler);
+	this->m_issuedCalls++;
+}
+
+void GLStateCache::BindBuffer(const GLenum& target, const GLuint& buffer)
+{
+	int slot = GLStateCache::GetBufferTarget(target);
+	if (slot != -1) {
+		if (this->m_buffers[slot] == buffer) {
+			this->m_eliminatedCalls++;
+			return;
+		}
+		this->m_buffers[slot] = buffer;
+	}
+
+	glBindBuffer(target, buffer);
+	this->m_issuedCalls++;
+}
+
+void GLStateCache::BindBufferRange(const GLenum& target, const GLuint& index, const GLuint& buffer, const GLintptr& offset, const GLsizeiptr& size)
+{
+	IndexedBinding* bindings = target == GL_UNIFORM_BUFFER ? this->m_uniformBindings
+		: target == GL_SHADER_STORAGE_BUFFER ? this->m_storageBindings
+		: nullptr;
+
+	if (bindings != nullptr && index < GLStateCache::MAX_INDEXED_BINDINGS) {
+		IndexedBinding& binding = bindings[index];
+		if (binding.buffer == buffer && binding.offset == offset && binding.size == size) {
+			this->m_eliminatedCalls++;
+			return;
+		}
+		binding = { buffer, offset, size };
+	}
+
+	glBindBufferRange(target, index, buffer, offset, size);
+	this->m_issuedCalls++;
+
+	// The indexed bind replaces the generic binding of the target as well
+	int slot = GLStateCache::GetBufferTarget(target);
+	if (slot != -1) {
+		this->m_buffers[slot] = buffer;
+	}
+}
+
+void GLStateCache::SetCapability(const GLenum& capability, const bool& enabled)
+{
+	int slot = GLStateCache::GetCapability(capability);
+	if (slot != -1) {
+		if (this->m_capabilities[slot] == (enabled ? 1u : 0u)) {
+			this->m_eliminatedCalls++;
+			return;
+		}
+		this->m_capabilities[slot] = enabled ? 1u : 0u;
+	}
+
+	if (enabled) {
+		glEnable(capability);
+	}
+	else {
+		glDisable(capability);
+	}
+	this->m_issuedCalls++;
+}
+
+void GLStateCache::DepthFunc(const GLenum& function)
+{
+	if (this->m_depthFunc == function) {
+		this->m_eliminatedCalls++;
+		return;
+	}
+
+	glDepthFunc(function);
+	this->m_depthFunc = function;
+	this->m_issuedCalls++;
+}
+
+void GLStateCache::DepthMask(const GLboolean& writeEnabled)
+{
+	if (this->m_depthMask == writeEnabled) {
+		this->m_eliminatedCalls++;
+		return;
+	}
+
+	glDepthMask(writeEnabled);
+	this->m_depthMask = writeEnabled;
+	this->m_issuedCalls++;
+}
+
+void GLStateCache::BlendFunc(const GLenum& source, const GLenum& destination)
+{
+	if (this->m_blendSource == source && this->m_blendDestination == destination) {
+		this->m_eliminatedCalls++;
+		return;
+	}
+
+	glBlendFunc(source, destination);
+	this->m_blendSource = source;
+	this->m_blendDestination = destination;
+	this->m_issuedCalls++;
+}
+
+void GLStateCache::OnProgramDeleted(const GLuint& object)
+{
+	// A deleted program stays in use until another one is made current, the name can be reused
+	if (this->m_program == object) {
+		this->m_program = GLStateCache::UNKNOWN;
+	}
+}
+
+void GLStateCache::OnVertexArrayDeleted(const GLuint& object)
+{
+	if (this->m_vertexArray == object) {
+		this->m_vertexArray = 0;
+	}
+}
+
+void GLStateCache::OnBufferDeleted(const GLuint& object)
+{
+	for (unsigned int i = 0; i < NUMBER_BUFFER_TARGETS; i++) {
+		if (this->m_buffers[i] == object) {
+			this->m_buffers[i] = 0;
+		}
+	}
+
+	for (unsigned int i = 0; i < GLStateCache::MAX_INDEXED_BINDINGS; i++) {
+		if (this->m_uniformBindings[i].buffer == object) {
+			this->m_uniformBindings[i] = { 0, 0, 0 };
+		}
+		if (this->m_storageBindings[i].buffer == object) {
+			this->m_storageBindings[i] = { 0, 0, 0 };
+		}
+	}
+}
+
+void GLStateCache::OnTextureDeleted(const GLuint& object)
+{
+	for (unsigned int i = 0; i < GLStateCache::MAX_TEXTURE_UNITS; i++) {
+		if (this->m_textures2D[i] == object) {
+			this->m_textures2D[i] = 0;
+		}
+		if (this->m_texturesCube[i] == object) {
+			this->m_texturesCube[i] = 0;
+		}
+	}
+}
+
+int GLStateCache::GetBufferTarget(const GLenum& target)
+{
+	switch (target) {
+	case GL_ARRAY_BUFFER:
+		return ARRAY_TARGET;
+	case GL_COPY_READ_BUFFER:
+		return COPY_READ_TARGET;
+	case GL_COPY_WRITE_BUFFER:
+		return COPY_WRITE_TARGET;
+	case GL_DRAW_INDIRECT_BUFFER:
+		return DRAW_INDIRECT_TARGET;
+	case GL_UNIFORM_BUFFER:
+		return UNIFORM_TARGET;
+	case GL_SHADER_STORAGE_BUFFER:
+		return SHADER_STORAGE_TARGET;
+	default:
+		return -1;
+	}
+}
+
+int GLStateCache::GetCapability(const GLenum& capability)
+{
+	switch (capability) {
+	case GL_DEPTH_TEST:
+		return DEPTH_TEST_CAP;
+	case GL_BLEND:
+		return BLEND_CAP;
+	case GL_CULL_FACE:
+		return CULL_FACE_CAP;
+	default:
+		return -1;
+	}
+}
@@ -0,0 +1,212 @@
+#pragma once
+#include <glad/glad.h>
+
+/**
+ * Thin layer in front of the GL state setters, it remembers what is bound on the context
+ * and drops the calls that would set the same value again
+ * Every piece of engine code that changes the tracked state has to go through it, code that
+ * bypasses it ( ImGui restores its own state ) leaves the tracked values untouched
+ */
+class GLStateCache {
+public:
+	// Value of a binding that has never been set through the cache
+	static const GLuint UNKNOWN = 0xFFFFFFFF;
+
+	static const unsigned int MAX_TEXTURE_UNITS = 16;
+	static const unsigned int MAX_INDEXED_BINDINGS = 8;
+
+private:
+	/**
+	 * Generic buffer targets that are tracked, the element array buffer is part of the
+	 * VAO state so it's always forwarded
+	 */
+	enum BufferTarget {
+		ARRAY_TARGET,
+		COPY_READ_TARGET,
+		COPY_WRITE_TARGET,
+		DRAW_INDIRECT_TARGET,
+		UNIFORM_TARGET,
+		SHADER_STORAGE_TARGET,
+
+		NUMBER_BUFFER_TARGETS
+	};
+
+	/**
+	 * Capabilities that are tracked with glEnable / glDisable
+	 */
+	enum Capability {
+		DEPTH_TEST_CAP,
+		BLEND_CAP,
+		CULL_FACE_CAP,
+
+		NUMBER_CAPABILITIES
+	};
+
+	/**
+	 * Range bound to an indexed binding point ( uniform blocks, storage blocks )
+	 */
+	struct IndexedBinding {
+		GLuint buffer;
+		GLintptr offset;
+		GLsizeiptr size;
+	};
+
+	GLuint m_program;
+	GLuint m_vertexArray;
+	GLuint m_activeUnit;
+
+	GLuint m_textures2D[MAX_TEXTURE_UNITS];
+	GLuint m_texturesCube[MAX_TEXTURE_UNITS];
+	GLuint m_samplers[MAX_TEXTURE_UNITS];
+
+	GLuint m_buffers[NUMBER_BUFFER_TARGETS];
+	IndexedBinding m_uniformBindings[MAX_INDEXED_BINDINGS];
+	IndexedBinding m_storageBindings[MAX_INDEXED_BINDINGS];
+
+	// 0 disabled, 1 enabled, UNKNOWN if never set
+	GLuint m_capabilities[NUMBER_CAPABILITIES];
+	GLenum m_depthFunc;
+	GLuint m_depthMask;
+	GLenum m_blendSource;
+	GLenum m_blendDestination;
+
+	// Calls forwarded to the driver and calls dropped since the last reset
+	unsigned int m_issuedCalls = 0;
+	unsigned int m_eliminatedCalls = 0;
+
+public:
+	/**
+	 * Singletone for the state of the only context of the engine
+	 */
+	static GLStateCache* s_stateCache;
+
+	GLStateCache() { this->Invalidate(); }
+	~GLStateCache() {}
+
+	/**
+	 * Forget every tracked value so the next call of each setter reaches the driver
+	 */
+	void Invalidate();
+
+	/**
+	 * Equivalent of glUseProgram
+	 * @param program							Program that is made current
+	 */
+	void UseProgram(const GLuint& program);
+
+	/**
+	 * Equivalent of glBindVertexArray
+	 * @param vertexArray						VAO that is bound
+	 */
+	void BindVertexArray(const GLuint& vertexArray);
+
+	/**
+	 * Equivalent of glActiveTexture
+	 * @param unit								Index of the unit ( not GL_TEXTURE0 + unit )
+	 */
+	void ActiveTexture(const GLuint& unit);
+
+	/**
+	 * Equivalent of glBindTexture on the active unit
+	 * @param target							GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP, other targets are forwarded
+	 * @param texture							Texture that is bound
+	 */
+	void BindTexture(const GLenum& target, const GLuint& texture);
+
+	/**
+	 * Bind a texture to a specific unit, the active unit only changes if the texture does
+	 * @param unit								Index of the unit
+	 * @param target							GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP
+	 * @param texture							Texture that is bound
+	 */
+	void BindTextureUnit(const GLuint& unit, const GLenum& target, const GLuint& texture);
+
+	/**
+	 * Equivalent of glBindSampler
+	 * @param unit								Index of the unit
+	 * @param sampler							Sampler object that is bound
+	 */
+	void BindSampler(const GLuint& unit, const GLuint& sampler);
+
+	/**
+	 * Equivalent of glBindBuffer
+	 * @param target							Target of the buffer
+	 * @param buffer							Buffer that is bound
+	 */
+	void BindBuffer(const GLenum& target, const GLuint& buffer);
+
+	/**
+	 * Equivalent of glBindBufferRange, it also sets the generic binding of the target
+	 * @param target							GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER
+	 * @param index								Binding point
+	 * @param buffer							Buffer that is bound
+	 * @param offset							Start of the range
+	 * @param size								Size of the range
+	 */
+	void BindBufferRange(const GLenum& target, const GLuint& index, const GLuint& buffer, const GLintptr& offset, const GLsizeiptr& size);
+
+	/**
+	 * Equivalent of glEnable / glDisable
+	 * @param capability						GL_DEPTH_TEST, GL_BLEND or GL_CULL_FACE, other capabilities are forwarded
+	 * @param enabled							New state of the capability
+	 */
+	void SetCapability(const GLenum& capability, const bool& enabled);
+
+	/**
+	 * Equivalent of glDepthFunc
+	 * @param function							Depth comparison function
+	 */
+	void DepthFunc(const GLenum& function);
+
+	/**
+	 * Equivalent of glDepthMask
+	 * @param writeEnabled						If the depth buffer is written
+	 */
+	void DepthMask(const GLboolean& writeEnabled);
+
+	/**
+	 * Equivalent of glBlendFunc
+	 * @param source							Source factor
+	 * @param destination						Destination factor
+	 */
+	void BlendFunc(const GLenum& source, const GLenum& destination);
+
+	/**
+	 * Deleting an object unbinds it from the context, these keep the tracked values in sync
+	 * @param object							Name of the object that was deleted
+	 */
+	void OnProgramDeleted(const GLuint& object);
+	void OnVertexArrayDeleted(const GLuint& object);
+	void OnBufferDeleted(const GLuint& object);
+	void OnTextureDeleted(const GLuint& object);
+
+	/**
+	 * Restart the counters of the forwarded and dropped calls, called once per frame
+	 */
+	void ResetFrameStats() {
+		this->m_issuedCalls = 0;
+		this->m_eliminatedCalls = 0;
+	}
+
+private:
+	/**
+	 * Map a buffer target to its tracked slot
+	 * @return int								Slot of the target or -1 if it's not tracked
+	 */
+	static int GetBufferTarget(const GLenum& target);
+
+	/**
+	 * Map a capability to its tracked slot
+	 * @return int								Slot of the capability or -1 if it's not tracked
+	 */
+	static int GetCapability(const GLenum& capability);
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline const unsigned int& GetIssuedCalls() const { return this->m_issuedCalls; }
+	inline const unsigned int& GetEliminatedCalls() const { return this->m_eliminatedCalls; }
+	inline const GLuint& GetProgram() const { return this->m_program; }
+	inline const GLuint& GetVertexArray() const { return this->m_vertexArray; }
+};
@@ -0,0 +1,76 @@
+#include "GPUTimer.h"
+#include <iostream>
+
+const std::string GPUTimer::SectionNames[GPUTimer::NUMBER_SECTIONS] = {
+	"GraphicSystem-GPU",
+	"SkyBox-GPU",
+	"GUI-GPU"
+};
+
+GPUTimer::GPUTimer()
+{
+	glGenQueries(GPUTimer::QUERY_FRAMES * GPUTimer::NUMBER_SECTIONS, &this->m_queries[0][0]);
+
+	for (unsigned int frame = 0; frame < GPUTimer::QUERY_FRAMES; frame++) {
+		for (unsigned int section = 0; section < GPUTimer::NUMBER_SECTIONS; section++) {
+			this->m_pendingQueries[frame][section] = false;
+		}
+	}
+	for (unsigned int section = 0; section < GPUTimer::NUMBER_SECTIONS; section++) {
+		this->m_sectionTimes[section] = 0.0f;
+	}
+}
+
+GPUTimer::~GPUTimer()
+{
+	glDeleteQueries(GPUTimer::QUERY_FRAMES * GPUTimer::NUMBER_SECTIONS, &this->m_queries[0][0]);
+}
+
+void GPUTimer::BeginFrame()
+{
+	if (this->m_activeSection != GPUTimer::NUMBER_SECTIONS) {
+		std::cout << "ERROR: GPU profiling of " << GPUTimer::SectionNames[this->m_activeSection] << " was never stopped" << std::endl;
+		this->StopProfiling();
+	}
+
+	this->m_currentFrame = (this->m_currentFrame + 1) % GPUTimer::QUERY_FRAMES;
+
+	for (unsigned int section = 0; section < GPUTimer::NUMBER_SECTIONS; section++) {
+		if (!this->m_pendingQueries[this->m_currentFrame][section]) {
+			continue;
+		}
+
+		// A result that still isn't there is dropped and the previous time is kept
+		GLuint query = this->m_queries[this->m_currentFrame][section];
+		GLint available = GL_FALSE;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available == GL_TRUE) {
+			GLuint64 elapsedNanoseconds = 0;
+			glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNanoseconds);
+			this->m_sectionTimes[section] = elapsedNanoseconds / 1000000.0f;
+		}
+		this->m_pendingQueries[this->m_currentFrame][section] = false;
+	}
+}
+
+void GPUTimer::StartProfiling(const Section& section)
+{
+	if (this->m_activeSection != GPUTimer::NUMBER_SECTIONS) {
+		std::cout << "ERROR: GPU profiling sections can't be nested" << std::endl;
+		return;
+	}
+
+	glBeginQuery(GL_TIME_ELAPSED, this->m_queries[this->m_currentFrame][section]);
+	this->m_activeSection = section;
+}
+
+void GPUTimer::StopProfiling()
+{
+	if (this->m_activeSection == GPUTimer::NUMBER_SECTIONS) {
+		return;
+	}
+
+	glEndQuery(GL_TIME_ELAPSED);
+	this->m_pendingQueries[this->m_currentFrame][this->m_activeSection] = true;
+	this->m_activeSection = GPUTimer::NUMBER_SECTIONS;
+}
\ No newline at end of file
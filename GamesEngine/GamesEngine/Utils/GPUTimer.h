@@ -0,0 +1,77 @@
+#pragma once
+#include <glad/glad.h>
+#include <string>
+
+/**
+ * GPU side counterpart of the Timer profiling, every section of the frame is wrapped in a
+ * GL_TIME_ELAPSED query and the queries of a frame are only read back QUERY_FRAMES frames
+ * later, once the GPU is done with them, so reading the results never stalls the pipeline
+ * Sections can't be nested as only one elapsed time query can be active at a time
+ */
+class GPUTimer
+{
+public:
+	// Frames of queries in flight, the results read are QUERY_FRAMES - 1 frames old
+	static const unsigned int QUERY_FRAMES = 4;
+
+	// Passes measured on the GPU, in the order of SectionNames
+	enum Section {
+		SCENE_SECTION,
+		SKYBOX_SECTION,
+		GUI_SECTION,
+
+		NUMBER_SECTIONS
+	};
+
+	// Names used to push the results in the profiler
+	static const std::string SectionNames[NUMBER_SECTIONS];
+
+private:
+	GLuint m_queries[QUERY_FRAMES][NUMBER_SECTIONS];
+
+	// true if the query was issued in that frame and its result wasn't read yet
+	bool m_pendingQueries[QUERY_FRAMES][NUMBER_SECTIONS];
+
+	// Slot of the frame that is being recorded
+	unsigned int m_currentFrame = 0;
+
+	// Section that has a query running, NUMBER_SECTIONS if there is none
+	unsigned int m_activeSection = NUMBER_SECTIONS;
+
+	// Last time read back for each section in "ms"
+	float m_sectionTimes[NUMBER_SECTIONS];
+
+public:
+	GPUTimer();
+	~GPUTimer();
+
+	/**
+	 * Move to the next slot of queries, the results left in it from QUERY_FRAMES frames ago
+	 * are read first if the GPU made them available
+	 */
+	void BeginFrame();
+
+	/**
+	 * Start the query of a section of the frame
+	 * @param section							Section that is measured
+	 */
+	void StartProfiling(const Section& section);
+
+	/**
+	 * Stop the query of the section that is running
+	 */
+	void StopProfiling();
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline const float& GetProfilingData(const Section& section) const { return this->m_sectionTimes[section]; }
+	inline float GetTotalProfilingData() const {
+		float total = 0.0f;
+		for (unsigned int i = 0; i < NUMBER_SECTIONS; i++) {
+			total += this->m_sectionTimes[i];
+		}
+		return total;
+	}
+};
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "GUIEngine.h"
 #include "WindowDisplay.h"
 #include "../SceneLoader/Scene.h"
+#include "../Shaders/ShaderLibrary.h"
 #include <ImGUI/examples/imgui_impl_opengl3.cpp>
 #include <ImGUI/examples/imgui_impl_glfw.cpp>
 #include <iostream>
@@ -120,6 +121,22 @@ void GUIEngine::GUI_ProfilerWindow() {
 		ImGui::Checkbox("Pause profiling", &this->PF.PauseProfiling);
 		ImGui::NewLine();
 
+		// Compare the frame time and the draw calls with and without them
+		ImGui::Checkbox("Depth pre-pass", &RenderQueue::s_depthPrePass);
+		ImGui::Checkbox("Front to back opaque order", &RenderQueue::s_frontToBack);
+		ImGui::Checkbox("Mesh levels of detail", &RenderQueue::s_meshLod);
+		ImGui::NewLine();
+
+		ImGui::Text("Loaded models: %u, loaded textures: %u, loaded sounds: %u",
+			AssetManager::s_assetManager->GetLoadedModelCount(),
+			AssetManager::s_assetManager->GetLoadedTextureCount(),
+			AssetManager::s_assetManager->GetLoadedSoundCount());
+		ImGui::Button("Unload unused assets");
+		if (ImGui::IsItemClicked()) {
+			AssetManager::s_assetManager->UnloadUnusedAssets();
+		}
+		ImGui::NewLine();
+
 		for (WM_SubsystemProfiling system : this->PF.SubSystems) {
 			std::string buildLabel = system.SubsystemName
 				+ "\n(min: 0 - max: " + std::to_string(system.maxSize) + ")";
@@ -317,16 +334,19 @@ void GUIEngine::GUI_LevelBuilder_AddObject() {
 
 	Transform* newTransform = new Transform();
 
-	Shader* newShader = new Shader(ShaderType::EMPTY);
+	std::shared_ptr<Shader> newShader = ShaderLibrary::s_shaderLibrary->GetShader(ShaderType::EMPTY);
 	Material* newMaterial = new Material(newShader);
 
-	std::vector<Mesh*> newMesh = { new Mesh(newMaterial, newVert, newInd, GL_STATIC_DRAW) };
+	std::vector<Mesh*> newMesh = { new Mesh(newMaterial, newVert, newInd, GL_STATIC_DRAW, VertexLayout::LAYOUT_NO_TANGENT) };
 
 	// After the initialisation of all the properties, pushes a new default object to the data
 	this->LB.LevelData[this->LB.CurrentLevelEdited]->AddObjectToScene(new GameObject(newTransform, newMesh));
 }
 
 void GUIEngine::GUI_LevelBuilder_SaveObject() {
+	// The edited object may be merged in the static batch so it's built again on the next draw
+	this->LB.LevelData[this->LB.CurrentLevelEdited]->InvalidateStaticBatch();
+
 	// Set the active state of the object
 	this->LB.LevelData[this->LB.CurrentLevelEdited]->GetParsedObject(this->LB.CurrentEditedObject)->SetActiveState(this->LB.ObjectState);
 
@@ -380,7 +400,7 @@ void GUIEngine::GUI_LevelBuilder_SaveObject() {
 		std::vector<Mesh*> newMeshes;
 		for (unsigned int i = 0; i < this->LB.NumberOfMeshes; i++) {
 			// Initialise the new shader
-			Shader* newShader = new Shader(Shader::ConvertIntToType(this->LB.ShaderType[i]));
+			std::shared_ptr<Shader> newShader = ShaderLibrary::s_shaderLibrary->GetShader(Shader::ConvertIntToType(this->LB.ShaderType[i]));
 
 			// Set and unset the textures from the material
 			std::vector<Texture*> newTextures;
@@ -426,7 +446,8 @@ void GUIEngine::GUI_LevelBuilder_SaveObject() {
 					newMaterial,
 					newVertices,
 					newIndices,
-					this->LB.ObjectMovementState == 0 ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW
+					this->LB.ObjectMovementState == 0 ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW,
+					VertexLayout::LAYOUT_NO_TANGENT
 				)
 			);
 		}
@@ -448,6 +469,9 @@ void GUIEngine::GUI_LevelBuilder_DeleteObject() {
 		// and erases the object from the array
 		this->LB.LevelData[this->LB.CurrentLevelEdited]->RemoveObjectById(this->LB.CurrentEditedObject);
 
+		// Drop the programs that only the deleted object was still using
+		ShaderLibrary::s_shaderLibrary->ReleaseUnusedShaders();
+
 		// Reverts the object instance back to normal
 		this->LB.CurrentEditedObject = 0;
 		this->GUI_LevelBuilder_RevertObject();
@@ -494,9 +518,9 @@ void GUIEngine::GUI_LevelBuilder_ObjectModifier(GameObject* currentObject) {
 		if (currentObject->GetIsImported()) {
 
 			// Fetch the object colour of the selected object
-			this->LB.ObjectColour.x = currentObject->GetMeshById(0)->GetVertices()[0].colour.r;
-			this->LB.ObjectColour.y = currentObject->GetMeshById(0)->GetVertices()[0].colour.g;
-			this->LB.ObjectColour.z = currentObject->GetMeshById(0)->GetVertices()[0].colour.b;
+			this->LB.ObjectColour.x = currentObject->GetMeshById(0)->GetColour().r;
+			this->LB.ObjectColour.y = currentObject->GetMeshById(0)->GetColour().g;
+			this->LB.ObjectColour.z = currentObject->GetMeshById(0)->GetColour().b;
 		}
 		else {
 			// Clear the previous that about the textures, material, vertices, triangles and shader
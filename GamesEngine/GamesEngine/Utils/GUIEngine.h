@@ -209,6 +209,9 @@ public:
 	inline const bool& GetIsBuilderActive() const { return this->WM_LevelBuilderActive; }
 	inline const bool& GetIsProfilerActive() const { return this->WM_ProfilerActive; }
 	inline Scene* GetLevelDataById(const int& levelSelected) const { return this->LB.LevelData[levelSelected]; }
+	inline Scene* GetPreviewScene() const { 
+		return this->LB.CurrentLevelEdited < this->LB.LevelData.size() ? this->LB.LevelData[this->LB.CurrentLevelEdited] : nullptr; 
+	}
 	inline const WM_Profiler& GetProfilerManager() const { return this->PF; }
 	inline const std::vector<float>& GetProfilerDataSetByName(const std::string& systemName) {
 		for (WM_SubsystemProfiling system : this->PF.SubSystems) {
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/**
+ * 64bit FNV-1a hash shared by every cache key of the engine ( shader binaries, material
+ * state, mesh caches ), a hash can be continued over several blocks by passing it back in
+ */
+class Hash {
+public:
+	static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+	static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+	/**
+	 * Hash a block of bytes
+	 * @param data								First byte of the block
+	 * @param size								Size of the block in bytes
+	 * @param hash								Hash of the previous blocks
+	 * @return uint64_t							Hash including the block
+	 */
+	static uint64_t Fnv1a(const void* data, const size_t& size, uint64_t hash = Hash::FNV_OFFSET_BASIS) {
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= Hash::FNV_PRIME;
+		}
+		return hash;
+	}
+
+	/**
+	 * Hash the characters of a string
+	 * @param text								String that is hashed
+	 * @param hash								Hash of the previous blocks
+	 * @return uint64_t							Hash including the string
+	 */
+	static uint64_t Fnv1a(const std::string& text, uint64_t hash = Hash::FNV_OFFSET_BASIS) {
+		return Hash::Fnv1a(text.data(), text.size(), hash);
+	}
+};
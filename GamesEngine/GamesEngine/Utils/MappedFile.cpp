@@ -0,0 +1,97 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	this->Close();
+}
+
+bool MappedFile::Open(const std::string& filePath) {
+	this->Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	this->m_fileHandle = file;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		this->Close();
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL) {
+		this->Close();
+		return false;
+	}
+	this->m_mappingHandle = mapping;
+
+	this->m_data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (this->m_data == nullptr) {
+		this->Close();
+		return false;
+	}
+	this->m_size = (size_t)fileSize.QuadPart;
+#else
+	this->m_fileDescriptor = open(filePath.c_str(), O_RDONLY);
+	if (this->m_fileDescriptor < 0) {
+		return false;
+	}
+
+	struct stat fileInfo;
+	if (fstat(this->m_fileDescriptor, &fileInfo) != 0 || fileInfo.st_size == 0) {
+		this->Close();
+		return false;
+	}
+
+	void* data = mmap(nullptr, (size_t)fileInfo.st_size, PROT_READ, MAP_PRIVATE, this->m_fileDescriptor, 0);
+	if (data == MAP_FAILED) {
+		this->Close();
+		return false;
+	}
+	this->m_data = (const unsigned char*)data;
+	this->m_size = (size_t)fileInfo.st_size;
+#endif
+
+	return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+	if (this->m_data != nullptr) {
+		UnmapViewOfFile(this->m_data);
+	}
+	if (this->m_mappingHandle != nullptr) {
+		CloseHandle((HANDLE)this->m_mappingHandle);
+	}
+	if (this->m_fileHandle != nullptr) {
+		CloseHandle((HANDLE)this->m_fileHandle);
+	}
+	this->m_mappingHandle = nullptr;
+	this->m_fileHandle = nullptr;
+#else
+	if (this->m_data != nullptr) {
+		munmap((void*)this->m_data, this->m_size);
+	}
+	if (this->m_fileDescriptor >= 0) {
+		close(this->m_fileDescriptor);
+	}
+	this->m_fileDescriptor = -1;
+#endif
+
+	this->m_data = nullptr;
+	this->m_size = 0;
+}
\ No newline at end of file
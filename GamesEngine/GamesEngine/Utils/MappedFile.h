@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+/**
+ * Read only view of a whole file mapped into the address space, the pages are only read
+ * from disk when they're touched and nothing is copied into a buffer of the process
+ * The view stays valid until the file is closed or the object is destroyed
+ */
+class MappedFile {
+private:
+	const unsigned char* m_data = nullptr;
+	size_t m_size = 0;
+
+#ifdef _WIN32
+	void* m_fileHandle = nullptr;
+	void* m_mappingHandle = nullptr;
+#else
+	int m_fileDescriptor = -1;
+#endif
+
+public:
+	MappedFile() {}
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/**
+	 * Map a file, any file that was mapped before is closed first
+	 * @param filePath							Path of the file that is mapped
+	 * @return bool								false if the file doesn't exist, is empty or can't be mapped
+	 */
+	bool Open(const std::string& filePath);
+
+	/**
+	 * Unmap the file, the pointers returned by GetData are no longer valid
+	 */
+	void Close();
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline const unsigned char* GetData() const { return this->m_data; }
+	inline const size_t& GetSize() const { return this->m_size; }
+	inline bool IsOpen() const { return this->m_data != nullptr; }
+};
\ No newline at end of file
@@ -120,9 +120,12 @@ void NetworkEngine::UpdatePacketData() {
 	case NetworkType::CLIENTS:
 		if (this->m_sceneData->sceneSelected != -1) {
 			this->m_playerData->dataActive = 1;
-			this->m_playerData->transform = *this->m_graphicEngineEntity
+			const Transform* playerTransform = this->m_graphicEngineEntity
 				->GetGUIEngine()
 				->GetLevelDataById(this->m_sceneData->sceneSelected - 1)->GetScenePlayer()->GetTransform();
+			this->m_playerData->position = playerTransform->GetPos();
+			this->m_playerData->orientation = playerTransform->GetOrientation();
+			this->m_playerData->scale = playerTransform->GetScale();
 
 			this->m_playerData->networkSource = 2;
 			this->m_playerData->clientNumber = this->m_client->clientNumber;
@@ -254,9 +257,9 @@ void NetworkEngine::OnServerReceive() {
 		}
 
 		if (this->m_networkType != NetworkEngine::ConvertIntToType(this->m_playerData->networkSource)) {
-			this->m_remoteCharacter[this->m_playerData->clientNumber - 1]->GetTransform()->SetPos(this->m_playerData->transform.GetPos());
-			this->m_remoteCharacter[this->m_playerData->clientNumber - 1]->GetTransform()->SetRot(this->m_playerData->transform.GetRot());
-			this->m_remoteCharacter[this->m_playerData->clientNumber - 1]->GetTransform()->SetScale(this->m_playerData->transform.GetScale());
+			this->m_remoteCharacter[this->m_playerData->clientNumber - 1]->GetTransform()->SetPos(this->m_playerData->position);
+			this->m_remoteCharacter[this->m_playerData->clientNumber - 1]->GetTransform()->SetOrientation(this->m_playerData->orientation);
+			this->m_remoteCharacter[this->m_playerData->clientNumber - 1]->GetTransform()->SetScale(this->m_playerData->scale);
 		}
 	}
 	else if (tempPacketIndex == 1) {
@@ -290,9 +293,9 @@ void NetworkEngine::OnClientReceive() {
 			}
 
 			if (this->m_networkType != NetworkEngine::ConvertIntToType(this->m_playerData->networkSource)) {
-				this->m_remoteCharacter[this->m_playerData->clientNumber - 1]->GetTransform()->SetPos(this->m_playerData->transform.GetPos());
-				this->m_remoteCharacter[this->m_playerData->clientNumber - 1]->GetTransform()->SetRot(this->m_playerData->transform.GetRot());
-				this->m_remoteCharacter[this->m_playerData->clientNumber - 1]->GetTransform()->SetScale(this->m_playerData->transform.GetScale());
+				this->m_remoteCharacter[this->m_playerData->clientNumber - 1]->GetTransform()->SetPos(this->m_playerData->position);
+				this->m_remoteCharacter[this->m_playerData->clientNumber - 1]->GetTransform()->SetOrientation(this->m_playerData->orientation);
+				this->m_remoteCharacter[this->m_playerData->clientNumber - 1]->GetTransform()->SetScale(this->m_playerData->scale);
 			}
 		}
 	}
@@ -34,7 +34,11 @@ struct RemotePlayerData {
 	int dataActive = 0;
 	int networkSource = 0;
 	int clientNumber = 0;
-	Transform transform;
+
+	// Only the raw values are sent, the transform itself carries cached matrices
+	glm::vec3 position = glm::vec3(0.0f);
+	glm::quat orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+	glm::vec3 scale = glm::vec3(1.0f);
 };
 
 struct RemoteSceneData {
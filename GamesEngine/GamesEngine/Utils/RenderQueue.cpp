@@ -0,0 +1,308 @@
+#include "RenderQueue.h"
+#include "../Objects/GameObject.h"
+#include "../Shaders/FrameUniforms.h"
+#include "RingBuffer.h"
+#include "GLStateCache.h"
+#include "../Shaders/ShaderLibrary.h"
+#include <algorithm>
+
+RenderQueue* RenderQueue::s_immediateQueue = new RenderQueue();
+bool RenderQueue::s_depthPrePass = true;
+bool RenderQueue::s_frontToBack = true;
+bool RenderQueue::s_meshLod = true;
+
+uint64_t RenderQueue::BuildSortKey(const RenderPass& pass, const Mesh* mesh, const float& distance, const bool& frontToBack, const unsigned int& lod)
+{
+	const Material* material = mesh->GetMeshMaterial();
+	const Texture* diffuseTexture = material->GetUnitTexture(Shader::DIFFUSE_UNIT);
+
+	uint64_t passBits = static_cast<uint64_t>(pass) & 0xF;
+	uint64_t shaderBits = static_cast<uint64_t>(material->GetShader()->GetProgramID()) & 0x3FF;
+	uint64_t textureBits = static_cast<uint64_t>(diffuseTexture != nullptr ? diffuseTexture->GetTextureID() : 0) & 0xFFF;
+	uint64_t materialBits = material->GetStateHash() & 0xFFF;
+	// The level of detail takes the lowest bits so the levels of a geometry stay next to each other
+	uint64_t geometryBits = ((static_cast<uint64_t>(mesh->GetGeometryId()) << 2) | (lod & 0x3)) & 0xFFFF;
+
+	// Quantise the distance so the closest meshes are drawn first inside the same state
+	float normalisedDepth = glm::clamp(distance / RenderQueue::MAX_SORT_DEPTH, 0.0f, 1.0f);
+	uint64_t depthBits = static_cast<uint64_t>(normalisedDepth * 0x3FF) & 0x3FF;
+
+	// Only opaque meshes gain from being drawn front to back, the other passes keep the state order
+	if (frontToBack && pass == RenderPass::OPAQUE_PASS) {
+		return (passBits << 60) | (depthBits << 50) | (shaderBits << 40) | (textureBits << 28) | (materialBits << 16) | geometryBits;
+	}
+
+	return (passBits << 60) | (shaderBits << 50) | (textureBits << 38) | (materialBits << 26) | (geometryBits << 10) | depthBits;
+}
+
+float RenderQueue::GetScreenSize(const float& radius, const float& distance)
+{
+	// projection[1][1] = 1 / tan( fov / 2 ), a camera inside the sphere sees it fill the screen
+	if (distance <= radius) {
+		return 1.0f;
+	}
+	return radius * Camera::s_camera->GetProjection()[1][1] / distance;
+}
+
+bool RenderQueue::CanInstance(const RenderItem& first, const RenderItem& second)
+{
+	// Meshes without a shared source ( built in the level file ) are never instanced
+	if (first.mesh->GetGeometryId() == 0 || first.mesh->GetGeometryId() != second.mesh->GetGeometryId()) {
+		return false;
+	}
+
+	return first.lod == second.lod
+		&& first.mesh->GetDrawCount() == second.mesh->GetDrawCount()
+		&& first.mesh->GetMeshMaterial()->HasSameState(*second.mesh->GetMeshMaterial());
+}
+
+void RenderQueue::PushGameObject(GameObject* gameObject, const glm::vec3& cameraPos, const RenderPass& pass)
+{
+	if (!gameObject->GetIsActive()) {
+		return;
+	}
+
+	const Transform* transform = gameObject->GetTransform();
+	float distance = glm::length(transform->GetPos() - cameraPos);
+
+	// Every mesh of the object selects its level from the size of the whole object
+	float screenSize = 1.0f;
+	const BoundingBox& worldBounds = gameObject->GetWorldBounds();
+	if (RenderQueue::s_meshLod && worldBounds.IsValid()) {
+		glm::vec3 center = (worldBounds.min + worldBounds.max) * 0.5f;
+		screenSize = RenderQueue::GetScreenSize(glm::length(worldBounds.max - worldBounds.min) * 0.5f, glm::length(center - cameraPos));
+	}
+
+	for (Mesh* mesh : gameObject->GetMeshes()) {
+		if (mesh->GetDrawCount() == 0 || mesh->GetMeshMaterial() == nullptr || mesh->GetVertexArrayObject() == 0) {
+			continue;
+		}
+		unsigned int lod = mesh->SelectLod(screenSize);
+		this->m_renderItems.push_back({ RenderQueue::BuildSortKey(pass, mesh, distance, RenderQueue::s_frontToBack, lod), mesh, transform, lod });
+	}
+}
+
+void RenderQueue::PushMesh(Mesh* mesh, const Transform* transform, const glm::vec3& cameraPos, const RenderPass& pass)
+{
+	if (mesh->GetDrawCount() == 0 || mesh->GetMeshMaterial() == nullptr || mesh->GetVertexArrayObject() == 0) {
+		return;
+	}
+
+	// Meshes that are already in world space are sorted by the centre of their bounds
+	const BoundingBox& bounds = mesh->GetLocalBounds();
+	glm::vec3 center = bounds.IsValid() ? (bounds.min + bounds.max) * 0.5f : glm::vec3(0.0f);
+	float distance = glm::length(glm::vec3(transform->GetModelMatrix() * glm::vec4(center, 1.0f)) - cameraPos);
+
+	float screenSize = 1.0f;
+	if (RenderQueue::s_meshLod && bounds.IsValid()) {
+		BoundingBox worldBounds = bounds.Transformed(transform->GetModelMatrix());
+		screenSize = RenderQueue::GetScreenSize(glm::length(worldBounds.max - worldBounds.min) * 0.5f, distance);
+	}
+
+	unsigned int lod = mesh->SelectLod(screenSize);
+	this->m_renderItems.push_back({ RenderQueue::BuildSortKey(pass, mesh, distance, RenderQueue::s_frontToBack, lod), mesh, transform, lod });
+}
+
+void RenderQueue::Submit()
+{
+	this->m_drawCalls = 0;
+	this->m_shaderBinds = 0;
+	this->m_materialBinds = 0;
+	this->m_indirectCommands = 0;
+	this->m_depthPrePassDraws = 0;
+	this->m_drawnTriangles = 0;
+
+	if (this->m_renderItems.empty()) {
+		return;
+	}
+
+	std::sort(this->m_renderItems.begin(), this->m_renderItems.end(),
+		[](const RenderItem& a, const RenderItem& b) { return a.sortKey < b.sortKey; });
+
+	RingBuffer* ringBuffer = RingBuffer::s_frameRingBuffer;
+	unsigned int startGeneration = ringBuffer->GetGeneration();
+
+	GLintptr instanceOffset;
+	GLintptr commandsOffset;
+	unsigned int ringGeneration;
+	do {
+		// Everything is written again if the ring had to grow as the previous storage is gone
+		ringGeneration = ringBuffer->GetGeneration();
+
+		// Write the instance data in draw order straight into the ring
+		size_t instanceDataSize = this->m_renderItems.size() * sizeof(Mesh::InstanceData);
+		Mesh::InstanceData* instanceData = (Mesh::InstanceData*)ringBuffer->Map(instanceDataSize, sizeof(glm::vec4), instanceOffset);
+		for (size_t i = 0; i < this->m_renderItems.size(); i++) {
+			// Both matrices are cached on the transform and only rebuilt after it changes
+			const Transform* transform = this->m_renderItems[i].transform;
+			const glm::mat3& normalMatrix = transform->GetNormalMatrix();
+
+			instanceData[i].modelMatrix = transform->GetModelMatrix();
+			instanceData[i].colour = glm::vec4(this->m_renderItems[i].mesh->GetColour(), 1.0f);
+			instanceData[i].normalMatrix[0] = glm::vec4(normalMatrix[0], 0.0f);
+			instanceData[i].normalMatrix[1] = glm::vec4(normalMatrix[1], 0.0f);
+			instanceData[i].normalMatrix[2] = glm::vec4(normalMatrix[2], 0.0f);
+		}
+		ringBuffer->Unmap(instanceOffset, instanceDataSize);
+
+		// Build one command per instanced batch and group the commands that can be drawn together
+		this->m_commands.clear();
+		this->m_buckets.clear();
+
+		size_t first = 0;
+		while (first < this->m_renderItems.size()) {
+			const RenderItem& item = this->m_renderItems[first];
+
+			// Extend the batch for as long as the next draws share geometry and material
+			size_t last = first + 1;
+			while (last < this->m_renderItems.size() && RenderQueue::CanInstance(item, this->m_renderItems[last])) {
+				last++;
+			}
+
+			const GeometryBuffer::Allocation& allocation = item.mesh->GetGeometryAllocation();
+			RenderPass pass = static_cast<RenderPass>(item.sortKey >> 60);
+			Material* material = item.mesh->GetMeshMaterial();
+			GLuint vertexArrayObject = item.mesh->GetVertexArrayObject();
+
+			if (this->m_buckets.empty()
+				|| this->m_buckets.back().pass != pass
+				|| this->m_buckets.back().vertexArrayObject != vertexArrayObject
+				|| !material->HasSameState(*this->m_buckets.back().material)) {
+				// The material block is only written again when the parameters change
+				GLintptr materialOffset = !this->m_buckets.empty() && material->HasSameState(*this->m_buckets.back().material)
+					? this->m_buckets.back().materialOffset
+					: material->WriteMaterialData();
+				this->m_buckets.push_back({ pass, material, vertexArrayObject, this->m_commands.size(), 0, materialOffset });
+			}
+
+			// The levels of detail are stored after the indices of the mesh in the same allocation
+			Mesh::LodRange lodRange = item.mesh->GetLod(item.lod);
+			this->m_commands.push_back({ lodRange.indexCount, (GLuint)(last - first), allocation.firstIndex + lodRange.firstIndex, allocation.baseVertex, (GLuint)first });
+			this->m_buckets.back().commandCount++;
+
+			first = last;
+		}
+
+		commandsOffset = ringBuffer->Write(this->m_commands.data(), this->m_commands.size() * sizeof(DrawElementsIndirectCommand), sizeof(GLuint));
+
+		// The frame data bound by the scene was living in the previous storage
+		if (ringBuffer->GetGeneration() != startGeneration) {
+			FrameUniforms::s_frameUniforms->BindFrameData();
+		}
+	} while (ringBuffer->GetGeneration() != ringGeneration);
+
+	this->m_indirectCommands = this->m_commands.size();
+	for (const DrawElementsIndirectCommand& command : this->m_commands) {
+		this->m_drawnTriangles += command.count / 3 * command.instanceCount;
+	}
+
+	Shader* boundShader = nullptr;
+	Material* boundMaterial = nullptr;
+	GLuint boundVertexArray = 0;
+
+	GLStateCache::s_stateCache->BindBuffer(GL_DRAW_INDIRECT_BUFFER, ringBuffer->GetBuffer());
+
+	if (RenderQueue::s_depthPrePass) {
+		this->DrawDepthPrePass(instanceOffset, commandsOffset);
+	}
+
+	for (const DrawBucket& bucket : this->m_buckets) {
+		Material* material = bucket.material;
+		Shader* shader = material->GetShader();
+
+		// The opaque depth is already final after the pre-pass, only the matching fragments are shaded
+		bool equalDepth = this->m_depthPrePassDraws > 0 && bucket.pass == RenderPass::OPAQUE_PASS;
+		GLStateCache::s_stateCache->DepthFunc(equalDepth ? GL_EQUAL : GL_LESS);
+		GLStateCache::s_stateCache->DepthMask(equalDepth ? GL_FALSE : GL_TRUE);
+
+		if (shader != boundShader) {
+			shader->BindShader();
+			boundShader = shader;
+			boundMaterial = nullptr;
+			this->m_shaderBinds++;
+		}
+
+		if (boundMaterial == nullptr || !material->HasSameState(*boundMaterial)) {
+			Material::BindMaterialData(bucket.materialOffset);
+
+			// The state cache drops the units that already hold the right texture
+			for (unsigned int i = 0; i < Shader::NUMBER_TEXTURE_UNITS; i++) {
+				Texture* texture = material->GetUnitTexture(i);
+				GLStateCache::s_stateCache->BindTextureUnit(i, GL_TEXTURE_2D, texture != nullptr ? texture->GetTextureID() : 0);
+			}
+
+			boundMaterial = material;
+			this->m_materialBinds++;
+		}
+
+		// Every mesh of a layout shares the VAO, the instance range binding is part of its state
+		if (bucket.vertexArrayObject != boundVertexArray) {
+			GLStateCache::s_stateCache->BindVertexArray(bucket.vertexArrayObject);
+			glBindVertexBuffer(Mesh::INSTANCE_BUFFER_BINDING, ringBuffer->GetBuffer(), instanceOffset, sizeof(Mesh::InstanceData));
+			boundVertexArray = bucket.vertexArrayObject;
+		}
+
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+			(const void*)(commandsOffset + bucket.firstCommand * sizeof(DrawElementsIndirectCommand)), bucket.commandCount, 0);
+		this->m_drawCalls++;
+	}
+
+	// Leave the state clean once for everything that is drawn after the queue
+	GLStateCache::s_stateCache->DepthFunc(GL_LESS);
+	GLStateCache::s_stateCache->DepthMask(GL_TRUE);
+	GLStateCache::s_stateCache->BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	GLStateCache::s_stateCache->BindVertexArray(0);
+	for (unsigned int i = 0; i < Shader::NUMBER_TEXTURE_UNITS; i++) {
+		GLStateCache::s_stateCache->BindTextureUnit(i, GL_TEXTURE_2D, 0);
+	}
+	if (boundShader != nullptr) {
+		boundShader->UnbindShader();
+	}
+}
+
+void RenderQueue::DrawDepthPrePass(const GLintptr& instanceOffset, const GLintptr& commandsOffset)
+{
+	if (this->m_depthOnlyShader == nullptr) {
+		this->m_depthOnlyShader = ShaderLibrary::s_shaderLibrary->GetShader(ShaderType::EMPTY, { "DEPTH_ONLY" });
+	}
+
+	bool shaderBound = false;
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	GLStateCache::s_stateCache->DepthFunc(GL_LESS);
+	GLStateCache::s_stateCache->DepthMask(GL_TRUE);
+
+	size_t first = 0;
+	while (first < this->m_buckets.size()) {
+		const DrawBucket& bucket = this->m_buckets[first];
+		if (bucket.pass != RenderPass::OPAQUE_PASS) {
+			first++;
+			continue;
+		}
+
+		// The commands of consecutive buckets follow each other, so the ones sharing the VAO are one range
+		size_t last = first + 1;
+		size_t commandCount = bucket.commandCount;
+		while (last < this->m_buckets.size()
+			&& this->m_buckets[last].pass == RenderPass::OPAQUE_PASS
+			&& this->m_buckets[last].vertexArrayObject == bucket.vertexArrayObject) {
+			commandCount += this->m_buckets[last].commandCount;
+			last++;
+		}
+
+		if (!shaderBound) {
+			this->m_depthOnlyShader->BindShader();
+			shaderBound = true;
+		}
+
+		GLStateCache::s_stateCache->BindVertexArray(bucket.vertexArrayObject);
+		glBindVertexBuffer(Mesh::INSTANCE_BUFFER_BINDING, RingBuffer::s_frameRingBuffer->GetBuffer(), instanceOffset, sizeof(Mesh::InstanceData));
+
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+			(const void*)(commandsOffset + bucket.firstCommand * sizeof(DrawElementsIndirectCommand)), commandCount, 0);
+		this->m_depthPrePassDraws++;
+
+		first = last;
+	}
+
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include "../Objects/Mesh.h"
+#include "../Mathematics/Transform.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Forward declarations
+class GameObject;
+
+enum RenderPass {
+	OPAQUE_PASS, SKYBOX_PASS
+};
+
+/**
+ * Single draw of a mesh collected during the frame, the sort key is built as
+ * ( Most significant bit first )
+ * @pass									4 bits  ( RenderPass )
+ * @shader									10 bits ( program id )
+ * @textures								12 bits ( texture on the diffuse unit )
+ * @material								12 bits ( material state hash )
+ * @geometry								16 bits ( shared geometry id and level of detail )
+ * @depth									10 bits ( front to back distance to the camera )
+ * Textures are placed before the material so meshes sharing textures stay together, and the
+ * geometry right after the material so identical meshes end up next to each other and
+ * can be drawn with a single instanced call
+ * With the front to back order enabled the depth moves right after the pass, so the closest
+ * meshes are drawn first and occlude the rest at the cost of more state changes
+ */
+struct RenderItem {
+	uint64_t sortKey;
+	Mesh* mesh;
+	const Transform* transform;
+	unsigned int lod;
+};
+
+/**
+ * Layout of a single command read by glMultiDrawElementsIndirect, the base instance
+ * points at the instance data of the first instance inside the instance buffer
+ */
+struct DrawElementsIndirectCommand {
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLuint baseVertex;
+	GLuint baseInstance;
+};
+
+class RenderQueue {
+private:
+	/**
+	 * Consecutive commands that share the geometry pool and the material state
+	 * and are issued with a single multi draw call
+	 */
+	struct DrawBucket {
+		RenderPass pass;
+		Material* material;
+		GLuint vertexArrayObject;
+		size_t firstCommand;
+		size_t commandCount;
+		GLintptr materialOffset;
+	};
+
+	// Draws collected during the current frame
+	std::vector<RenderItem> m_renderItems;
+
+	// Indirect commands of the sorted draws grouped in buckets
+	std::vector<DrawElementsIndirectCommand> m_commands;
+	std::vector<DrawBucket> m_buckets;
+
+	// Position only program used to lay down the depth of the opaque draws
+	std::shared_ptr<Shader> m_depthOnlyShader;
+
+	// Statistics of the last submit
+	unsigned int m_drawCalls = 0;
+	unsigned int m_shaderBinds = 0;
+	unsigned int m_materialBinds = 0;
+	unsigned int m_indirectCommands = 0;
+	unsigned int m_depthPrePassDraws = 0;
+	unsigned int m_drawnTriangles = 0;
+
+public:
+	/**
+	 * Queue used to draw single objects outside of a scene ( skybox, remote players )
+	 */
+	static RenderQueue* s_immediateQueue;
+
+	// Distance that maps to the furthest depth value of the sort key
+	static constexpr float MAX_SORT_DEPTH = 2000.0f;
+
+	/**
+	 * Render options toggled from the profiler window, shared by every queue
+	 * @s_depthPrePass							Draw the depth of the opaque meshes first and shade with GL_EQUAL
+	 * @s_frontToBack							Order the opaque draws by distance before the render state
+	 * @s_meshLod								Draw the simplified levels of detail of distant meshes
+	 */
+	static bool s_depthPrePass;
+	static bool s_frontToBack;
+	static bool s_meshLod;
+
+	RenderQueue() {}
+	~RenderQueue() {}
+
+	/**
+	 * Build the sort key of a specific mesh
+	 * @param pass								Pass the mesh is drawn in
+	 * @param mesh								Mesh that is drawn
+	 * @param distance							Distance from the camera to the mesh
+	 * @param frontToBack						true to order by distance before the render state
+	 * @param lod								Level of detail the mesh is drawn with
+	 * @return uint64_t							Key used to order the draws
+	 */
+	static uint64_t BuildSortKey(const RenderPass& pass, const Mesh* mesh, const float& distance, const bool& frontToBack = false, const unsigned int& lod = 0);
+
+	/**
+	 * Size of a sphere on screen for the current camera projection
+	 * @param radius							Radius of the sphere
+	 * @param distance							Distance from the camera to its centre
+	 * @return float							Projected radius as a fraction of half the screen height
+	 */
+	static float GetScreenSize(const float& radius, const float& distance);
+
+	/**
+	 * Check if two queued draws can be merged in the same instanced call
+	 * @param first								Draw that starts the instanced batch
+	 * @param second							Draw that is checked against it
+	 * @return bool								true if geometry, level of detail and material state are shared
+	 */
+	static bool CanInstance(const RenderItem& first, const RenderItem& second);
+
+	/**
+	 * Queue every mesh of a game object
+	 * @param gameObject						Object that needs to be drawn this frame
+	 * @param cameraPos							Position of the camera used for the depth of the key
+	 * @param pass								Pass the object is drawn in
+	 */
+	void PushGameObject(GameObject* gameObject, const glm::vec3& cameraPos, const RenderPass& pass = RenderPass::OPAQUE_PASS);
+
+	/**
+	 * Queue a single mesh drawn with a specific transform
+	 * @param mesh								Mesh that needs to be drawn this frame
+	 * @param transform							Transform used for the model matrix of the draw
+	 * @param cameraPos							Position of the camera used for the depth of the key
+	 * @param pass								Pass the mesh is drawn in
+	 */
+	void PushMesh(Mesh* mesh, const Transform* transform, const glm::vec3& cameraPos, const RenderPass& pass = RenderPass::OPAQUE_PASS);
+
+	/**
+	 * Sort the queued draws and issue them, consecutive draws that share geometry and material
+	 * are merged into one indirect command and every command of the same geometry pool and
+	 * material is issued with one multi draw call, the program and the material are only bound
+	 * when they differ from the previous bucket and everything is unbound once at the end
+	 * The instance data, the commands and the material blocks are written linearly in the
+	 * frame ring buffer before anything is bound
+	 * When the depth pre-pass is enabled the opaque buckets are drawn twice, first position only
+	 * to fill the depth buffer and then shaded with GL_EQUAL so every pixel is shaded once
+	 */
+	void Submit();
+
+private:
+	/**
+	 * Fill the depth buffer with the opaque buckets, the material is ignored so every bucket
+	 * of the same geometry pool is drawn with a single multi draw call
+	 * @param instanceOffset					Offset of the instance data inside the ring buffer
+	 * @param commandsOffset					Offset of the indirect commands inside the ring buffer
+	 */
+	void DrawDepthPrePass(const GLintptr& instanceOffset, const GLintptr& commandsOffset);
+
+public:
+
+	/**
+	 * Remove all the draws that were queued
+	 */
+	void Clear() {
+		this->m_renderItems.clear();
+	}
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline unsigned int GetQueuedItems() const { return this->m_renderItems.size(); }
+	inline const unsigned int& GetDrawCalls() const { return this->m_drawCalls; }
+	inline const unsigned int& GetShaderBinds() const { return this->m_shaderBinds; }
+	inline const unsigned int& GetMaterialBinds() const { return this->m_materialBinds; }
+	inline const unsigned int& GetIndirectCommands() const { return this->m_indirectCommands; }
+	inline const unsigned int& GetDepthPrePassDraws() const { return this->m_depthPrePassDraws; }
+	inline const unsigned int& GetDrawnTriangles() const { return this->m_drawnTriangles; }
+};
@@ -0,0 +1,183 @@
+#include "RingBuffer.h"
+#include "GLStateCache.h"
+#include <cstring>
+#include <iostream>
+
+RingBuffer* RingBuffer::s_frameRingBuffer = new RingBuffer(1 << 22);
+
+RingBuffer::~RingBuffer()
+{
+	if (this->m_buffer != 0) {
+		this->DeleteBuffer();
+	}
+}
+
+void RingBuffer::BeginFrame()
+{
+	// The buffer is created on first use as the singleton exists before the context
+	if (this->m_buffer == 0) {
+		this->CreateBuffer();
+	}
+
+	this->m_currentSection = (this->m_currentSection + 1) % RingBuffer::NUMBER_SECTIONS;
+	this->m_writeOffset = 0;
+	this->m_frameIndex++;
+	this->m_bytesWritten = 0;
+	this->m_fenceWaits = 0;
+
+	this->WaitForSection(this->m_currentSection);
+}
+
+void RingBuffer::EndFrame()
+{
+	if (this->m_buffer == 0) {
+		return;
+	}
+
+	if (this->m_fences[this->m_currentSection] != nullptr) {
+		glDeleteSync(this->m_fences[this->m_currentSection]);
+	}
+	this->m_fences[this->m_currentSection] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void* RingBuffer::Map(const size_t& size, const size_t& alignment, GLintptr& offset)
+{
+	if (this->m_buffer == 0) {
+		this->CreateBuffer();
+	}
+
+	size_t rangeAlignment = alignment > 0 ? alignment : 1;
+	size_t start = (this->m_writeOffset + rangeAlignment - 1) / rangeAlignment * rangeAlignment;
+
+	if (start + size > this->m_sectionSize) {
+		// The draws already issued keep reading the old storage, only the next ranges move
+		size_t newSectionSize = this->m_sectionSize * 2;
+		while (newSectionSize < size) {
+			newSectionSize *= 2;
+		}
+
+		std::cout << "WARNING: The frame ring buffer is full, growing the sections to " << newSectionSize << " bytes" << std::endl;
+
+		this->DeleteBuffer();
+		this->m_sectionSize = newSectionSize;
+		this->CreateBuffer();
+
+		this->m_currentSection = 0;
+		start = 0;
+	}
+
+	offset = this->m_currentSection * this->m_sectionSize + start;
+	this->m_writeOffset = start + size;
+	this->m_bytesWritten += size;
+
+	return this->m_data + offset;
+}
+
+void RingBuffer::Unmap(const GLintptr& offset, const size_t& size)
+{
+	// The persistent mapping is coherent so the writes are already visible
+	if (this->m_persistent || size == 0) {
+		return;
+	}
+
+	GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, this->m_buffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, this->m_data + offset);
+	GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+GLintptr RingBuffer::Write(const void* data, const size_t& size, const size_t& alignment)
+{
+	GLintptr offset;
+	void* destination = this->Map(size, alignment, offset);
+	std::memcpy(destination, data, size);
+	this->Unmap(offset, size);
+	return offset;
+}
+
+void RingBuffer::CreateBuffer()
+{
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &this->m_uniformAlignment);
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &this->m_storageAlignment);
+
+	size_t totalSize = this->m_sectionSize * RingBuffer::NUMBER_SECTIONS;
+
+	glGenBuffers(1, &this->m_buffer);
+	GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, this->m_buffer);
+
+	// Immutable storage needs GL 4.4 ( the context only asks for 4.3 )
+	this->m_persistent = GLAD_GL_VERSION_4_4 && glBufferStorage != nullptr;
+	if (this->m_persistent) {
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_COPY_WRITE_BUFFER, totalSize, nullptr, flags);
+		this->m_data = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, totalSize, flags);
+
+		if (this->m_data == nullptr) {
+			std::cout << "ERROR: The ring buffer could not be persistently mapped" << std::endl;
+
+			// Immutable storage can't be respecified so a new buffer is needed
+			GLStateCache::s_stateCache->OnBufferDeleted(this->m_buffer);
+			glDeleteBuffers(1, &this->m_buffer);
+			glGenBuffers(1, &this->m_buffer);
+			GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, this->m_buffer);
+			this->m_persistent = false;
+		}
+	}
+
+	if (!this->m_persistent) {
+		glBufferData(GL_COPY_WRITE_BUFFER, totalSize, nullptr, GL_DYNAMIC_DRAW);
+		this->m_stagingData.resize(totalSize);
+		this->m_data = this->m_stagingData.data();
+	}
+
+	GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	this->m_writeOffset = 0;
+	this->m_generation++;
+}
+
+void RingBuffer::DeleteBuffer()
+{
+	for (unsigned int i = 0; i < RingBuffer::NUMBER_SECTIONS; i++) {
+		if (this->m_fences[i] != nullptr) {
+			glDeleteSync(this->m_fences[i]);
+			this->m_fences[i] = nullptr;
+		}
+	}
+
+	if (this->m_persistent) {
+		GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, this->m_buffer);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		GLStateCache::s_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	GLStateCache::s_stateCache->OnBufferDeleted(this->m_buffer);
+	glDeleteBuffers(1, &this->m_buffer);
+	this->m_buffer = 0;
+	this->m_data = nullptr;
+	this->m_stagingData.clear();
+	this->m_stagingData.shrink_to_fit();
+}
+
+void RingBuffer::WaitForSection(const unsigned int& section)
+{
+	GLsync fence = this->m_fences[section];
+	if (fence == nullptr) {
+		return;
+	}
+
+	// Most of the time the GPU is already done with a section that was written two frames ago
+	GLenum result = glClientWaitSync(fence, 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED) {
+		this->m_fenceWaits++;
+		do {
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		} while (result == GL_TIMEOUT_EXPIRED);
+	}
+
+	if (result == GL_WAIT_FAILED) {
+		std::cout << "ERROR: Waiting for the ring buffer fence failed" << std::endl;
+	}
+
+	glDeleteSync(fence);
+	this->m_fences[section] = nullptr;
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Buffer the renderer streams its per frame data into ( instance data, indirect commands,
+ * uniform blocks ), split in NUMBER_SECTIONS sections so the CPU writes one section while
+ * the GPU is still reading the previous ones, a fence guards each section before reuse
+ * The storage is persistently mapped when the context supports glBufferStorage, otherwise
+ * the writes are staged on the CPU and uploaded with glBufferSubData
+ */
+class RingBuffer {
+public:
+	// Number of frames that can be in flight at the same time
+	static const unsigned int NUMBER_SECTIONS = 3;
+
+private:
+	GLuint m_buffer = 0;
+
+	// Pointer of the persistent mapping or of the CPU staging copy
+	unsigned char* m_data = nullptr;
+	std::vector<unsigned char> m_stagingData;
+	bool m_persistent = false;
+
+	// Size of a single section and write position inside the current section
+	size_t m_sectionSize;
+	size_t m_writeOffset = 0;
+	unsigned int m_currentSection = 0;
+
+	// Fence placed once the GPU commands using a section were issued
+	GLsync m_fences[NUMBER_SECTIONS] = { nullptr, nullptr, nullptr };
+
+	// Increased every time the buffer is recreated so cached bindings can be refreshed
+	unsigned int m_generation = 0;
+
+	// Increased every frame so data written in a previous frame can be told apart
+	unsigned int m_frameIndex = 0;
+
+	GLint m_uniformAlignment = 256;
+	GLint m_storageAlignment = 256;
+
+	// Statistics of the last frame
+	size_t m_bytesWritten = 0;
+	unsigned int m_fenceWaits = 0;
+
+public:
+	/**
+	 * Ring used by the renderer for all the data streamed during a frame
+	 */
+	static RingBuffer* s_frameRingBuffer;
+
+	RingBuffer(const size_t& sectionSize) : m_sectionSize(sectionSize) {}
+	~RingBuffer();
+
+	/**
+	 * Move to the next section and wait until the GPU is done reading it
+	 */
+	void BeginFrame();
+
+	/**
+	 * Fence the current section after all the draws reading it were issued
+	 */
+	void EndFrame();
+
+	/**
+	 * Reserve a range of the current section, the buffer is recreated with bigger sections if
+	 * the frame doesn't fit, so all the ranges of a draw have to be reserved before binding them
+	 * @param size								Size in bytes of the range
+	 * @param alignment							Alignment of the start of the range
+	 * @param offset							Offset of the range inside the buffer
+	 * @return void*							Memory the data has to be written to
+	 */
+	void* Map(const size_t& size, const size_t& alignment, GLintptr& offset);
+
+	/**
+	 * Make the data written in a range visible to the GPU
+	 * @param offset							Offset returned by Map
+	 * @param size								Size in bytes of the range
+	 */
+	void Unmap(const GLintptr& offset, const size_t& size);
+
+	/**
+	 * Copy data in a new range of the current section
+	 * @param data								Data that is copied
+	 * @param size								Size in bytes of the data
+	 * @param alignment							Alignment of the start of the range
+	 * @return GLintptr							Offset of the range inside the buffer
+	 */
+	GLintptr Write(const void* data, const size_t& size, const size_t& alignment);
+
+private:
+	/**
+	 * Create the storage for all the sections and map it
+	 */
+	void CreateBuffer();
+
+	/**
+	 * Unmap and delete the storage together with the fences
+	 */
+	void DeleteBuffer();
+
+	/**
+	 * Block until the fence of a section is signaled and release it
+	 * @param section							Section that is going to be written
+	 */
+	void WaitForSection(const unsigned int& section);
+
+	/**
+	 * Getters and setters
+	 */
+public:
+	inline const GLuint& GetBuffer() const { return this->m_buffer; }
+	inline const unsigned int& GetGeneration() const { return this->m_generation; }
+	inline const unsigned int& GetFrameIndex() const { return this->m_frameIndex; }
+	inline size_t GetUniformAlignment() const { return (size_t)this->m_uniformAlignment; }
+	inline size_t GetStorageAlignment() const { return (size_t)this->m_storageAlignment; }
+	inline const bool& GetIsPersistent() const { return this->m_persistent; }
+	inline const size_t& GetBytesWritten() const { return this->m_bytesWritten; }
+	inline const unsigned int& GetFenceWaits() const { return this->m_fenceWaits; }
+};
@@ -68,7 +68,7 @@ public:
 	const ChannelMap& GetEngineChannelMap() { return this->m_channelMap; }
 
 	template<typename T, typename U>
-	T* GetFromMap(const std::string& fileName, U specificMap) {
+	T* GetFromMap(const std::string& fileName, const U& specificMap) {
 		T* i = NULL;
 
 		auto it = specificMap.find(fileName);
@@ -81,4 +81,9 @@ public:
 		this->m_soundMap.insert({ fileName, soundSample });
 		this->m_channelMap.insert({ fileName, nullptr });
 	}
+
+	void RemoveSound(const std::string& fileName) {
+		this->m_soundMap.erase(fileName);
+		this->m_channelMap.erase(fileName);
+	}
 };
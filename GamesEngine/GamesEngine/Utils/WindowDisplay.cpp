@@ -10,7 +10,7 @@ WindowDisplay::WindowDisplay(int width, int height, const std::string& title)
 	// Initialize all the components from GLFW
 	glfwInit();
 	glfwWindowHint(GLFW_SAMPLES, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
@@ -56,6 +56,11 @@ WindowDisplay::WindowDisplay(int width, int height, const std::string& title)
 	// SubSystem Graphics
 	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ "GraphicSystem", 0.5f });
 
+	// Time the GPU spent on each pass, next to the submission time above
+	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ GPUTimer::SectionNames[GPUTimer::SCENE_SECTION], 16.0f });
+	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ GPUTimer::SectionNames[GPUTimer::SKYBOX_SECTION], 2.0f });
+	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ GPUTimer::SectionNames[GPUTimer::GUI_SECTION], 2.0f });
+
 	// SubSystem Physics
 	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ "PhysicsSystem", 0.1f });
 	
@@ -65,15 +70,38 @@ WindowDisplay::WindowDisplay(int width, int height, const std::string& title)
 	// SubSystem EventQueue
 	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ "EventQueue", 0.1f });
 
+	// Objects that passed the frustum culling
+	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ "VisibleObjects", 100.0f });
+	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ "VisibleStaticCells", 100.0f });
+
+	// Multi draw calls issued by the scene, one per geometry pool and material bucket
+	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ "DrawCalls", 100.0f });
+	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ "DepthPrePassDraws", 100.0f });
+	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ "DrawnTriangles", 1000000.0f });
+
+	// State changes dropped by the GL state cache
+	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ "RedundantGLCalls", 1000.0f });
+
+	// Matrices rebuilt by the transform pool
+	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ "TransformUpdates", 1000.0f });
+
+	// Point lights that reached the clusters of the view
+	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ "VisiblePointLights", 500.0f });
+
+	// Time spent finishing the asset loads and the loads still waiting for a worker or the budget
+	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ "AssetUploads", (float)AsyncLoader::UPLOAD_BUDGET * 2.0f });
+	this->m_guiEngine->PushSystemProfiler(WM_SubsystemProfiling{ "PendingLoads", 100.0f });
+
 
 	// Init the keyboard input
 	this->m_uiEngine = new UIEngine(this);
 
 	// Init the fps with the window
 	this->m_timer = new Timer();
+	this->m_gpuTimer = new GPUTimer();
 
 	// Init SkyBox
-	this->windowSkyBox = new SkyBox(500);
+	this->windowSkyBox = new SkyBox();
 
 	// Initialise the background sound
 	SoundEngine::s_soundEngine->InitBackgroundSample();
@@ -93,8 +121,27 @@ WindowDisplay::~WindowDisplay()
 	// Clean the SkyBox
 	delete this->windowSkyBox;
 
+	// Wait for the loads that are still running, the objects waiting for them are gone already
+	delete AsyncLoader::s_asyncLoader;
+
+	// Clean the GPU queries while the context is still alive
+	delete this->m_gpuTimer;
+
 	// Clean the loaded assets
 	delete AssetManager::s_assetManager;
+	AssetManager::s_assetManager = nullptr;
+
+	// Clean the shared shader programs while the context is still alive
+	delete ShaderLibrary::s_shaderLibrary;
+
+	// Clean the per frame uniform buffer
+	delete FrameUniforms::s_frameUniforms;
+
+	// Clean the queue used for the single object draws
+	delete RenderQueue::s_immediateQueue;
+
+	// Clean the ring buffer the per frame data is streamed into
+	delete RingBuffer::s_frameRingBuffer;
 
 	// Clean the Physics engine
 	delete PhysicsEngine::s_physicsEngine;
@@ -105,9 +152,19 @@ WindowDisplay::~WindowDisplay()
 	// Clean the network engine
 	delete NetworkEngine::s_networkEngine;
 
+	// Clean the shared geometry once every mesh is gone
+	delete GeometryBuffer::s_geometryBuffer;
+
+	// Clean the transform storage once every game object is gone
+	delete TransformPool::s_transformPool;
+
 	// Clean the UI engine
 	delete this->m_uiEngine;
 
+	// Clean the tracked GL state last, everything above reports the objects it deletes to it
+	delete GLStateCache::s_stateCache;
+	GLStateCache::s_stateCache = nullptr;
+
 	// Clean the context and destroy de window
 	glfwDestroyWindow(this->m_window);
 
@@ -120,6 +177,17 @@ void WindowDisplay::UpdateWindow()
 	// Update the frameRate
 	this->m_timer->CalculateFrameRate();
 
+	// Read the GPU times of the frame that used this slot of queries before
+	this->m_gpuTimer->BeginFrame();
+
+	// Start writing the data streamed this frame in the next section of the ring
+	RingBuffer::s_frameRingBuffer->BeginFrame();
+
+	// Upload the assets decoded by the workers, as much as fits in the budget of the frame
+	this->m_timer->StartProfiling();
+	AsyncLoader::s_asyncLoader->ProcessJobs();
+	this->m_timer->StopProfiling("AssetUploads");
+
 	// Resize the window and the viewport
 	this->ResizeWindow();
 
@@ -129,6 +197,9 @@ void WindowDisplay::UpdateWindow()
 	// Update event pool with events that come from the network adapter
 	NetworkEngine::s_networkEngine->UpdateEventPool(this->m_timer->GetDeltaTime());
 
+	// Stage the camera of this frame for every program that is going to be drawn
+	FrameUniforms::s_frameUniforms->SetCameraData(*Camera::s_camera);
+
 	// Run update for all game objects.
 	if (!this->m_guiEngine->GetIsBuilderActive()) {
 		// Update the physics and check for collisions only when the level
@@ -140,6 +211,7 @@ void WindowDisplay::UpdateWindow()
 
 		// If the level hasn't been selected yet don't draw any objects
 		this->m_timer->StartProfiling();
+		this->m_gpuTimer->StartProfiling(GPUTimer::SCENE_SECTION);
 		if (this->m_sceneManager != nullptr) {
 			this->m_sceneManager->DrawScene(false);
 		}
@@ -147,10 +219,13 @@ void WindowDisplay::UpdateWindow()
 
 		// Draw the data received by the remote host or client
 		NetworkEngine::s_networkEngine->DrawRemoteData();
+		this->m_gpuTimer->StopProfiling();
 	}
 	else {
 		this->m_timer->StartProfiling();
+		this->m_gpuTimer->StartProfiling(GPUTimer::SCENE_SECTION);
 		this->m_guiEngine->GUI_LevelBuilder_ScenePreview();
+		this->m_gpuTimer->StopProfiling();
 		this->m_timer->StopProfiling("GraphicSystem");
 	}
 
@@ -160,10 +235,14 @@ void WindowDisplay::UpdateWindow()
 	this->m_timer->StopProfiling("SoundSystem");
 
 	// Render the SkyBox
+	this->m_gpuTimer->StartProfiling(GPUTimer::SKYBOX_SECTION);
 	this->windowSkyBox->DrawSkyBox();
+	this->m_gpuTimer->StopProfiling();
 
 	// Render all elements from GUIEngine
+	this->m_gpuTimer->StartProfiling(GPUTimer::GUI_SECTION);
 	this->m_guiEngine->DrawGUI(this->m_displayGUI);
+	this->m_gpuTimer->StopProfiling();
 
 	// Call the event handlers each frame for each subsystem
 	this->m_timer->StartProfiling();
@@ -199,6 +278,9 @@ void WindowDisplay::UpdateWindow()
 
 		// SubSystem Graphics
 		this->m_guiEngine->PushProfilerDataSetByName("GraphicSystem", this->m_timer->GetProfilingDataByName("GraphicSystem"));
+		for (unsigned int i = 0; i < GPUTimer::NUMBER_SECTIONS; i++) {
+			this->m_guiEngine->PushProfilerDataSetByName(GPUTimer::SectionNames[i], this->m_gpuTimer->GetProfilingData((GPUTimer::Section)i));
+		}
 
 		// SubSystem Physics
 		this->m_guiEngine->PushProfilerDataSetByName("PhysicsSystem", this->m_timer->GetProfilingDataByName("PhysicsSystem"));
@@ -209,8 +291,25 @@ void WindowDisplay::UpdateWindow()
 		// SubSystem EventQueue
 		this->m_guiEngine->PushProfilerDataSetByName("EventQueue", this->m_timer->GetProfilingDataByName("EventQueue"));
 
+		// Objects drawn by the scene that is currently displayed
+		Scene* drawnScene = this->m_guiEngine->GetIsBuilderActive() ? this->m_guiEngine->GetPreviewScene() : this->m_sceneManager;
+		this->m_guiEngine->PushProfilerDataSetByName("VisibleObjects", drawnScene != nullptr ? drawnScene->GetVisibleObjects() : 0.0f);
+		this->m_guiEngine->PushProfilerDataSetByName("VisibleStaticCells", drawnScene != nullptr ? drawnScene->GetVisibleStaticCells() : 0.0f);
+		this->m_guiEngine->PushProfilerDataSetByName("DrawCalls", drawnScene != nullptr ? drawnScene->GetRenderQueue().GetDrawCalls() : 0.0f);
+		this->m_guiEngine->PushProfilerDataSetByName("DepthPrePassDraws", drawnScene != nullptr ? drawnScene->GetRenderQueue().GetDepthPrePassDraws() : 0.0f);
+		this->m_guiEngine->PushProfilerDataSetByName("DrawnTriangles", drawnScene != nullptr ? drawnScene->GetRenderQueue().GetDrawnTriangles() : 0.0f);
+		this->m_guiEngine->PushProfilerDataSetByName("RedundantGLCalls", GLStateCache::s_stateCache->GetEliminatedCalls());
+		this->m_guiEngine->PushProfilerDataSetByName("TransformUpdates", TransformPool::s_transformPool->GetUpdatedMatrices());
+		this->m_guiEngine->PushProfilerDataSetByName("VisiblePointLights", FrameUniforms::s_frameUniforms->GetLightClusters().GetLights().size());
+		this->m_guiEngine->PushProfilerDataSetByName("AssetUploads", this->m_timer->GetProfilingDataByName("AssetUploads"));
+		this->m_guiEngine->PushProfilerDataSetByName("PendingLoads", AsyncLoader::s_asyncLoader->GetPendingJobs());
+
 	}
 
+	// The section of this frame can be reused once the GPU went through all the draws above
+	RingBuffer::s_frameRingBuffer->EndFrame();
+	GLStateCache::s_stateCache->ResetFrameStats();
+
 	// Tells to the operating system to swap the windows on those 2 buffers and so there are no moments when nothing is drawn on the screen
 	glfwSwapBuffers(this->m_window);
 }
@@ -259,7 +358,7 @@ void WindowDisplay::ClearWindow() {
 	glClearColor(0.0, 0.0, 0.0, 1.0);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	glEnable(GL_DEPTH_TEST);
+	GLStateCache::s_stateCache->SetCapability(GL_DEPTH_TEST, true);
 }
 
 void WindowDisplay::CloseWindow() {
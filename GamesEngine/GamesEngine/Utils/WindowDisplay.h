@@ -7,10 +7,16 @@
 #include <vector>
 #include "Camera.h"
 #include "Timer.h"
+#include "GPUTimer.h"
 #include "UIEngine.h"
 #include "PhysicsEngine.h"
 #include "NetworkEngine.h"
 #include "../Objects/SkyBox.h"
+#include "../Shaders/ShaderLibrary.h"
+#include "../Shaders/FrameUniforms.h"
+#include "RingBuffer.h"
+#include "GLStateCache.h"
+#include "AsyncLoader.h"
 
 class WindowDisplay
 {
@@ -18,6 +24,7 @@ private:
 	GLFWwindow* m_window;
 	Scene* m_sceneManager;
 	Timer* m_timer;
+	GPUTimer* m_gpuTimer;
 
 	SkyBox* windowSkyBox;
 